@@ -0,0 +1,153 @@
+#include "utils/mesh_indexing.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+using namespace llengine;
+
+namespace {
+struct BenchmarkMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec4> tangents;
+};
+
+/**
+ * @brief Unindexed mesh where every unique vertex repeats 6 times on average,
+ * like in a regular triangle grid.
+ */
+[[nodiscard]] BenchmarkMesh make_mesh(std::size_t vertices_count) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    const std::size_t unique_count = std::max<std::size_t>(vertices_count / 6, 1);
+    BenchmarkMesh unique;
+    for (std::size_t i = 0; i < unique_count; i++) {
+        unique.positions.emplace_back(distribution(random), distribution(random), distribution(random));
+        unique.uvs.emplace_back(distribution(random), distribution(random));
+        unique.normals.emplace_back(distribution(random), distribution(random), distribution(random));
+        unique.tangents.emplace_back(distribution(random), distribution(random), distribution(random), 1.0f);
+    }
+
+    BenchmarkMesh result;
+    std::uniform_int_distribution<std::size_t> index_distribution(0, unique_count - 1);
+    for (std::size_t i = 0; i < vertices_count; i++) {
+        const std::size_t index = index_distribution(random);
+        result.positions.push_back(unique.positions[index]);
+        result.uvs.push_back(unique.uvs[index]);
+        result.normals.push_back(unique.normals[index]);
+        result.tangents.push_back(unique.tangents[index]);
+    }
+    return result;
+}
+
+// The implementation Mesh::index_data used before mesh_indexing, kept as the baseline.
+struct CompleteVertex {
+    glm::vec3 vertex;
+    glm::vec2 uv;
+    glm::vec3 normal;
+
+    bool operator==(const CompleteVertex& other) const noexcept {
+        return vertex == other.vertex && uv == other.uv && normal == other.normal;
+    }
+};
+
+struct CompleteVertexHasher {
+    std::size_t operator()(const CompleteVertex& cv) const {
+        size_t res = 17;
+        std::hash<float> hash;
+
+        res = res * 31 + hash(cv.vertex.x);
+        res = res * 31 + hash(cv.vertex.y);
+        res = res * 31 + hash(cv.vertex.z);
+        res = res * 31 + hash(cv.uv.x);
+        res = res * 31 + hash(cv.uv.y);
+        res = res * 31 + hash(cv.normal.x);
+        res = res * 31 + hash(cv.normal.y);
+        res = res * 31 + hash(cv.normal.z);
+
+        return res;
+    }
+};
+
+void index_with_unordered_map(BenchmarkMesh& mesh, std::vector<std::uint32_t>& indices) {
+    auto in_vertices = mesh.positions;
+    auto in_uvs = mesh.uvs;
+    auto in_normals = mesh.normals;
+
+    indices.clear();
+    mesh.positions.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+
+    std::unordered_map<CompleteVertex, std::uint32_t, CompleteVertexHasher> vertex_to_index;
+
+    for (std::size_t i = 0; i < in_vertices.size(); i++) {
+        CompleteVertex complete {in_vertices[i], in_uvs[i], in_normals[i]};
+
+        auto find_result = vertex_to_index.find(complete);
+        if (find_result != vertex_to_index.end()) {
+            indices.push_back(find_result->second);
+        }
+        else {
+            mesh.positions.push_back(complete.vertex);
+            mesh.uvs.push_back(complete.uv);
+            mesh.normals.push_back(complete.normal);
+
+            std::uint32_t new_index = static_cast<std::uint32_t>(mesh.positions.size()) - 1;
+            vertex_to_index.insert(std::make_pair(complete, new_index));
+            indices.push_back(new_index);
+        }
+    }
+}
+
+[[nodiscard]] mesh_indexing::VertexStreams get_streams(const BenchmarkMesh& mesh, bool with_tangents) {
+    return {
+        mesh.positions, mesh.uvs, mesh.normals,
+        with_tangents ? std::span<const glm::vec4>(mesh.tangents) : std::span<const glm::vec4>()
+    };
+}
+}
+
+static void unordered_map(benchmark::State& state) {
+    const BenchmarkMesh source = make_mesh(state.range(0));
+    std::vector<std::uint32_t> indices;
+    for (auto _ : state) {
+        state.PauseTiming();
+        BenchmarkMesh mesh = source;
+        state.ResumeTiming();
+
+        index_with_unordered_map(mesh, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hash_table(benchmark::State& state) {
+    const BenchmarkMesh mesh = make_mesh(state.range(0));
+    for (auto _ : state) {
+        auto result = mesh_indexing::index_with_hash_table(get_streams(mesh, state.range(1) != 0), true);
+        benchmark::DoNotOptimize(result.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void parallel_sort(benchmark::State& state) {
+    const BenchmarkMesh mesh = make_mesh(state.range(0));
+    for (auto _ : state) {
+        auto result = mesh_indexing::index_with_parallel_sort(get_streams(mesh, state.range(1) != 0), true);
+        benchmark::DoNotOptimize(result.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(unordered_map)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMillisecond);
+// The second argument is whether tangents are compared.
+BENCHMARK(hash_table)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 16), {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(parallel_sort)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 16), {0, 1}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -24,6 +24,7 @@ int main() {
     settings.window_title = "LLEngine demo";
     settings.json_scene_path = "res/maps/demo_map.json";
     settings.skybox_path = "res/textures/sky.hdr";
+    settings.ibl_cache_path = "cache/ibl";
     settings.window_resolution = {1600, 1000};
     settings.quality_settings.shadow_mapping_enabled = true;
     settings.quality_settings.shadow_map_size = {2048, 2048};
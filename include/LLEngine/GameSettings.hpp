@@ -11,7 +11,13 @@ struct GameSettings {
     std::string window_title;
     std::string json_scene_path;
     std::string skybox_path;
+    // Directory for lighting maps precomputed from the skybox. Empty string disables the cache.
+    std::string ibl_cache_path;
     glm::ivec2 window_resolution;
+    // Version of the requested OpenGL core context, 3.3 at least. Newer contexts
+    // enable multi-draw indirect and persistently mapped buffers without extensions.
+    int gl_version_major = 3;
+    int gl_version_minor = 3;
     QualitySettings quality_settings;
 };
 }
\ No newline at end of file
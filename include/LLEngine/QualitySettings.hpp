@@ -3,12 +3,40 @@
 #include <glm/vec2.hpp>
 
 namespace llengine {
+// Point lights shaded for a fragment.
+enum class LightAssignment {
+    // All of them.
+    ALL,
+    // The ones that may reach the fragment's cluster of the view frustum.
+    CLUSTERED,
+    // At most 8 most relevant ones for every object. The cheapest option, but objects
+    // lit by more lights lose some of them.
+    PER_OBJECT
+};
+
 struct QualitySettings {
     bool shadow_mapping_enabled = true;
     glm::u32vec2 shadow_map_size = {1024, 1024};
     float shadow_map_drawing_distance = 20.0f;
 
     bool enable_bloom = true;
+    // Use spherical harmonics computed on the CPU instead of the irradiance cubemap.
+    bool sh_irradiance_enabled = false;
+    // Release RAM copies of loaded glTF meshes after uploading them, except vertex positions.
+    bool release_mesh_data_after_upload = false;
+    // Skip meshlets of big meshes that are outside the frustum or face away from the camera.
+    bool meshlet_culling_enabled = true;
+    // Draw objects sharing a mesh and a material with one instanced draw call.
+    bool instancing_enabled = true;
+    // Draw objects sharing a material and a vertex buffer with one indirect draw call.
+    // Requires OpenGL 4.3 or its extensions, see RenderingServer.
+    bool multi_draw_indirect_enabled = true;
+    LightAssignment light_assignment = LightAssignment::CLUSTERED;
+    // Draw depth of opaque objects front to back before shading them, so that
+    // hidden fragments are not shaded. Pays off if the overdraw statistic is high.
+    bool depth_prepass_enabled = false;
+    // Cull drawables and prepare their drawing on several threads in scenes with many of them.
+    bool parallel_draw_recording = true;
 
     float anisotropy = 1.0f;
 };
@@ -9,7 +9,9 @@ using GraphicsAPIEnum = std::uint32_t;
 using BufferID = std::uint32_t;
 using VertexArrayID = std::uint32_t;
 using TextureID = std::uint32_t;
+using SamplerID = std::uint32_t;
 using FramebufferID = std::uint32_t;
 using RenderbufferID = std::uint32_t;
+using QueryID = std::uint32_t;
 using GraphicsAPISize = std::int32_t;
 }
\ No newline at end of file
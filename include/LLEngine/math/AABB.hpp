@@ -1,8 +1,12 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
 
 #include <cstdint>
+#include <cassert>
 
 namespace llengine {
 struct AABB {
@@ -18,5 +22,19 @@ struct AABB {
             vertex_index & 0x04 ? point_max.z : point_min.z
         };
     }
+
+    /**
+     * @brief Returns the AABB around the transformed box.
+     */
+    [[nodiscard]] AABB transformed(const glm::mat4& matrix) const {
+        const glm::vec3 first_vertex {matrix * glm::vec4(get_vertex(0), 1.0f)};
+        AABB result {first_vertex, first_vertex};
+        for (std::uint8_t i = 1; i < 8; i++) {
+            const glm::vec3 vertex {matrix * glm::vec4(get_vertex(i), 1.0f)};
+            result.point_max = glm::max(result.point_max, vertex);
+            result.point_min = glm::min(result.point_min, vertex);
+        }
+        return result;
+    }
 };
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "AABB.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <span>
+
+namespace llengine {
+struct BoundingSphere {
+    glm::vec3 center {0.0f, 0.0f, 0.0f};
+    float radius = 0.0f;
+
+    /**
+     * @brief Ritter's approximation or the sphere around the AABB center,
+     * whichever is smaller.
+     */
+    [[nodiscard]] static BoundingSphere from_points(std::span<const glm::vec3> points, const AABB& aabb);
+
+    /**
+     * @brief Transforms the sphere, scaling it by the largest scale of the matrix.
+     */
+    [[nodiscard]] BoundingSphere transformed(const glm::mat4& matrix) const;
+};
+
+/**
+ * @brief Oriented bounding box. Stays exact under any affine transformation,
+ * when it may become a parallelepiped.
+ */
+struct OBB {
+    glm::vec3 center {0.0f, 0.0f, 0.0f};
+    // Vectors from the center to the centers of three faces.
+    glm::mat3 half_axes {0.0f};
+
+    /**
+     * @brief Box along principal axes of the points or the AABB, whichever
+     * has the smaller volume.
+     */
+    [[nodiscard]] static OBB from_points(std::span<const glm::vec3> points, const AABB& aabb);
+
+    [[nodiscard]] OBB transformed(const glm::mat4& matrix) const {
+        return {glm::vec3(matrix * glm::vec4(center, 1.0f)), glm::mat3(matrix) * half_axes};
+    }
+
+    /**
+     * @brief Half length of the box projection onto the unit direction.
+     */
+    [[nodiscard]] float get_projection_radius(const glm::vec3& direction) const;
+};
+}
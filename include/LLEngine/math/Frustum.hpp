@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AABB.hpp"
+#include "BoundingVolumes.hpp"
 #include "Plane.hpp"
 
 #include <glm/geometric.hpp>
@@ -8,6 +9,10 @@
 
 namespace llengine {
 struct Frustum {
+    enum class Intersection {
+        OUTSIDE, INTERSECTS, INSIDE
+    };
+
     struct {
         Plane top, bottom, left, right, far, near;
 
@@ -57,5 +62,41 @@ struct Frustum {
 
         return true;
     }
+
+    [[nodiscard]] bool is_sphere_on_frustum(const glm::vec3& center, float radius) const {
+        for (std::size_t plane_i = 0; plane_i < 6; plane_i++) {
+            if (glm::dot(planes[plane_i].normal, center) - planes[plane_i].distance < -radius) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] Intersection classify_sphere(const BoundingSphere& sphere) const {
+        Intersection result = Intersection::INSIDE;
+        for (std::size_t plane_i = 0; plane_i < 6; plane_i++) {
+            const float distance = glm::dot(planes[plane_i].normal, sphere.center) - planes[plane_i].distance;
+            if (distance < -sphere.radius) {
+                return Intersection::OUTSIDE;
+            }
+            if (distance < sphere.radius) {
+                result = Intersection::INTERSECTS;
+            }
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] bool is_obb_on_frustum(const OBB& obb) const {
+        for (std::size_t plane_i = 0; plane_i < 6; plane_i++) {
+            const float distance = glm::dot(planes[plane_i].normal, obb.center) - planes[plane_i].distance;
+            if (distance < -obb.get_projection_radius(planes[plane_i].normal)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
 };
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <span>
+#include <array>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief RGB function on the unit sphere approximated with the first nine
+ * real spherical harmonics (bands 0, 1 and 2).
+ */
+struct SphericalHarmonics {
+    static constexpr std::size_t COEFFICIENTS_COUNT = 9;
+
+    std::array<glm::vec3, COEFFICIENTS_COUNT> coefficients {};
+
+    /**
+     * @brief Projects radiance stored in cubemap faces onto spherical harmonics.
+     *
+     * Work is split between threads, each one processes a range of rows.
+     * @param faces RGB float pixels of faces in the order of OpenGL cubemap
+     * targets (+X, -X, +Y, -Y, +Z, -Z), rows are tightly packed.
+     * @param face_size width and height of every face.
+     * @param threads_count amount of threads to use. Zero implies
+     * std::thread::hardware_concurrency().
+     */
+    [[nodiscard]] static SphericalHarmonics from_cubemap(
+        const std::array<std::span<const float>, 6>& faces, std::uint32_t face_size, std::uint32_t threads_count = 0
+    );
+
+    /**
+     * @brief Convolves radiance with the clamped cosine lobe and divides it by PI.
+     *
+     * Evaluation of the result gives the same values as the irradiance
+     * map computed by tex_utils::compute_irradiance_map.
+     */
+    [[nodiscard]] SphericalHarmonics radiance_to_irradiance() const;
+
+    [[nodiscard]] glm::vec3 evaluate(const glm::vec3& direction) const {
+        const float x = direction.x, y = direction.y, z = direction.z;
+        return
+            coefficients[0] * 0.282095f +
+            coefficients[1] * (0.488603f * y) +
+            coefficients[2] * (0.488603f * z) +
+            coefficients[3] * (0.488603f * x) +
+            coefficients[4] * (1.092548f * x * y) +
+            coefficients[5] * (1.092548f * y * z) +
+            coefficients[6] * (0.315392f * (3.0f * z * z - 1.0f)) +
+            coefficients[7] * (1.092548f * x * z) +
+            coefficients[8] * (0.546274f * (x * x - y * y));
+    }
+};
+}
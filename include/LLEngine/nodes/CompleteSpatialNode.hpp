@@ -39,9 +39,9 @@ public:
 
 protected:
     Transform transform = Transform();
-    mutable glm::mat4 cached_local_matrix = glm::mat4();
-    mutable bool needs_recalculation = true;
+    // Recalculated on every change, so getters can be called from several threads at once.
+    glm::mat4 cached_local_matrix = glm::mat4();
 
-    void recalculate_matrix() const noexcept;
+    void recalculate_matrix() noexcept;
 };
 }
\ No newline at end of file
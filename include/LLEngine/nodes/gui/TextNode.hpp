@@ -1,6 +1,6 @@
 #pragma once
 
-#include "rendering/Mesh.hpp"
+#include "rendering/DynamicMesh.hpp"
 #include "GUINode.hpp"
 #include "gui/FreeTypeFont.hpp"
 #include "rendering/Shader.hpp"
@@ -53,7 +53,8 @@ private:
     glm::vec3 color = {0.0f, 0.0f, 0.0f};
     std::string cached_text;
 
-    std::optional<Mesh> mesh = std::nullopt;
+    // Created on the first set_text with a font.
+    std::unique_ptr<DynamicMesh> mesh = nullptr;
     std::vector<std::reference_wrapper<const FreeTypeFont::FontChar>> chars;
     std::int32_t min_x = std::numeric_limits<std::int32_t>::max();
     std::int32_t max_x = std::numeric_limits<std::int32_t>::min();
@@ -5,6 +5,7 @@
 
 #include <glm/vec3.hpp>
 
+#include <mutex>
 #include <memory>
 #include <vector>
 
@@ -103,6 +104,8 @@ private:
     glm::vec3 cached_set_translation = {0.0f, 0.0f, 0.0f};
 
     mutable std::optional<glm::mat4> cached_global_matrix = std::nullopt;
+    // Children may get the global matrix from several threads while drawing is prepared.
+    mutable std::mutex cached_global_matrix_mutex;
 
     bool check_collisions = false;
 
@@ -17,6 +17,10 @@ class CameraNode : public CompleteSpatialNode {
 public:
     CameraNode();
 
+    /**
+     * @brief Matrix getters must be called on the rendering thread only, never
+     * from Drawable::prepare_concurrently.
+     */
     [[nodiscard]] const glm::mat4& get_view_matrix() const;
     [[nodiscard]] const glm::mat4& get_proj_matrix() const;
     [[nodiscard]] const glm::mat4& get_view_proj_matrix() const;
@@ -63,6 +67,8 @@ private:
     float far_distance = 100.0f;
     float near_distance = 0.1f;
 
+    // Lazily filled, so the matrix getters must not be called concurrently.
+    // Drawables get the frustum and the camera position by value instead.
     mutable bool is_cached_view_matrix_valid = false;
     mutable bool is_cached_proj_matrix_valid = false;
     mutable bool is_cached_view_proj_matrix_valid = false;
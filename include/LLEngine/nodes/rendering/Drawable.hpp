@@ -2,11 +2,91 @@
 
 #include "datatypes.hpp"
 
+#include <glm/vec3.hpp>
+
+#include <span>
+
 namespace llengine {
 struct Frustum;
+
+/**
+ * @brief State the render queue sorts drawables by. Drawables with equal
+ * program, material and vertex array can be drawn without rebinding them.
+ */
+struct RenderKeyParts {
+    ShaderID program_id = 0;
+    // Null if the drawable binds its own textures and uniforms.
+    const void* material = nullptr;
+    VertexArrayID vertex_array_id = 0;
+    // Drawables with equal program, material and non-null mesh can be drawn instanced.
+    // With multi-draw, also drawables with different meshes and an equal vertex array.
+    const void* mesh = nullptr;
+    // Distance from the camera, in world units.
+    float depth = 0.0f;
+};
+
+/**
+ * @brief What changed since the previous drawable submitted by the render queue.
+ */
+struct RenderStateChanges {
+    bool program = true;
+    bool material = true;
+    bool vertex_array = true;
+};
+
+/**
+ * @brief Result of Drawable::prepare_concurrently.
+ */
+enum class DrawPreparation {
+    CULLED,
+    PREPARED,
+    // Must be done on the rendering thread with is_outside_the_frustum and get_render_key_parts.
+    DEFERRED
+};
+
 class Drawable {
 public:
     virtual void draw() = 0;
+    /**
+     * @brief Draws the object when it is submitted by the render queue,
+     * skipping binding of the unchanged state.
+     */
+    virtual void draw_queued([[maybe_unused]] const RenderStateChanges& changes) {
+        draw();
+    }
+    /**
+     * @brief Draws drawables that returned the same program, material and mesh
+     * from get_render_key_parts. instances starts with this drawable.
+     */
+    virtual void draw_queued_instances(const RenderStateChanges& changes, std::span<Drawable* const> instances) {
+        RenderStateChanges instance_changes = changes;
+        for (Drawable* instance : instances) {
+            instance->draw_queued(instance_changes);
+            instance_changes = {false, false, false};
+        }
+    }
+    /**
+     * @brief Draws drawables that returned the same program, material and vertex
+     * array, but not necessarily the same mesh, from get_render_key_parts. Drawables
+     * with equal meshes are neighbours. drawables starts with this drawable.
+     */
+    virtual void draw_queued_multi(const RenderStateChanges& changes, std::span<Drawable* const> drawables) {
+        RenderStateChanges drawable_changes = changes;
+        for (Drawable* drawable : drawables) {
+            drawable->draw_queued(drawable_changes);
+            drawable_changes = {false, false, false};
+        }
+    }
+    /**
+     * @brief Writes only the depth of drawables that returned the same program and
+     * mesh from get_render_key_parts, for the depth pre-pass. instances starts with
+     * this drawable. Depth must be bit-exact to the one of draw_queued.
+     * @return False if the pre-pass is not supported, then the drawables are
+     * drawn only in the main pass.
+     */
+    virtual bool draw_to_depth_prepass([[maybe_unused]] std::span<Drawable* const> instances) {
+        return false;
+    }
     virtual void draw_to_shadow_map() {}
     [[nodiscard]] virtual bool is_enabled() const = 0;
     /**
@@ -18,6 +98,9 @@ public:
      * node, or 0 if there are a lot of shaders used.
      */
     virtual ShaderID get_program_id() const = 0;
+    [[nodiscard]] virtual RenderKeyParts get_render_key_parts([[maybe_unused]] const glm::vec3& camera_position) const {
+        return {get_program_id()};
+    }
 
     /**
      * @brief Tests if the drawable object is definitely outside the
@@ -31,5 +114,20 @@ public:
     [[nodiscard]] virtual bool is_outside_the_frustum(const Frustum& frustum) const {
         return false;
     }
+
+    /**
+     * @brief Culls the enabled drawable and computes its render key parts, like
+     * is_outside_the_frustum and get_render_key_parts, but on a worker thread
+     * concurrently with other drawables.
+     *
+     * Must neither call the graphics API nor modify anything, including caches.
+     * Drawables that can't avoid it return DEFERRED.
+     */
+    [[nodiscard]] virtual DrawPreparation prepare_concurrently(
+        [[maybe_unused]] const Frustum& frustum, [[maybe_unused]] const glm::vec3& camera_position,
+        [[maybe_unused]] RenderKeyParts& parts
+    ) const {
+        return DrawPreparation::DEFERRED;
+    }
 };
 }
\ No newline at end of file
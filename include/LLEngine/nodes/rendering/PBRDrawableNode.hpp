@@ -17,8 +17,13 @@ public:
     );
 
     void draw() override;
+    void draw_queued(const RenderStateChanges& changes) override;
+    void draw_queued_instances(const RenderStateChanges& changes, std::span<Drawable* const> instances) override;
+    void draw_queued_multi(const RenderStateChanges& changes, std::span<Drawable* const> drawables) override;
+    bool draw_to_depth_prepass(std::span<Drawable* const> instances) override;
     void draw_to_shadow_map() override;
     ShaderID get_program_id() const override;
+    [[nodiscard]] RenderKeyParts get_render_key_parts(const glm::vec3& camera_position) const override;
 
     void set_mesh(const std::shared_ptr<const Mesh>& mesh);
     void set_material(const std::shared_ptr<Material>& material);
@@ -27,6 +32,9 @@ public:
     [[nodiscard]] const Material& get_material() const;
 
     [[nodiscard]] virtual bool is_outside_the_frustum(const Frustum& frustum) const final override;
+    [[nodiscard]] DrawPreparation prepare_concurrently(
+        const Frustum& frustum, const glm::vec3& camera_position, RenderKeyParts& parts
+    ) const override;
 
     void copy_to(Node& node) const override;
     std::unique_ptr<Node> copy() const override;
@@ -34,5 +42,7 @@ public:
 private:
     std::shared_ptr<const Mesh> mesh = nullptr;
     std::shared_ptr<Material> material = nullptr;
+
+    void check_mesh_and_material() const;
 };
 }
\ No newline at end of file
@@ -9,6 +9,9 @@ class RenderingServer;
 
 struct PointLightNode : public CompleteSpatialNode {
     glm::vec3 color;
+    // Distance at which the light fades out completely. If not positive,
+    // it is the one where the inverse-square attenuation falls below LIGHT_CUTOFF.
+    float range = 0.0f;
 
     PointLightNode() = default;
     PointLightNode(const PointLightNode& other) = delete;
@@ -17,6 +20,13 @@ struct PointLightNode : public CompleteSpatialNode {
     PointLightNode& operator=(PointLightNode&& other) = delete;
     ~PointLightNode();
 
+    /**
+     * @brief Returns the range, or the one derived from the color if it is not set.
+     */
+    [[nodiscard]] float get_effective_range() const;
+
+    static constexpr float LIGHT_CUTOFF = 0.01f;
+
     void _on_attachment_to_tree_without_start() final override;
 
     virtual void copy_to(Node& node) const override;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "datatypes.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <span>
+#include <array>
+#include <cstddef>
+
+namespace llengine {
+/**
+ * @brief Non-indexed mesh with positions and optional UVs for geometry
+ * that changes often, like text.
+ *
+ * The vertex buffer is split into FRAMES_COUNT regions used in turns, so
+ * the GPU keeps reading the older data while the new one is written. Every
+ * region is fenced and reused only after the GPU is done with it. The buffer
+ * is persistently mapped when ARB_buffer_storage is available, otherwise
+ * regions are mapped unsynchronized and the buffer is orphaned only if the
+ * GPU is more than FRAMES_COUNT updates behind.
+ */
+class DynamicMesh {
+public:
+    /**
+     * @param vertices_capacity Initial maximum amount of vertices. Exceeding it
+     * reallocates the buffer, so it should be big enough for common updates.
+     */
+    explicit DynamicMesh(bool with_uvs, std::size_t vertices_capacity = 1024);
+    DynamicMesh(const DynamicMesh& other) = delete;
+    DynamicMesh(DynamicMesh&& other) = delete;
+    ~DynamicMesh();
+
+    DynamicMesh& operator=(const DynamicMesh& other) = delete;
+    DynamicMesh& operator=(DynamicMesh&& other) = delete;
+
+    /**
+     * @brief Replaces all vertices. Draw calls issued before are not affected.
+     *
+     * uvs must be empty if the mesh has no UVs and must have as many elements
+     * as vertices otherwise.
+     */
+    void update(std::span<const glm::vec3> vertices, std::span<const glm::vec2> uvs = {});
+
+    /**
+     * @brief Binds the VAO. It stays bound until another one is bound.
+     */
+    void bind_vao() const;
+
+    /**
+     * @brief Draws triangles from a range of vertices. The VAO must be bound.
+     */
+    void draw(std::size_t first, std::size_t count) const;
+    void draw() const;
+
+    [[nodiscard]] std::size_t get_vertices_count() const noexcept { return vertices_count; }
+    [[nodiscard]] bool has_uvs() const noexcept { return with_uvs; }
+
+    static constexpr std::size_t FRAMES_COUNT = 3;
+
+private:
+    VertexArrayID vao_id = 0;
+    BufferID buffer_id = 0;
+    std::byte* persistent_data = nullptr;
+    // Fences of the draws that read the regions. Null if there are none.
+    std::array<void*, FRAMES_COUNT> fences {};
+
+    bool with_uvs;
+    std::size_t vertices_capacity = 0;
+    std::size_t vertices_count = 0;
+    std::size_t current_region = 0;
+    mutable bool current_region_drawn = false;
+
+    [[nodiscard]] std::size_t get_stride() const;
+    void allocate_buffer(std::size_t new_vertices_capacity);
+    void delete_buffer();
+    /**
+     * @brief Checks the fence of the region, waiting for it if block is true.
+     * @return Whether the GPU has finished reading the region.
+     */
+    [[nodiscard]] bool wait_for_region(std::size_t region, bool block);
+};
+}
@@ -1,21 +1,45 @@
 #pragma once
 
 #include "Texture.hpp"
+#include "math/SphericalHarmonics.hpp"
 
 #include <memory>
+#include <cstdint>
 #include <optional>
+#include <filesystem>
 
 namespace llengine {
 class LightingEnvironment {
 public:
-    void set_base_cubemap(const std::shared_ptr<Texture>& new_base_map);
+    /**
+     * @brief Sets the environment cubemap, resetting maps computed from the previous one.
+     *
+     * @param source_hash hash of the image the cubemap was made from. If specified
+     * along with the cache directory, computed maps are cached on disk.
+     */
+    void set_base_cubemap(
+        const std::shared_ptr<Texture>& new_base_map,
+        std::optional<std::uint64_t> source_hash = std::nullopt
+    );
+    /**
+     * @brief Sets directory for precomputed maps. Empty path disables the cache.
+     */
+    void set_cache_directory(const std::filesystem::path& directory);
     [[nodiscard]] std::shared_ptr<const Texture> get_base_cubemap() const;
     [[nodiscard]] const std::optional<Texture>& get_irradiance_map() const;
     [[nodiscard]] const std::optional<Texture>& get_prefiltered_specular_map() const;
+    /**
+     * @brief Returns irradiance of the environment as spherical harmonics,
+     * an alternative to the irradiance map that is computed on the CPU.
+     */
+    [[nodiscard]] const std::optional<SphericalHarmonics>& get_irradiance_sh() const;
 
 private:
     std::shared_ptr<Texture> base_map = nullptr;
+    std::optional<std::uint64_t> source_hash = std::nullopt;
+    std::filesystem::path cache_directory;
     mutable std::optional<Texture> irradiance_map = std::nullopt;
     mutable std::optional<Texture> prefiltered_specular_map = std::nullopt;
+    mutable std::optional<SphericalHarmonics> irradiance_sh = std::nullopt;
 };
 }
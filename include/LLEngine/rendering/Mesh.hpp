@@ -3,6 +3,10 @@
 #include <vector>
 #include <memory>
 #include <variant>
+#include <optional>
+#include <compare>
+#include <span>
+#include <cstdint>
 
 #include <glm/vec2.hpp> // glm::vec2
 #include <glm/vec3.hpp> // glm::vec3
@@ -10,11 +14,20 @@
 
 #include "datatypes.hpp"
 #include "math/AABB.hpp"
+#include "math/BoundingVolumes.hpp"
+#include "rendering/Meshlet.hpp"
+#include "rendering/MeshResidency.hpp"
 
 namespace llengine {
+class MeshBufferAllocation;
+
 class Mesh {
 public:
-    Mesh() = default;
+    Mesh();
+    /**
+     * @brief Copies the RAM data. The GPU data is shared by the copies and
+     * is never modified: a changed mesh uploads into new buffer ranges.
+     */
     Mesh(const Mesh& other);
     Mesh(Mesh&& other) noexcept;
     ~Mesh();
@@ -22,17 +35,70 @@ public:
     Mesh& operator=(const Mesh& other);
     Mesh& operator=(Mesh&& other) noexcept;
 
-    [[nodiscard]] BufferID get_indices_id() const { return indices_id; }
-    [[nodiscard]] BufferID get_vertices_id() const { return vertices_id; }
-    [[nodiscard]] BufferID get_uvs_id() const { return uvs_id; }
-    [[nodiscard]] BufferID get_normals_id() const { return normals_id; }
-    [[nodiscard]] BufferID get_tangents_id() const { return tangents_id; }
+    /**
+     * @brief Byte layout of the interleaved vertex buffer.
+     *
+     * Positions are always at offset 0. Absent attributes have no offset.
+     */
+    struct VertexLayout {
+        GraphicsAPISize stride = sizeof(glm::vec3);
+        std::optional<std::size_t> uv_offset;
+        std::optional<std::size_t> normal_offset;
+        std::optional<std::size_t> tangent_offset;
+
+        auto operator<=>(const VertexLayout& other) const = default;
+    };
+
+    static constexpr std::uint32_t INSTANCE_INDEX_ATTRIBUTE = 4;
+
+    using Residency = MeshResidency;
+
+    /**
+     * @brief Returns the index buffer shared with other meshes. Indices of this
+     * mesh start at get_indices_offset(). Uploads the data first if it was changed.
+     */
+    [[nodiscard]] BufferID get_indices_id() const;
+    /**
+     * @brief Returns the vertex buffer shared with other meshes of the same layout.
+     * Vertices of this mesh are interleaved according to get_vertex_layout() and
+     * start at get_base_vertex(). Uploads the data first if it was changed.
+     */
+    [[nodiscard]] BufferID get_vertex_buffer_id() const;
+    [[nodiscard]] VertexLayout get_vertex_layout() const;
+    [[nodiscard]] GraphicsAPISize get_base_vertex() const;
+    /**
+     * @brief Offset of the first index in bytes.
+     */
+    [[nodiscard]] std::size_t get_indices_offset() const;
+
+    [[nodiscard]] bool has_uvs() const noexcept { return vertex_layout.uv_offset.has_value(); }
+    [[nodiscard]] bool has_normals() const noexcept { return vertex_layout.normal_offset.has_value(); }
+    [[nodiscard]] bool has_tangents() const noexcept { return vertex_layout.tangent_offset.has_value(); }
+
+    /**
+     * @brief Sets which data is kept in RAM after the upload. Data that was
+     * already released is read back from the GPU if the new mode needs it.
+     *
+     * Setters read released data back to edit it, the next upload releases it again.
+     */
+    void set_residency(Residency new_residency);
+    [[nodiscard]] Residency get_residency() const noexcept { return residency.get_requested(); }
+    /**
+     * @brief Restores RAM copies of all the data by reading them back from the
+     * GPU and switches the residency to CPU_AND_GPU. This is slow.
+     */
+    void read_back();
+    /**
+     * @brief Returns vertex positions. Throws std::runtime_error if they were
+     * released because of the GPU_ONLY residency.
+     */
+    [[nodiscard]] const std::vector<glm::vec3>& get_vertices() const;
 
     [[nodiscard]] GraphicsAPISize get_amount_of_vertices() const;
     [[nodiscard]] GraphicsAPIEnum get_indices_type() const;
 
     [[nodiscard]] inline bool is_initialized() const noexcept {
-        return vertices_id != 0;
+        return vertices_count != 0;
     }
 
     [[nodiscard]] inline glm::vec3 get_max_vertex_values() const {
@@ -44,19 +110,61 @@ public:
     [[nodiscard]] inline AABB get_aabb() const {
         return { get_max_vertex_values(), get_min_vertex_values() };
     }
+    [[nodiscard]] inline const BoundingSphere& get_bounding_sphere() const noexcept {
+        return bounding_sphere;
+    }
+    [[nodiscard]] inline const OBB& get_obb() const noexcept {
+        return obb;
+    }
 
     /**
-     * @brief Binds this Mesh's VAO. If this Mesh does not have a VAO,
-     * one will be created.
+     * @brief Binds the VAO this Mesh shares with other meshes of the same vertex
+     * layout, uploading the data first if needed.
      *
      * Vertex attribute array index 0 corresponds to vertex positions,
      * 1 to UVs,
      * 2 to normals,
-     * 3 to tangents.
+     * 3 to tangents,
+     * INSTANCE_INDEX_ATTRIBUTE to instance indices, it is always enabled.
+     *
+     * The VAO stays bound until another one is bound, there is no need to unbind it.
      */
     void bind_vao(bool enable_uv = true, bool enable_normals = true, bool enable_tangents = true) const;
-    void unbind_vao(bool unbind_uv, bool unbind_normals, bool unbind_tangents) const;
+    /**
+     * @brief Returns the VAO bind_vao binds, or 0 if the mesh is not uploaded
+     * yet or has to be uploaded again.
+     */
+    [[nodiscard]] VertexArrayID get_vao_id() const noexcept;
+
+    /**
+     * @brief Issues the draw call for the whole mesh. The VAO must be bound.
+     */
+    void draw() const;
+    /**
+     * @brief Draws the whole mesh several times in one draw call. The VAO must be bound.
+     */
+    void draw_instanced(std::size_t instances_count) const;
+    /**
+     * @brief Draws only the specified meshlets in one multi-draw call, merging
+     * adjacent ones. The VAO must be bound.
+     */
+    void draw_meshlets(std::span<const std::uint32_t> meshlet_indices) const;
+
+    /**
+     * @brief Splits triangles into meshlets for culling and reorders indices
+     * so that every meshlet is a contiguous range. Does nothing for meshes
+     * without indices. Changing indices or vertices removes meshlets.
+     */
+    void build_meshlets();
+    [[nodiscard]] const std::vector<Meshlet>& get_meshlets() const noexcept {
+        return meshlets;
+    }
 
+    /**
+     * @brief Sets indices. 32-bit indices are stored as 16-bit ones if all of them fit.
+     *
+     * Released vertex data isn't read back, it's copied on the GPU instead.
+     */
     template<typename T>
     void set_indices(const std::vector<T>& new_indices);
     void set_vertices(const std::vector<glm::vec3>& new_vertices);
@@ -64,11 +172,30 @@ public:
     void set_normals(const std::vector<glm::vec3>& new_normals);
     void set_tangents(const std::vector<glm::vec4>& new_tangents);
 
-    void index_data();
+    enum class IndexingAlgorithm {
+        /// Parallel sort for meshes with millions of vertices, hash table for others.
+        AUTOMATIC,
+        HASH_TABLE,
+        PARALLEL_SORT
+    };
+    /**
+     * @brief Merges bit-exact duplicate vertices and indexes the mesh. Existing
+     * indices are remapped to the merged vertices.
+     *
+     * @param compare_tangents If false, vertices differing only in tangents are
+     * merged and the tangent of the first one is kept.
+     */
+    void index_data(bool compare_tangents = true, IndexingAlgorithm algorithm = IndexingAlgorithm::AUTOMATIC);
 
-    [[nodiscard]] bool is_indexed() const {
-        return get_indices_id() != 0;
-    }
+    /**
+     * @brief Converts 32-bit indices to 16-bit ones.
+     * @return std::nullopt if some index doesn't fit into 16 bits.
+     */
+    [[nodiscard]] static std::optional<std::vector<std::uint16_t>> narrow_indices(
+        std::span<const std::uint32_t> indices
+    );
+
+    [[nodiscard]] bool is_indexed() const;
 
     /**
      * @brief Get the indexed 2x2x2 cube mesh with UVs, normals and tangents.
@@ -96,74 +223,40 @@ public:
     [[nodiscard]] static std::shared_ptr<const Mesh> get_quad();
 
 private:
-    class HandledBufferID {
-    public:
-        HandledBufferID();
-        HandledBufferID(BufferID buffer_id);
-        HandledBufferID(const HandledBufferID& other) = delete;
-        HandledBufferID(HandledBufferID&& other) noexcept;
-        ~HandledBufferID();
-
-        operator BufferID() const {
-            return get();
-        }
-
-        [[nodiscard]] BufferID get() const {
-            return buffer_id;
-        }
-
-        HandledBufferID& operator=(const HandledBufferID& other) = delete;
-        HandledBufferID& operator=(HandledBufferID&& other) noexcept;
-        HandledBufferID& operator=(BufferID buffer_id);
-
-    private:
-        BufferID buffer_id;
-    };
+    /// Immutable and shared between copies of the mesh.
+    mutable std::shared_ptr<const MeshBufferAllocation> allocation;
+    /// Whether CPU-side data was changed after the last upload to the GPU.
+    mutable bool upload_needed = false;
+    /// Whether only indices were changed after vertex data was released, so the
+    /// next upload takes vertex data from the current allocation.
+    mutable bool reuse_gpu_vertices = false;
+    /// Changes on release, which happens after the upload.
+    mutable MeshResidencyState residency;
 
-    class ManagedVertexArrayID {
-    public:
-        ManagedVertexArrayID();
-        ManagedVertexArrayID(VertexArrayID vao_id);
-        ManagedVertexArrayID(const ManagedVertexArrayID& other) = delete;
-        ManagedVertexArrayID(ManagedVertexArrayID&& other) noexcept;
-        ~ManagedVertexArrayID();
-
-        operator VertexArrayID() const {
-            return get();
-        }
-
-        [[nodiscard]] const VertexArrayID& get() const {
-            return vao_id;
-        }
-
-        [[nodiscard]] VertexArrayID& get() {
-            return vao_id;
-        }
-
-        ManagedVertexArrayID& operator=(const ManagedVertexArrayID& other) = delete;
-        ManagedVertexArrayID& operator=(ManagedVertexArrayID&& other) noexcept;
-        ManagedVertexArrayID& operator=(VertexArrayID vao_id);
-    
-    private:
-        VertexArrayID vao_id;
-    };
+    // Data below may be released after the upload, so the layout and counts are kept separately.
+    mutable std::variant<std::vector<uint16_t>, std::vector<uint32_t>> indices;
+    mutable std::vector<glm::vec3> vertices;
+    mutable std::vector<glm::vec2> uvs;
+    mutable std::vector<glm::vec3> normals;
+    mutable std::vector<glm::vec4> tangents;
 
-    HandledBufferID indices_id = 0, vertices_id = 0, uvs_id = 0,
-           normals_id = 0, tangents_id = 0;
-    mutable ManagedVertexArrayID vao_id = 0;
+    std::vector<Meshlet> meshlets;
 
-    std::variant<std::vector<uint16_t>, std::vector<uint32_t>> indices;
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec4> tangents;
+    VertexLayout vertex_layout;
+    std::size_t vertices_count = 0;
+    std::size_t indices_count = 0;
 
     glm::vec3 min_vertex_value;
     glm::vec3 max_vertex_value;
+    BoundingSphere bounding_sphere;
+    OBB obb;
 
-    template<typename T> void index_data();
-    void reset_vao_if_needed() const;
-    void initialize_vao() const;
+    void upload_if_needed() const;
+    void release_cpu_data_if_needed() const;
+    void read_back_if_released();
+    void read_back_released_data();
+    void update_vertex_layout();
     void compute_min_and_max_vertex_values();
+    void compute_bounding_volumes();
 };
 }
\ No newline at end of file
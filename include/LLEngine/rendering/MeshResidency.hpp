@@ -0,0 +1,69 @@
+#pragma once
+
+namespace llengine {
+/**
+ * @brief Which data a Mesh keeps in RAM after uploading it to the GPU.
+ * Every mode keeps less data than the previous one.
+ */
+enum class MeshResidency {
+    CPU_AND_GPU,
+    /// Keep only vertex positions, e.g. for physics or picking.
+    GPU_WITH_POSITIONS,
+    /// Keep only the AABB.
+    GPU_ONLY
+};
+
+/**
+ * @brief Residency requested for a mesh and the data it actually has in RAM.
+ *
+ * They differ when released data is read back to be edited: the data is kept
+ * until the next upload, after which it is released again as requested.
+ */
+class MeshResidencyState {
+public:
+    [[nodiscard]] MeshResidency get_requested() const noexcept {
+        return requested;
+    }
+    /**
+     * @brief Returns the residency matching the data that is in RAM now.
+     */
+    [[nodiscard]] MeshResidency get_current() const noexcept {
+        return current;
+    }
+    [[nodiscard]] bool is_released() const noexcept {
+        return current != MeshResidency::CPU_AND_GPU;
+    }
+
+    /**
+     * @brief Changes the requested residency.
+     * @return true if the new mode needs data that was released, so it must be read back.
+     */
+    [[nodiscard]] bool request(MeshResidency residency) noexcept {
+        requested = residency;
+        return static_cast<int>(requested) < static_cast<int>(current);
+    }
+    /**
+     * @brief Must be called when all the data is read back from the GPU.
+     * The requested residency stays as it is.
+     */
+    void mark_read_back() noexcept {
+        current = MeshResidency::CPU_AND_GPU;
+    }
+    /**
+     * @brief Must be called when the data is on the GPU and can be released.
+     * @return true if the data beyond the requested residency must be released now.
+     */
+    [[nodiscard]] bool release_to_requested() noexcept {
+        if (requested == MeshResidency::CPU_AND_GPU) {
+            return false;
+        }
+
+        current = requested;
+        return true;
+    }
+
+private:
+    MeshResidency requested = MeshResidency::CPU_AND_GPU;
+    MeshResidency current = MeshResidency::CPU_AND_GPU;
+};
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief A cluster of mesh triangles stored as a contiguous index range,
+ * with bounds for culling. Everything is in the model space.
+ */
+struct Meshlet {
+    // In indices, relative to the first index of the mesh.
+    std::uint32_t first_index = 0;
+    std::uint32_t indices_count = 0;
+
+    glm::vec3 bounding_sphere_center {0.0f, 0.0f, 0.0f};
+    float bounding_sphere_radius = 0.0f;
+
+    // Cone containing normals of all the triangles. The zero axis means that
+    // the triangles face too different directions to be culled by the cone.
+    glm::vec3 cone_axis {0.0f, 0.0f, 0.0f};
+    float cone_cutoff = 1.0f;
+
+    /**
+     * @brief Conservatively checks whether all the triangles face away from the camera.
+     */
+    [[nodiscard]] bool is_backfacing(const glm::vec3& camera_position) const {
+        const glm::vec3 to_center = bounding_sphere_center - camera_position;
+        return glm::dot(to_center, cone_axis) >= cone_cutoff * glm::length(to_center) + bounding_sphere_radius;
+    }
+};
+}
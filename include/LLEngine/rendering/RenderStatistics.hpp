@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+namespace llengine {
+/**
+ * @brief OpenGL calls skipped because they wouldn't change the state.
+ */
+struct SkippedStateCalls {
+    std::size_t program = 0;
+    std::size_t vertex_array = 0;
+    // Both active texture unit changes and texture binds.
+    std::size_t texture = 0;
+    std::size_t sampler = 0;
+    // Blending, depth and face culling state.
+    std::size_t render_state = 0;
+};
+
+/**
+ * @brief Counters of the last drawn frame.
+ */
+struct RenderStatistics {
+    // Instanced draws are counted once.
+    std::size_t draws_count = 0;
+    std::size_t objects_count = 0;
+    std::size_t program_changes = 0;
+    std::size_t material_changes = 0;
+    std::size_t vertex_array_changes = 0;
+    std::size_t depth_prepass_draws_count = 0;
+    // Fragments that passed the depth test in the opaque pass per pixel.
+    // Measured a few frames late, zero until the first measurement.
+    float overdraw = 0.0f;
+    // Of the whole frame, including GUI and postprocessing.
+    SkippedStateCalls skipped_state_calls;
+};
+}
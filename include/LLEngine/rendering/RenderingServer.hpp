@@ -15,6 +15,9 @@
 #include "rendering/Window.hpp" // Window
 #include "rendering/Skybox.hpp" // Skybox
 #include "rendering/Texture.hpp"
+#include "rendering/TextureCache.hpp"
+#include "rendering/RenderStatistics.hpp"
+#include "math/Frustum.hpp"
 
 namespace llengine {
 class Texture;
@@ -23,6 +26,20 @@ class CameraNode;
 class Drawable;
 class GUICanvas;
 class MainFramebuffer;
+class TextureUploader;
+class MeshBufferArena;
+class RenderQueue;
+class DrawRecorder;
+class WorkerPool;
+class InstanceBuffer;
+class DrawIndirectBuffer;
+class LightClusterBuffer;
+class ObjectLights;
+class SamplesPassedQuery;
+class UniformRingBuffer;
+class MaterialBlockCache;
+class GLStateTracker;
+class Mesh;
 struct PointLightNode;
 struct SpotLight;
 
@@ -32,7 +49,15 @@ struct SpotLight;
  */
 class RenderingServer {
 public:
-    explicit RenderingServer(glm::ivec2 window_size, std::string_view window_title = "LLEngine");
+    /**
+     * @param gl_version_major, gl_version_minor Version of the requested OpenGL core
+     * context, 3.3 at least. Some optimizations, like multi-draw indirect, are used only
+     * if the context supports them.
+     */
+    explicit RenderingServer(
+        glm::ivec2 window_size, std::string_view window_title = "LLEngine",
+        int gl_version_major = 3, int gl_version_minor = 3
+    );
     RenderingServer(const RenderingServer& other) = delete;
     RenderingServer(RenderingServer&& other) = delete;
     ~RenderingServer();
@@ -44,7 +69,14 @@ public:
     [[nodiscard]] static RenderingServer* current_optional();
     [[nodiscard]] static std::uint32_t current_context_id();
 
-    void set_cubemap(const std::shared_ptr<Texture>& cubemap);
+    /**
+     * @brief Sets cubemap for the skybox and the global lighting environment.
+     *
+     * @param source_hash hash of the source image, enables on-disk caching
+     * of lighting maps computed from the cubemap.
+     * @sa llengine::LightingEnvironment::set_base_cubemap
+     */
+    void set_cubemap(const std::shared_ptr<Texture>& cubemap, std::optional<std::uint64_t> source_hash = std::nullopt);
     void set_update_callback(const std::function<void(float)> callback) {
         this->update_callback = callback;
     }
@@ -143,6 +175,20 @@ public:
         return delta_time;
     }
 
+    /**
+     * @brief Returns the index of the frame being drawn, incremented every frame.
+     */
+    [[nodiscard]] std::uint64_t get_frame_index() const noexcept {
+        return frame_index;
+    }
+
+    /**
+     * @brief Returns draw calls and state changes of the objects drawn in the last frame.
+     */
+    [[nodiscard]] const RenderStatistics& get_render_statistics() const noexcept {
+        return render_statistics;
+    }
+
     [[nodiscard]] Window& get_window() {
         return window;
     }
@@ -151,7 +197,32 @@ public:
         return global_lighting_environment;
     }
 
+    [[nodiscard]] TextureCache& get_texture_cache() {
+        return texture_cache;
+    }
+
     [[nodiscard]] FramebufferID _get_main_framebuffer_id() const;
+    [[nodiscard]] GLStateTracker& _get_gl_state();
+    [[nodiscard]] TextureUploader& _get_texture_uploader();
+    [[nodiscard]] MeshBufferArena& _get_mesh_buffer_arena();
+    [[nodiscard]] InstanceBuffer& _get_instance_buffer();
+    /**
+     * @brief Returns null if multi-draw indirect is not supported.
+     */
+    [[nodiscard]] DrawIndirectBuffer* _get_draw_indirect_buffer();
+    [[nodiscard]] LightClusterBuffer& _get_light_cluster_buffer();
+    /**
+     * @brief Lights of the frame to select from if they are assigned per object,
+     * none otherwise.
+     */
+    [[nodiscard]] const ObjectLights& _get_object_lights() const;
+    [[nodiscard]] UniformRingBuffer& _get_uniform_ring_buffer();
+    [[nodiscard]] MaterialBlockCache& _get_material_block_cache();
+    /**
+     * @brief Draws the mesh, skipping meshlets that are outside the camera frustum
+     * or face away from the camera. The VAO of the mesh must be bound.
+     */
+    void _draw_mesh_culled(const Mesh& mesh, const glm::mat4& model_matrix);
 
 private:
     Window window;
@@ -165,17 +236,35 @@ private:
     // Time point of the last frame.
     std::chrono::high_resolution_clock::time_point prev_frame_time;
     float delta_time = 1.0f;
+    std::uint64_t frame_index = 0;
 
+    std::unique_ptr<GLStateTracker> gl_state;
     std::unique_ptr<MainFramebuffer> main_framebuffer;
+    std::unique_ptr<TextureUploader> texture_uploader;
+    std::unique_ptr<MeshBufferArena> mesh_buffer_arena;
+    std::unique_ptr<RenderQueue> render_queue;
+    std::unique_ptr<DrawRecorder> draw_recorder;
+    std::unique_ptr<WorkerPool> worker_pool;
+    std::unique_ptr<InstanceBuffer> instance_buffer;
+    std::unique_ptr<DrawIndirectBuffer> draw_indirect_buffer;
+    std::unique_ptr<LightClusterBuffer> light_cluster_buffer;
+    std::unique_ptr<ObjectLights> object_lights;
+    std::unique_ptr<SamplesPassedQuery> opaque_samples_query;
+    std::unique_ptr<UniformRingBuffer> uniform_ring_buffer;
+    std::unique_ptr<MaterialBlockCache> material_block_cache;
+    RenderStatistics render_statistics;
 
     std::optional<ShadowMap> shadow_map;
     bool face_culling_enabled = true;
 
     // Non-owning pointer to the current camera node.
     CameraNode* camera = nullptr;
+    // Frustum of the current camera in the frame being drawn.
+    Frustum camera_frustum;
 
     std::unique_ptr<Skybox> skybox = nullptr;
     LightingEnvironment global_lighting_environment;
+    TextureCache texture_cache;
 
     std::vector<Drawable*> drawables;
     std::vector<GUICanvas*> gui_canvases;
@@ -183,6 +272,7 @@ private:
 
     void unblock_mouse_press();
     void draw_non_overlay_objects();
+    void bind_frame_uniform_block(const CameraNode& camera_node);
 
     void initialize_shadow_map();
     void update_shadow_map();
@@ -30,6 +30,7 @@ void set_mat4(ShaderID shader_id, ShaderUniformID uniform_id, const glm::mat4& v
 void bind_1d_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id);
 void bind_2d_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id);
 void bind_cubemap_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id);
+void bind_buffer_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id);
 
 void load_shader(
     std::string_view vertex_shader_code, std::string_view fragment_shader_code,
@@ -186,6 +187,11 @@ public:
         internal::bind_cubemap_texture(get_uniform_id<Name>(), texture_unit, texture_id);
     }
 
+    template<ConstUniformName Name>
+    void bind_buffer_texture(TextureID texture_id, GraphicsAPIEnum texture_unit) const {
+        internal::bind_buffer_texture(get_uniform_id<Name>(), texture_unit, texture_id);
+    }
+
     void use_shader() const {
         internal::use_shader(shader_id);
     }
@@ -2,6 +2,7 @@
 
 #include <ios> // std::streamsize
 #include <string> // std::string
+#include <compare> // std::strong_ordering
 
 #include <glm/vec2.hpp> // glm::u32vec2
 
@@ -18,8 +19,14 @@ struct TexLoadingParams {
     std::string file_path;
     std::streamsize offset;
     std::streamsize size; // Zero implies that loader must load to the end.
+    // Empty string implies that the format must be detected from the file itself.
+    std::string mime_type;
 
     TexLoadingParams();
+
+    [[nodiscard]] static TexLoadingParams from_property(const NodeProperty& property);
+
+    auto operator<=>(const TexLoadingParams& other) const = default;
 };
 
 class TextureLoadingError : std::runtime_error {
@@ -84,6 +91,20 @@ public:
     [[nodiscard]] Type get_type() const {
         return type;
     }
+    /**
+     * @brief Computes amount of video memory occupied by this texture,
+     * including all mipmap levels and cubemap faces.
+     *
+     * Queries the graphics API, so it is not supposed to be called every frame.
+     */
+    [[nodiscard]] std::size_t compute_memory_usage() const;
+    /**
+     * @brief Writes all mipmap levels (and cubemap faces) of this texture
+     * to a KTX2 file in the RGB16F format.
+     *
+     * Throws std::runtime_error on failure.
+     */
+    void save_to_ktx2(const std::string& file_path) const;
 
     [[nodiscard]] static Texture from_texture_id(TextureID texture_id, glm::u32vec2 tex_size, Type type);
     [[nodiscard]] static Texture from_texture_id(ManagedTextureID&& texture_id, glm::u32vec2 tex_size, Type type);
@@ -117,9 +138,9 @@ public:
     /**
      * @brief Loads a texture in automatically detected format.
      *
-     * If the texture takes the whole file, tries to determine it using the
-     * file extension. If extension is invalid or missing, determines by
-     * identifiers at the start of texture file.
+     * Uses params.mime_type if it is set. Otherwise, if the texture takes the
+     * whole file, tries to determine it using the file extension. If extension
+     * is invalid or missing, determines by identifiers at the start of texture file.
      */
     [[nodiscard]] static Texture from_file(const TexLoadingParams& params);
     /**
@@ -128,6 +149,7 @@ public:
      * Does the same thing as from_file with one parameter, but with hint of the
      * additional parameter: mime_type it will determine the format much faster
      * if this texture is contained inside another file, for example, in glTF.
+     * The parameter overrides params.mime_type.
      *
      * @sa llengine::Texture::from_file(const TexLoadingParams& params)
      */
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <map> // std::map
+#include <memory> // std::shared_ptr, std::weak_ptr
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <functional> // std::function
+#include <string_view> // std::string_view
+
+#include "rendering/Texture.hpp"
+
+namespace llengine {
+class NodeProperty;
+
+/**
+ * @brief Deduplicates textures loaded from files.
+ *
+ * Textures are identified by their source (path, offset, size and MIME type)
+ * together with sampling parameters. The cache holds only weak references, so
+ * a texture is freed as soon as the last user releases it.
+ */
+class TextureCache {
+public:
+    struct Statistics {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::size_t resident_textures = 0;
+        std::size_t resident_bytes = 0;
+    };
+
+    /**
+     * @brief Returns an already loaded texture with the same parameters
+     * or loads a new one.
+     *
+     * @sa llengine::Texture::from_file(const TexLoadingParams& params)
+     */
+    [[nodiscard]] std::shared_ptr<Texture> from_file(const TexLoadingParams& params);
+    /**
+     * @brief Returns an already loaded texture with the same parameters
+     * or loads a new one, determining its format by MIME type.
+     *
+     * @sa llengine::Texture::from_file(const TexLoadingParams& params, const std::string& mime_type)
+     */
+    [[nodiscard]] std::shared_ptr<Texture> from_file(const TexLoadingParams& params, std::string_view mime_type);
+    [[nodiscard]] std::shared_ptr<Texture> from_property(const NodeProperty& property);
+    /**
+     * @brief Returns an already loaded texture with the same parameters
+     * or creates a new one by calling the loader with them.
+     */
+    [[nodiscard]] std::shared_ptr<Texture> get_or_load(
+        const TexLoadingParams& params, const std::function<Texture(const TexLoadingParams&)>& loader
+    );
+
+    /**
+     * @brief Returns counters of the cache and amount of video memory
+     * occupied by textures that are still alive.
+     */
+    [[nodiscard]] Statistics get_statistics() const;
+    void reset_counters() noexcept;
+
+private:
+    struct Entry {
+        std::weak_ptr<Texture> texture;
+        std::size_t memory_usage = 0;
+    };
+
+    static constexpr std::size_t MIN_ENTRIES_TO_SWEEP = 64;
+
+    std::map<TexLoadingParams, Entry> entries;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    // Expired entries are swept when the map grows to this size, which then
+    // becomes twice the amount of live entries, so a sweep costs amortized O(1) per insert.
+    std::size_t sweep_threshold = MIN_ENTRIES_TO_SWEEP;
+
+    [[nodiscard]] std::shared_ptr<Texture> find(const TexLoadingParams& params);
+    void insert(const TexLoadingParams& params, const std::shared_ptr<Texture>& texture);
+    void remove_expired_entries();
+};
+}
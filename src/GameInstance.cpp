@@ -5,6 +5,7 @@
 #include "rendering/RenderingServer.hpp"
 #include "physics/BulletPhysicsServer.hpp"
 #include "utils/texture_utils.hpp"
+#include "rendering/IBLCache.hpp"
 
 #include <memory>
 
@@ -13,7 +14,10 @@ using namespace llengine;
 GameInstance::GameInstance(const GameSettings& settings) {
     logger::enable_console_logging();
 
-    rendering_server = std::make_unique<RenderingServer>(settings.window_resolution, settings.window_title);
+    rendering_server = std::make_unique<RenderingServer>(
+        settings.window_resolution, settings.window_title,
+        settings.gl_version_major, settings.gl_version_minor
+    );
     rendering_server->apply_quality_settings(settings.quality_settings);
     bullet_physics_server = std::make_unique<BulletPhysicsServer>();
 
@@ -25,9 +29,22 @@ GameInstance::GameInstance(const GameSettings& settings) {
     }
 
     if (!settings.skybox_path.empty()) {
-        auto sky_panorama = Texture::from_file(settings.skybox_path);
-        auto sky_cubemap = tex_utils::panorama_to_cubemap(sky_panorama);
-        rendering_server->set_cubemap(std::make_shared<Texture>(std::move(sky_cubemap)));
+        const auto make_sky_cubemap = [&settings] () {
+            auto sky_panorama = Texture::from_file(settings.skybox_path);
+            return tex_utils::panorama_to_cubemap(sky_panorama);
+        };
+
+        if (settings.ibl_cache_path.empty()) {
+            rendering_server->set_cubemap(std::make_shared<Texture>(make_sky_cubemap()));
+        }
+        else {
+            rendering_server->get_global_lighting_environment().set_cache_directory(settings.ibl_cache_path);
+            const std::uint64_t source_hash = ibl_cache::hash_file(settings.skybox_path);
+            auto sky_cubemap = ibl_cache::load_or_compute(
+                settings.ibl_cache_path, source_hash, "panorama to cubemap", make_sky_cubemap
+            );
+            rendering_server->set_cubemap(std::make_shared<Texture>(std::move(sky_cubemap)), source_hash);
+        }
     }
 
     rendering_server->set_update_callback([&] (float delta) {
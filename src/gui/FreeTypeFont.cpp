@@ -1,4 +1,6 @@
 #include "gui/FreeTypeFont.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
 #include "NodeProperty.hpp"
 
 #include <fmt/format.h>
@@ -119,7 +121,7 @@ static Texture texture_from_freetype_bitmap(const FT_Bitmap& bitmap) {
 
     ManagedTextureID texture_id;
     glGenTextures(1, &texture_id.get_ref());
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
     glTexImage2D(
         GL_TEXTURE_2D, 0, GL_RED, tex_size.x, tex_size.y, 0,
         GL_RED, GL_UNSIGNED_BYTE, buffer.data()
@@ -0,0 +1,165 @@
+#include "math/BoundingVolumes.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace llengine;
+
+[[nodiscard]] static glm::vec3 find_farthest_point(std::span<const glm::vec3> points, const glm::vec3& from) {
+    glm::vec3 result = from;
+    float max_distance_squared = -1.0f;
+    for (const glm::vec3& point : points) {
+        const glm::vec3 difference = point - from;
+        const float distance_squared = glm::dot(difference, difference);
+        if (distance_squared > max_distance_squared) {
+            max_distance_squared = distance_squared;
+            result = point;
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] BoundingSphere BoundingSphere::from_points(std::span<const glm::vec3> points, const AABB& aabb) {
+    if (points.empty()) {
+        return {};
+    }
+
+    // Ritter's algorithm: start from two distant points, then grow to include the rest.
+    const glm::vec3 first = find_farthest_point(points, points[0]);
+    const glm::vec3 second = find_farthest_point(points, first);
+    BoundingSphere ritter {(first + second) * 0.5f, glm::distance(first, second) * 0.5f};
+    for (const glm::vec3& point : points) {
+        const float distance = glm::distance(point, ritter.center);
+        if (distance > ritter.radius) {
+            const float new_radius = (ritter.radius + distance) * 0.5f;
+            ritter.center += (point - ritter.center) * ((new_radius - ritter.radius) / distance);
+            ritter.radius = new_radius;
+        }
+    }
+
+    BoundingSphere around_aabb {(aabb.point_min + aabb.point_max) * 0.5f, 0.0f};
+    around_aabb.radius = glm::distance(find_farthest_point(points, around_aabb.center), around_aabb.center);
+
+    return ritter.radius < around_aabb.radius ? ritter : around_aabb;
+}
+
+[[nodiscard]] BoundingSphere BoundingSphere::transformed(const glm::mat4& matrix) const {
+    const float max_scale = std::max({
+        glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))
+    });
+    return {glm::vec3(matrix * glm::vec4(center, 1.0f)), radius * max_scale};
+}
+
+using Matrix3 = std::array<std::array<double, 3>, 3>;
+
+/**
+ * @brief Finds eigenvectors of the symmetric matrix with cyclic Jacobi rotations.
+ * @return Eigenvectors in rows.
+ */
+[[nodiscard]] static Matrix3 find_eigenvectors(Matrix3 matrix) {
+    Matrix3 vectors {{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}};
+
+    // A few sweeps are enough for 3x3 matrices.
+    for (std::size_t sweep = 0; sweep < 8; sweep++) {
+        for (const auto& [p, q] : {std::pair{0, 1}, {0, 2}, {1, 2}}) {
+            if (std::abs(matrix[p][q]) < 1e-12) {
+                continue;
+            }
+
+            // Rotation in the pq plane that zeroes matrix[p][q].
+            const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+            const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+            const double c = 1.0 / std::sqrt(t * t + 1.0);
+            const double s = t * c;
+
+            for (std::size_t k = 0; k < 3; k++) {
+                const double kp = matrix[k][p];
+                const double kq = matrix[k][q];
+                matrix[k][p] = c * kp - s * kq;
+                matrix[k][q] = s * kp + c * kq;
+            }
+            for (std::size_t k = 0; k < 3; k++) {
+                const double pk = matrix[p][k];
+                const double qk = matrix[q][k];
+                matrix[p][k] = c * pk - s * qk;
+                matrix[q][k] = s * pk + c * qk;
+            }
+            for (std::size_t k = 0; k < 3; k++) {
+                const double vp = vectors[p][k];
+                const double vq = vectors[q][k];
+                vectors[p][k] = c * vp - s * vq;
+                vectors[q][k] = s * vp + c * vq;
+            }
+        }
+    }
+
+    return vectors;
+}
+
+[[nodiscard]] OBB OBB::from_points(std::span<const glm::vec3> points, const AABB& aabb) {
+    const OBB aabb_box {(aabb.point_min + aabb.point_max) * 0.5f, glm::mat3(
+        glm::vec3((aabb.point_max.x - aabb.point_min.x) * 0.5f, 0.0f, 0.0f),
+        glm::vec3(0.0f, (aabb.point_max.y - aabb.point_min.y) * 0.5f, 0.0f),
+        glm::vec3(0.0f, 0.0f, (aabb.point_max.z - aabb.point_min.z) * 0.5f)
+    )};
+    if (points.size() < 3) {
+        return aabb_box;
+    }
+
+    std::array<double, 3> mean {};
+    for (const glm::vec3& point : points) {
+        for (std::size_t i = 0; i < 3; i++) {
+            mean[i] += point[i];
+        }
+    }
+    for (double& component : mean) {
+        component /= static_cast<double>(points.size());
+    }
+
+    Matrix3 covariance {};
+    for (const glm::vec3& point : points) {
+        for (std::size_t i = 0; i < 3; i++) {
+            for (std::size_t j = 0; j < 3; j++) {
+                covariance[i][j] += (point[i] - mean[i]) * (point[j] - mean[j]);
+            }
+        }
+    }
+
+    const Matrix3 eigenvectors = find_eigenvectors(covariance);
+    std::array<glm::vec3, 3> axes;
+    for (std::size_t i = 0; i < 3; i++) {
+        axes[i] = glm::normalize(glm::vec3(eigenvectors[i][0], eigenvectors[i][1], eigenvectors[i][2]));
+    }
+
+    glm::vec3 min {std::numeric_limits<float>::max()};
+    glm::vec3 max {std::numeric_limits<float>::lowest()};
+    for (const glm::vec3& point : points) {
+        for (std::size_t i = 0; i < 3; i++) {
+            const float projection = glm::dot(point, axes[i]);
+            min[i] = std::min(min[i], projection);
+            max[i] = std::max(max[i], projection);
+        }
+    }
+
+    const glm::vec3 half_extents = (max - min) * 0.5f;
+    const glm::vec3 middle = (max + min) * 0.5f;
+    const OBB pca_box {
+        axes[0] * middle.x + axes[1] * middle.y + axes[2] * middle.z,
+        glm::mat3(axes[0] * half_extents.x, axes[1] * half_extents.y, axes[2] * half_extents.z)
+    };
+
+    const glm::vec3 aabb_half_extents = (aabb.point_max - aabb.point_min) * 0.5f;
+    const float aabb_volume = aabb_half_extents.x * aabb_half_extents.y * aabb_half_extents.z;
+    const float pca_volume = half_extents.x * half_extents.y * half_extents.z;
+    return pca_volume < aabb_volume ? pca_box : aabb_box;
+}
+
+[[nodiscard]] float OBB::get_projection_radius(const glm::vec3& direction) const {
+    return std::abs(glm::dot(direction, half_axes[0])) +
+        std::abs(glm::dot(direction, half_axes[1])) +
+        std::abs(glm::dot(direction, half_axes[2]));
+}
@@ -0,0 +1,204 @@
+#include "math/SphericalHarmonics.hpp"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+using namespace llengine;
+
+// Amount of pixels processed together. Loops over lanes have constant
+// trip count and no dependencies, so compilers turn them into SIMD code.
+constexpr std::size_t LANES = 8;
+constexpr std::size_t COEFFICIENTS_COUNT = SphericalHarmonics::COEFFICIENTS_COUNT;
+
+struct FaceAxes {
+    glm::vec3 major;
+    glm::vec3 s_axis;
+    glm::vec3 t_axis;
+};
+
+// Direction to a point on a face is major + s * s_axis + t * t_axis,
+// where s and t are in [-1; 1], as in the OpenGL specification.
+constexpr std::array<FaceAxes, 6> FACE_AXES {{
+    {{ 1.0f,  0.0f,  0.0f}, { 0.0f, 0.0f, -1.0f}, {0.0f, -1.0f,  0.0f}},
+    {{-1.0f,  0.0f,  0.0f}, { 0.0f, 0.0f,  1.0f}, {0.0f, -1.0f,  0.0f}},
+    {{ 0.0f,  1.0f,  0.0f}, { 1.0f, 0.0f,  0.0f}, {0.0f,  0.0f,  1.0f}},
+    {{ 0.0f, -1.0f,  0.0f}, { 1.0f, 0.0f,  0.0f}, {0.0f,  0.0f, -1.0f}},
+    {{ 0.0f,  0.0f,  1.0f}, { 1.0f, 0.0f,  0.0f}, {0.0f, -1.0f,  0.0f}},
+    {{ 0.0f,  0.0f, -1.0f}, {-1.0f, 0.0f,  0.0f}, {0.0f, -1.0f,  0.0f}}
+}};
+
+struct PartialSums {
+    std::array<std::array<double, 3>, COEFFICIENTS_COUNT> sums {};
+    double weights_sum = 0.0;
+};
+
+static void project_row(
+    std::span<const float> row, const FaceAxes& axes, float t, std::uint32_t face_size, PartialSums& result
+) {
+    alignas(32) std::array<std::array<std::array<float, LANES>, 3>, COEFFICIENTS_COUNT> lane_sums {};
+    alignas(32) std::array<float, LANES> lane_weights {};
+
+    const float inv_face_size = 1.0f / static_cast<float>(face_size);
+    const glm::vec3 row_base = axes.major + t * axes.t_axis;
+    const float t_squared = t * t;
+
+    for (std::uint32_t first_column = 0; first_column < face_size; first_column += LANES) {
+        alignas(32) std::array<float, LANES> x, y, z, red, green, blue;
+        alignas(32) std::array<std::array<float, LANES>, COEFFICIENTS_COUNT> basis;
+
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            const std::uint32_t column = first_column + static_cast<std::uint32_t>(lane);
+            // Lanes past the end of the row repeat the last pixel with zero weight.
+            const std::uint32_t clamped_column = std::min(column, face_size - 1);
+            const float mask = column < face_size ? 1.0f : 0.0f;
+
+            const float s = (2.0f * static_cast<float>(clamped_column) + 1.0f) * inv_face_size - 1.0f;
+            const float inv_length = 1.0f / std::sqrt(1.0f + s * s + t_squared);
+            // Solid angle of a texel is proportional to this.
+            const float weight = inv_length * inv_length * inv_length * mask;
+
+            x[lane] = (row_base.x + s * axes.s_axis.x) * inv_length;
+            y[lane] = (row_base.y + s * axes.s_axis.y) * inv_length;
+            z[lane] = (row_base.z + s * axes.s_axis.z) * inv_length;
+            red[lane] = row[clamped_column * 3 + 0] * weight;
+            green[lane] = row[clamped_column * 3 + 1] * weight;
+            blue[lane] = row[clamped_column * 3 + 2] * weight;
+            lane_weights[lane] += weight;
+        }
+
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            basis[0][lane] = 0.282095f;
+            basis[1][lane] = 0.488603f * y[lane];
+            basis[2][lane] = 0.488603f * z[lane];
+            basis[3][lane] = 0.488603f * x[lane];
+            basis[4][lane] = 1.092548f * x[lane] * y[lane];
+            basis[5][lane] = 1.092548f * y[lane] * z[lane];
+            basis[6][lane] = 0.315392f * (3.0f * z[lane] * z[lane] - 1.0f);
+            basis[7][lane] = 1.092548f * x[lane] * z[lane];
+            basis[8][lane] = 0.546274f * (x[lane] * x[lane] - y[lane] * y[lane]);
+        }
+
+        for (std::size_t i = 0; i < COEFFICIENTS_COUNT; i++) {
+            for (std::size_t lane = 0; lane < LANES; lane++) {
+                lane_sums[i][0][lane] += basis[i][lane] * red[lane];
+                lane_sums[i][1][lane] += basis[i][lane] * green[lane];
+                lane_sums[i][2][lane] += basis[i][lane] * blue[lane];
+            }
+        }
+    }
+
+    // Reduce lanes in double precision to not lose small contributions of big maps.
+    for (std::size_t i = 0; i < COEFFICIENTS_COUNT; i++) {
+        for (std::size_t channel = 0; channel < 3; channel++) {
+            for (std::size_t lane = 0; lane < LANES; lane++) {
+                result.sums[i][channel] += lane_sums[i][channel][lane];
+            }
+        }
+    }
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        result.weights_sum += lane_weights[lane];
+    }
+}
+
+static PartialSums project_rows(
+    const std::array<std::span<const float>, 6>& faces, std::uint32_t face_size,
+    std::size_t first_row, std::size_t last_row
+) {
+    PartialSums result;
+
+    // Rows of all faces are enumerated one after another.
+    for (std::size_t global_row = first_row; global_row < last_row; global_row++) {
+        const std::size_t face = global_row / face_size;
+        const std::size_t row = global_row % face_size;
+        const float t = (2.0f * static_cast<float>(row) + 1.0f) / static_cast<float>(face_size) - 1.0f;
+        const std::size_t row_length = static_cast<std::size_t>(face_size) * 3;
+
+        project_row(faces[face].subspan(row * row_length, row_length), FACE_AXES[face], t, face_size, result);
+    }
+
+    return result;
+}
+
+[[nodiscard]] SphericalHarmonics SphericalHarmonics::from_cubemap(
+    const std::array<std::span<const float>, 6>& faces, std::uint32_t face_size, std::uint32_t threads_count
+) {
+    SphericalHarmonics result;
+    if (face_size == 0) {
+        return result;
+    }
+
+    for (const auto& face : faces) {
+        if (face.size() < static_cast<std::size_t>(face_size) * face_size * 3) {
+            throw std::invalid_argument("Cubemap face is smaller than specified.");
+        }
+    }
+
+    const std::size_t rows_count = static_cast<std::size_t>(face_size) * 6;
+    if (threads_count == 0) {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads_count = static_cast<std::uint32_t>(std::min<std::size_t>(threads_count, rows_count));
+
+    std::vector<PartialSums> partial_sums(threads_count);
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+    for (std::uint32_t i = 0; i < threads_count; i++) {
+        const std::size_t first_row = rows_count * i / threads_count;
+        const std::size_t last_row = rows_count * (i + 1) / threads_count;
+        auto job = [&faces, face_size, first_row, last_row, &output = partial_sums[i]] () {
+            output = project_rows(faces, face_size, first_row, last_row);
+        };
+
+        // The current thread takes the last part itself.
+        if (i + 1 == threads_count) {
+            job();
+        }
+        else {
+            threads.emplace_back(job);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    PartialSums total;
+    for (const auto& partial : partial_sums) {
+        for (std::size_t i = 0; i < COEFFICIENTS_COUNT; i++) {
+            for (std::size_t channel = 0; channel < 3; channel++) {
+                total.sums[i][channel] += partial.sums[i][channel];
+            }
+        }
+        total.weights_sum += partial.weights_sum;
+    }
+
+    // Weights are normalized so that they cover the whole sphere exactly.
+    const double normalization = 4.0 * std::numbers::pi / total.weights_sum;
+    for (std::size_t i = 0; i < COEFFICIENTS_COUNT; i++) {
+        result.coefficients[i] = glm::vec3(
+            total.sums[i][0] * normalization,
+            total.sums[i][1] * normalization,
+            total.sums[i][2] * normalization
+        );
+    }
+
+    return result;
+}
+
+[[nodiscard]] SphericalHarmonics SphericalHarmonics::radiance_to_irradiance() const {
+    // Coefficients of the clamped cosine lobe per band (PI, 2PI/3, PI/4), divided by PI.
+    constexpr std::array<float, COEFFICIENTS_COUNT> BAND_FACTORS {
+        1.0f,
+        2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+        0.25f, 0.25f, 0.25f, 0.25f, 0.25f
+    };
+
+    SphericalHarmonics result;
+    for (std::size_t i = 0; i < COEFFICIENTS_COUNT; i++) {
+        result.coefficients[i] = coefficients[i] * BAND_FACTORS[i];
+    }
+
+    return result;
+}
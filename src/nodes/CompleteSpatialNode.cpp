@@ -3,13 +3,13 @@
 using namespace llengine;
 
 CompleteSpatialNode::CompleteSpatialNode(const Transform& p) :
-    transform(p) {}
+    transform(p), cached_local_matrix(p.calculate_matrix()) {}
 
 CompleteSpatialNode::~CompleteSpatialNode() {}
 
 void CompleteSpatialNode::set_translation(const glm::vec3& new_trans) {
     transform.translation = new_trans;
-    needs_recalculation = true;
+    recalculate_matrix();
 }
 
 void CompleteSpatialNode::translate(const glm::vec3& translation) {
@@ -18,16 +18,17 @@ void CompleteSpatialNode::translate(const glm::vec3& translation) {
 
 void CompleteSpatialNode::set_scale(const glm::vec3& new_scale) {
     transform.scale = new_scale;
-    needs_recalculation = true;
+    recalculate_matrix();
 }
 
 void CompleteSpatialNode::set_rotation(const glm::quat& new_rotation) {
     transform.rotation = new_rotation;
-    needs_recalculation = true;
+    recalculate_matrix();
 }
 
 void CompleteSpatialNode::set_transform(const Transform& new_transform) {
     transform = new_transform;
+    recalculate_matrix();
 }
 
 glm::vec3 CompleteSpatialNode::get_translation() const noexcept {
@@ -91,9 +92,6 @@ Transform CompleteSpatialNode::get_global_transform() const noexcept {
 }
 
 glm::mat4 CompleteSpatialNode::get_local_matrix() const noexcept {
-    if (needs_recalculation)
-        recalculate_matrix();
-
     return cached_local_matrix;
 }
 
@@ -112,7 +110,6 @@ std::unique_ptr<Node> CompleteSpatialNode::copy() const {
     return result;
 }
 
-void CompleteSpatialNode::recalculate_matrix() const noexcept {
+void CompleteSpatialNode::recalculate_matrix() noexcept {
     cached_local_matrix = transform.calculate_matrix();
-    needs_recalculation = false;
 }
@@ -1,5 +1,6 @@
 #include "nodes/gui/GUINode.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
 #include "rendering/Mesh.hpp"
 #include "gui/GUITexture.hpp"
 #include "utils/math.hpp"
@@ -138,22 +139,11 @@ void GUINode::draw_texture_part(
     shader->set_vec2<"uv_scale">(uv_scale);
     shader->set_vec2<"uv_offset">(uv_offset);
     shader->set_vec4<"color_factor">({1.0f, 1.0f, 1.0f, 1.0f});
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture.get_id());
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture.get_id());
 
     auto mesh = Mesh::get_quad();
     mesh->bind_vao(true, false, false);
-
-    if (mesh->is_indexed()) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->get_indices_id());
-        glDrawElements(GL_TRIANGLES, mesh->get_amount_of_vertices(), mesh->get_indices_type(), 0);
-    }
-    else {
-        glBindBuffer(GL_ARRAY_BUFFER, mesh->get_vertices_id());
-        glDrawArrays(GL_TRIANGLES, 0, mesh->get_amount_of_vertices());
-    }
-
-    mesh->unbind_vao(true, false, false);
+    mesh->draw();
 }
 
 void GUINode::draw_rectangle(const GUITexture& texture) {
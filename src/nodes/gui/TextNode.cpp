@@ -1,6 +1,7 @@
 #include "nodes/gui/TextNode.hpp"
 #include "node_registration.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
 #include "utils/math.hpp"
 
 #include <glm/mat4x4.hpp>
@@ -97,9 +98,10 @@ void TextNode::set_text(std::string_view new_text) {
         offset_y -= font->get_font_size();
     }
 
-    mesh = std::make_optional<Mesh>();
-    mesh->set_vertices(vertices);
-    mesh->set_uvs(uvs);
+    if (mesh == nullptr) {
+        mesh = std::make_unique<DynamicMesh>(true, vertices.size());
+    }
+    mesh->update(vertices, uvs);
 }
 
 void TextNode::set_text_property(const NodeProperty& property) {
@@ -130,6 +132,9 @@ void TextNode::set_max_width_property(const NodeProperty& property) {
 
 void TextNode::draw() {
     draw_children();
+    if (mesh == nullptr) {
+        return;
+    }
 
     const glm::vec2 window_size {rs().get_window().get_window_size()};
     glm::vec3 absolute_position_in_pixels {get_screen_space_position()};
@@ -142,12 +147,10 @@ void TextNode::draw() {
     shader->use_shader();
     shader->set_mat4<"mvp">(mvp);
     shader->set_vec3<"text_color">(get_color());
-    glActiveTexture(GL_TEXTURE0);
-    for (std::int32_t char_i = 0; char_i < chars.size(); char_i++) {
-        glBindTexture(GL_TEXTURE_2D, chars[char_i].get().texture);
-        mesh->bind_vao(true, false, false);
-        glDrawArrays(GL_TRIANGLES, char_i * 6, 6);
-        mesh->unbind_vao(true, false, false);
+    mesh->bind_vao();
+    for (std::size_t char_i = 0; char_i < chars.size(); char_i++) {
+        rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, chars[char_i].get().texture);
+        mesh->draw(char_i * 6, 6);
     }
 }
 
@@ -339,6 +339,7 @@ glm::mat4 BulletRigidBodyNode::get_local_matrix() const noexcept {
 }
 
 glm::mat4 BulletRigidBodyNode::get_global_matrix() const noexcept {
+    std::lock_guard lock {cached_global_matrix_mutex};
     if (!cached_global_matrix.has_value()) {
         cached_global_matrix = get_global_transform().calculate_matrix();
     }
@@ -448,5 +449,6 @@ void BulletRigidBodyNode::_on_attachment_to_tree_without_start() {
 }
 
 void BulletRigidBodyNode::invalidate_transform_cache() const {
+    std::lock_guard lock {cached_global_matrix_mutex};
     cached_global_matrix = std::nullopt;
 }
\ No newline at end of file
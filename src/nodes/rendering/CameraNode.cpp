@@ -4,6 +4,9 @@
 #include "nodes/rendering/CameraNode.hpp" // CameraNode
 #include "rendering/RenderingServer.hpp" // RenderingServer
 #include "nodes/CompleteSpatialNode.hpp"
+#include "utils/WorkerPool.hpp"
+
+#include <cassert>
 
 using namespace llengine;
 
@@ -13,6 +16,7 @@ constexpr glm::vec3 FORWARD(0.0f, 0.0f, 1.0f);
 CameraNode::CameraNode() = default;
 
 [[nodiscard]] const glm::mat4& CameraNode::get_view_matrix() const {
+    assert(!WorkerPool::is_running_job());
     if (!is_cached_view_matrix_valid) {
         recompute_view_matrix();
     }
@@ -21,6 +25,7 @@ CameraNode::CameraNode() = default;
 }
 
 [[nodiscard]] const glm::mat4& CameraNode::get_proj_matrix() const {
+    assert(!WorkerPool::is_running_job());
     float current_aspect_ratio = get_aspect_ratio();
     if (current_aspect_ratio != previous_aspect_ratio) {
         invalidate_proj_matrix_cache();
@@ -36,6 +41,7 @@ CameraNode::CameraNode() = default;
 }
 
 [[nodiscard]] const glm::mat4& CameraNode::get_view_proj_matrix() const {
+    assert(!WorkerPool::is_running_job());
     if (!is_cached_view_proj_matrix_valid) {
         cached_view_proj_matrix = get_proj_matrix() * get_view_matrix();
         is_cached_view_proj_matrix_valid = true;
@@ -1,6 +1,7 @@
 #include "nodes/rendering/ExplosionParticlesNode.hpp"
 #include "nodes/rendering/CameraNode.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
 #include "rendering/Shader.hpp"
 #include "rendering/LazyShader.hpp"
 #include "random.hpp"
@@ -130,17 +131,12 @@ void ExplosionParticlesNode::draw() {
     shader->set_uint<"particles_count">(particles_count);
     shader->set_vec3<"particle_color">(particle_color);
 
-    glBindVertexArray(vao_id);
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, particle_mesh->get_indices_id());
-    glDrawElementsInstanced(
+    rs()._get_gl_state().bind_vertex_array(vao_id, 0b11u);
+    glDrawElementsInstancedBaseVertex(
         GL_TRIANGLES, particle_mesh->get_amount_of_vertices(), particle_mesh->get_indices_type(),
-        nullptr, particles_count
+        reinterpret_cast<const void*>(particle_mesh->get_indices_offset()), particles_count,
+        particle_mesh->get_base_vertex()
     );
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(0);
-    glBindVertexArray(0);
 
     phase += rs().get_delta_time() / duration;
 
@@ -211,16 +207,19 @@ static void compute_target_positions(
 }
 
 void ExplosionParticlesNode::initialize_vao() {
+    GLStateTracker& gl_state = rs()._get_gl_state();
     if (vao_id != 0) {
+        gl_state.forget_vertex_array(vao_id);
         glDeleteVertexArrays(1, &vao_id);
     }
 
     glGenVertexArrays(1, &vao_id);
-    glBindVertexArray(vao_id);
+    gl_state.bind_vertex_array(vao_id);
 
     if (particle_mesh != nullptr) {
-        glBindBuffer(GL_ARRAY_BUFFER, particle_mesh->get_vertices_id());
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, particle_mesh->get_vertex_buffer_id());
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, particle_mesh->get_vertex_layout().stride, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, particle_mesh->get_indices_id());
     }
 
     if (target_positions_buffer != 0) {
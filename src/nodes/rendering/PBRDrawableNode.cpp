@@ -1,12 +1,19 @@
 #include "rendering/RenderingServer.hpp"
 #include "nodes/rendering/PBRDrawableNode.hpp" // PBRDrawableNode
 #include "nodes/rendering/CameraNode.hpp"
-#include "math/AABB.hpp"
 #include "rendering/shaders/PBRShaderManager.hpp"
+#include "rendering/InstanceBuffer.hpp"
+#include "rendering/DrawIndirectBuffer.hpp"
+#include "rendering/ObjectLights.hpp"
+#include "rendering/UniformBlocks.hpp"
 
 #include <GL/glew.h>
+#include <glm/geometric.hpp>
 
-#include <limits>
+#include <string>
+#include <optional>
+#include <vector>
+#include <algorithm>
 
 using namespace llengine;
 
@@ -16,6 +23,9 @@ constexpr std::string_view VERTEX_SHADOW_MAPPING_SHADER_TEXT =
 constexpr std::string_view FRAGMENT_SHADOW_MAPPING_SHADER_TEXT =
     #include "shaders/misc/shadow_mapping.frag"
 ;
+constexpr std::string_view VERTEX_DEPTH_PREPASS_SHADER_TEXT =
+    #include "shaders/objects/pbr/depth_prepass.vert"
+;
 
 static PBRShaderManager pbr_shader_manager;
 
@@ -26,41 +36,222 @@ PBRDrawableNode::PBRDrawableNode(
     const std::shared_ptr<const Mesh>& mesh
 ) : DrawableCompleteSpatialNode(), mesh(mesh), material(material) {}
 
-static void draw_mesh(const Mesh& mesh) {
-    mesh.bind_vao();
+[[nodiscard]] static bool are_lights_per_object() {
+    return rs().get_quality_settings().light_assignment == LightAssignment::PER_OBJECT;
+}
 
-    if (mesh.is_indexed()) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.get_indices_id());
-        glDrawElements(GL_TRIANGLES, mesh.get_amount_of_vertices(), mesh.get_indices_type(), 0);
-    }
-    else {
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.get_vertices_id());
-        glDrawArrays(GL_TRIANGLES, 0, mesh.get_amount_of_vertices());
-    }
+[[nodiscard]] static ObjectLights::Indices select_object_lights(const Mesh& mesh, const glm::mat4& model_matrix) {
+    return rs()._get_object_lights().select(mesh.get_aabb().transformed(model_matrix));
+}
 
-    mesh.unbind_vao(true, true, true);
+static void draw_mesh(const Mesh& mesh) {
+    mesh.bind_vao();
+    mesh.draw();
 }
 
-void PBRDrawableNode::draw() {
-    // Do some checks.
+void PBRDrawableNode::check_mesh_and_material() const {
     if (material->normal_map.has_value() &&
-        (mesh->get_normals_id() == 0 || mesh->get_tangents_id() == 0)) {
+        (!mesh->has_normals() || !mesh->has_tangents())) {
         throw std::runtime_error(
             "Drawable node's material has a normal map, but "
             "its mesh doesn't have normals and/or tangents."
         );
     }
+}
+
+void PBRDrawableNode::draw() {
+    check_mesh_and_material();
 
     // Use the shader.
     const glm::mat4 model_matrix = get_global_matrix();
-    const glm::mat4 mvp = rs().get_current_camera_node().get_view_proj_matrix() * model_matrix;
-    
-    
     pbr_shader_manager.use_shader(
-        *material, mvp, model_matrix, rs().get_current_camera_node().get_global_position()
+        *material, model_matrix,
+        are_lights_per_object() ? select_object_lights(*mesh, model_matrix) : ObjectLights::no_lights()
     );
 
-    draw_mesh(*mesh);
+    mesh->bind_vao();
+    rs()._draw_mesh_culled(*mesh, model_matrix);
+}
+
+void PBRDrawableNode::draw_queued(const RenderStateChanges& changes) {
+    Drawable* const self = this;
+    draw_queued_instances(changes, {&self, 1});
+}
+
+void PBRDrawableNode::draw_queued_instances(const RenderStateChanges& changes, std::span<Drawable* const> instances) {
+    check_mesh_and_material();
+
+    // Queued drawables always use the instanced shader, all of them have the same mesh and material.
+    InstanceBuffer& instance_buffer = rs()._get_instance_buffer();
+    InstanceBuffer::Batch& batch = instance_buffer.get_batch();
+    std::vector<glm::mat4>& model_matrices = batch.model_matrices;
+    std::vector<ObjectLights::Indices>& object_lights = batch.object_lights;
+    const bool lights_per_object = are_lights_per_object();
+    for (const Drawable* instance : instances) {
+        model_matrices.push_back(static_cast<const PBRDrawableNode*>(instance)->get_global_matrix());
+        if (lights_per_object) {
+            object_lights.push_back(select_object_lights(*mesh, model_matrices.back()));
+        }
+    }
+
+    RenderStateChanges part_changes = changes;
+    for (std::size_t first = 0; first < model_matrices.size(); first += instance_buffer.get_max_instances_count()) {
+        const std::size_t count = std::min(model_matrices.size() - first, instance_buffer.get_max_instances_count());
+        const std::int32_t first_instance = instance_buffer.push(
+            {model_matrices.data() + first, count},
+            lights_per_object ? std::span(object_lights.data() + first, count) : std::span<const ObjectLights::Indices>()
+        );
+        pbr_shader_manager.use_instanced_shader(*material, first_instance, part_changes);
+
+        // The VAO is left bound for the next drawable sharing it.
+        if (part_changes.vertex_array) {
+            mesh->bind_vao();
+        }
+        part_changes = {false, false, false};
+
+        // Meshlets are culled for single objects only.
+        if (count == 1) {
+            rs()._draw_mesh_culled(*mesh, model_matrices[first]);
+        }
+        else {
+            mesh->draw_instanced(count);
+        }
+    }
+}
+
+[[nodiscard]] static std::uint32_t index_size(GraphicsAPIEnum indices_type) {
+    switch (indices_type) {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+void PBRDrawableNode::draw_queued_multi(const RenderStateChanges& changes, std::span<Drawable* const> drawables) {
+    DrawIndirectBuffer* draw_indirect_buffer = rs()._get_draw_indirect_buffer();
+    InstanceBuffer& instance_buffer = rs()._get_instance_buffer();
+    const bool meshlet_culling = rs().get_quality_settings().meshlet_culling_enabled;
+
+    const bool lights_per_object = are_lights_per_object();
+
+    InstanceBuffer::Batch& batch = instance_buffer.get_multi_draw_batch();
+    std::vector<glm::mat4>& model_matrices = batch.model_matrices;
+    std::vector<ObjectLights::Indices>& object_lights = batch.object_lights;
+    // Commands are gathered only when indirect draws are supported.
+    std::vector<DrawIndirectBuffer::Command>* const commands =
+        draw_indirect_buffer != nullptr ? &draw_indirect_buffer->get_commands_batch() : nullptr;
+
+    RenderStateChanges remaining_changes = changes;
+    const Mesh* multi_drawn_mesh = nullptr;
+    auto flush = [&]() {
+        if (commands == nullptr || commands->empty()) {
+            return;
+        }
+
+        const std::int32_t first_instance = instance_buffer.push(model_matrices, object_lights);
+        pbr_shader_manager.use_instanced_shader(*material, first_instance, remaining_changes);
+        if (remaining_changes.vertex_array) {
+            multi_drawn_mesh->bind_vao();
+        }
+        remaining_changes = {false, false, false};
+
+        const std::size_t offset = draw_indirect_buffer->push(*commands);
+        glMultiDrawElementsIndirect(
+            GL_TRIANGLES, multi_drawn_mesh->get_indices_type(), reinterpret_cast<const void*>(offset),
+            static_cast<GLsizei>(commands->size()), 0
+        );
+        model_matrices.clear();
+        object_lights.clear();
+        commands->clear();
+    };
+
+    for (std::size_t first = 0; first < drawables.size();) {
+        // Drawables with equal meshes are neighbours.
+        const auto* first_node = static_cast<const PBRDrawableNode*>(drawables[first]);
+        std::size_t count = 1;
+        while (
+            first + count < drawables.size() &&
+            static_cast<const PBRDrawableNode*>(drawables[first + count])->mesh == first_node->mesh
+        ) {
+            count++;
+        }
+        const std::span<Drawable* const> run = drawables.subspan(first, count);
+        first += count;
+
+        first_node->check_mesh_and_material();
+        const Mesh& run_mesh = *first_node->mesh;
+        // One indirect draw has one index type. Meshlets are culled for single objects only.
+        const bool multi_drawable =
+            draw_indirect_buffer != nullptr && run_mesh.is_indexed() &&
+            (multi_drawn_mesh == nullptr || run_mesh.get_indices_type() == multi_drawn_mesh->get_indices_type()) &&
+            !(count == 1 && meshlet_culling && !run_mesh.get_meshlets().empty());
+        if (!multi_drawable) {
+            drawables[first - count]->draw_queued_instances(remaining_changes, run);
+            remaining_changes = {false, false, false};
+            continue;
+        }
+        multi_drawn_mesh = &run_mesh;
+
+        for (std::size_t run_first = 0; run_first < count;) {
+            if (model_matrices.size() == instance_buffer.get_max_instances_count()) {
+                flush();
+            }
+            const std::size_t part_count = std::min(
+                count - run_first, instance_buffer.get_max_instances_count() - model_matrices.size()
+            );
+
+            commands->push_back({
+                static_cast<std::uint32_t>(run_mesh.get_amount_of_vertices()),
+                static_cast<std::uint32_t>(part_count),
+                static_cast<std::uint32_t>(run_mesh.get_indices_offset() / index_size(run_mesh.get_indices_type())),
+                static_cast<std::int32_t>(run_mesh.get_base_vertex()),
+                static_cast<std::uint32_t>(model_matrices.size())
+            });
+            for (std::size_t i = run_first; i < run_first + part_count; i++) {
+                model_matrices.push_back(static_cast<const PBRDrawableNode*>(run[i])->get_global_matrix());
+                if (lights_per_object) {
+                    object_lights.push_back(select_object_lights(run_mesh, model_matrices.back()));
+                }
+            }
+            run_first += part_count;
+        }
+    }
+    flush();
+}
+
+bool PBRDrawableNode::draw_to_depth_prepass(std::span<Drawable* const> instances) {
+    using DepthPrepassShader = Shader<"instance_data", "first_instance">;
+    static DepthPrepassShader depth_prepass_shader = [] {
+        DepthPrepassShader shader(
+            VERTEX_DEPTH_PREPASS_SHADER_TEXT, FRAGMENT_SHADOW_MAPPING_SHADER_TEXT,
+            {"TEXELS_PER_INSTANCE " + std::to_string(InstanceBuffer::TEXELS_PER_INSTANCE)}
+        );
+        const ShaderID program_id = shader.get_program_id();
+        glUniformBlockBinding(
+            program_id, glGetUniformBlockIndex(program_id, "FrameData"), uniform_blocks::FRAME_BINDING
+        );
+        return shader;
+    }();
+
+    InstanceBuffer& instance_buffer = rs()._get_instance_buffer();
+    std::vector<glm::mat4>& model_matrices = instance_buffer.get_batch().model_matrices;
+    for (const Drawable* instance : instances) {
+        model_matrices.push_back(static_cast<const PBRDrawableNode*>(instance)->get_global_matrix());
+    }
+
+    depth_prepass_shader.use_shader();
+    depth_prepass_shader.bind_buffer_texture<"instance_data">(instance_buffer.get_texture_id(), 0);
+    mesh->bind_vao();
+    for (std::size_t first = 0; first < model_matrices.size(); first += instance_buffer.get_max_instances_count()) {
+        const std::size_t count = std::min(model_matrices.size() - first, instance_buffer.get_max_instances_count());
+        depth_prepass_shader.set_int<"first_instance">(instance_buffer.push({model_matrices.data() + first, count}));
+        mesh->draw_instanced(count);
+    }
+
+    return true;
 }
 
 void PBRDrawableNode::draw_to_shadow_map() {
@@ -78,6 +269,18 @@ GLuint PBRDrawableNode::get_program_id() const {
     return pbr_shader_manager.get_program_id(*material);
 }
 
+[[nodiscard]] static float distance_to_bounds(const BoundingSphere& bounds, const glm::vec3& camera_position) {
+    return std::max(glm::distance(bounds.center, camera_position) - bounds.radius, 0.0f);
+}
+
+[[nodiscard]] RenderKeyParts PBRDrawableNode::get_render_key_parts(const glm::vec3& camera_position) const {
+    const BoundingSphere bounds = mesh->get_bounding_sphere().transformed(get_global_matrix());
+    return {
+        pbr_shader_manager.get_program_id(*material, true), material.get(), mesh->get_vao_id(), mesh.get(),
+        distance_to_bounds(bounds, camera_position)
+    };
+}
+
 void PBRDrawableNode::set_mesh(const std::shared_ptr<const Mesh>& mesh) {
     this->mesh = mesh;
 }
@@ -102,34 +305,18 @@ const Material& PBRDrawableNode::get_material() const {
     return *material;
 }
 
-[[nodiscard]] static AABB model_space_to_world_space_aabb(const AABB& model_space_aabb, const glm::mat4& model_matrix) {
-    AABB result {
-        {
-            std::numeric_limits<float>::lowest(),
-            std::numeric_limits<float>::lowest(),
-            std::numeric_limits<float>::lowest()
-        },
-        {
-            std::numeric_limits<float>::max(),
-            std::numeric_limits<float>::max(),
-            std::numeric_limits<float>::max()
-        }
-    };
-
-    for (std::uint8_t i = 0; i < 8; i++) {
-        glm::vec3 world_space_vertex = model_matrix * glm::vec4(model_space_aabb.get_vertex(i), 1.0f);
-        
-        for (std::size_t j = 0; j < 3; j++) {
-            if (result.point_max[j] < world_space_vertex[j]) {
-                result.point_max[j] = world_space_vertex[j];
-            }
-            if (result.point_min[j] > world_space_vertex[j]) {
-                result.point_min[j] = world_space_vertex[j];
-            }
-        }
+[[nodiscard]] static bool is_mesh_outside_the_frustum(
+    const Frustum& frustum, const Mesh& mesh, const glm::mat4& model_matrix, const BoundingSphere& bounds
+) {
+    // The sphere test is cheap and decides most cases, the box one is tighter.
+    switch (frustum.classify_sphere(bounds)) {
+    case Frustum::Intersection::OUTSIDE:
+        return true;
+    case Frustum::Intersection::INSIDE:
+        return false;
+    default:
+        return !frustum.is_obb_on_frustum(mesh.get_obb().transformed(model_matrix));
     }
-
-    return result;
 }
 
 [[nodiscard]] bool PBRDrawableNode::is_outside_the_frustum(const Frustum& frustum) const {
@@ -137,8 +324,33 @@ const Material& PBRDrawableNode::get_material() const {
         return false;
     }
 
-    AABB aabb = model_space_to_world_space_aabb(mesh->get_aabb(), get_global_matrix());
-    return !frustum.is_aabb_on_frustum(aabb);
+    const glm::mat4 model_matrix = get_global_matrix();
+    return is_mesh_outside_the_frustum(
+        frustum, *mesh, model_matrix, mesh->get_bounding_sphere().transformed(model_matrix)
+    );
+}
+
+[[nodiscard]] DrawPreparation PBRDrawableNode::prepare_concurrently(
+    const Frustum& frustum, const glm::vec3& camera_position, RenderKeyParts& parts
+) const {
+    if (mesh == nullptr || material == nullptr) {
+        return DrawPreparation::DEFERRED;
+    }
+    // Compiling a shader is left to the rendering thread.
+    const std::optional<ShaderID> program_id = pbr_shader_manager.find_program_id(*material, true);
+    if (!program_id.has_value()) {
+        return DrawPreparation::DEFERRED;
+    }
+
+    // The global matrix walks up the tree, so it is calculated once for both culling and the key.
+    const glm::mat4 model_matrix = get_global_matrix();
+    const BoundingSphere bounds = mesh->get_bounding_sphere().transformed(model_matrix);
+    if (is_mesh_outside_the_frustum(frustum, *mesh, model_matrix, bounds)) {
+        return DrawPreparation::CULLED;
+    }
+
+    parts = {*program_id, material.get(), mesh->get_vao_id(), mesh.get(), distance_to_bounds(bounds, camera_position)};
+    return DrawPreparation::PREPARED;
 }
 
 void PBRDrawableNode::copy_to(Node& node) const {
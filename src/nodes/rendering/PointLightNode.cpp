@@ -4,6 +4,9 @@
 #include <glm/gtc/type_ptr.hpp> // glm::value_ptr
 #include <GL/glew.h>
 
+#include <cmath>
+#include <algorithm>
+
 using namespace llengine;
 
 PointLightNode::~PointLightNode() {
@@ -12,6 +15,15 @@ PointLightNode::~PointLightNode() {
     }
 }
 
+[[nodiscard]] float PointLightNode::get_effective_range() const {
+    if (range > 0.0f) {
+        return range;
+    }
+
+    // Attenuation is inverse square.
+    return std::sqrt(std::max({color.x, color.y, color.z, 0.0f}) / LIGHT_CUTOFF);
+}
+
 void PointLightNode::_on_attachment_to_tree_without_start() {
     SpatialNode::_on_attachment_to_tree_without_start();
     rs().register_point_light(this);
@@ -22,6 +34,7 @@ void PointLightNode::copy_to(Node& node) const {
 
     PointLightNode& pl_node = dynamic_cast<PointLightNode&>(node);
     pl_node.color = color;
+    pl_node.range = range;
 }
 
 std::unique_ptr<Node> PointLightNode::copy() const {
@@ -1,6 +1,7 @@
 #include "BloomFramebuffer.hpp"
 #include "rendering/ManagedFramebufferID.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
 #include "rendering/Texture.hpp"
 
 #include <GL/glew.h>
@@ -11,7 +12,7 @@ static Texture initialize_texture(glm::u32vec2 size) {
     TextureID texture_id;
 
     glGenTextures(1, &texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
     glTexImage2D(
         GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, size.x,
         size.y, 0, GL_RGB, GL_FLOAT, nullptr
@@ -127,7 +127,6 @@ void BloomRenderer::do_blur(
     glBindFramebuffer(GL_FRAMEBUFFER, target_fb);
 
     Mesh::get_quad()->bind_vao(true, false, false);
-    glDrawArrays(GL_TRIANGLES, 0, Mesh::get_quad()->get_amount_of_vertices());
-    Mesh::get_quad()->unbind_vao(true, false, false);
+    Mesh::get_quad()->draw();
 }
 }
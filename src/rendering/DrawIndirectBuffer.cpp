@@ -0,0 +1,53 @@
+#include "DrawIndirectBuffer.hpp"
+
+#include <GL/glew.h>
+
+#include <bit>
+#include <algorithm>
+
+using namespace llengine;
+
+constexpr std::size_t INITIAL_COMMANDS_CAPACITY = 1024;
+
+static_assert(sizeof(DrawIndirectBuffer::Command) == 5 * sizeof(GLuint));
+
+DrawIndirectBuffer::DrawIndirectBuffer() {
+    glGenBuffers(1, &buffer_id);
+    allocate(INITIAL_COMMANDS_CAPACITY);
+}
+
+DrawIndirectBuffer::~DrawIndirectBuffer() {
+    glDeleteBuffers(1, &buffer_id);
+}
+
+[[nodiscard]] bool DrawIndirectBuffer::is_supported() {
+    return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+}
+
+void DrawIndirectBuffer::begin_frame() {
+    if (commands_count != 0) {
+        allocate(commands_capacity);
+    }
+}
+
+[[nodiscard]] std::size_t DrawIndirectBuffer::push(std::span<const Command> commands) {
+    if (commands_count + commands.size() > commands_capacity) {
+        // Draws issued already keep reading the orphaned storage.
+        allocate(std::bit_ceil(commands.size() * 2));
+    }
+
+    const std::size_t offset = commands_count * sizeof(Command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_id);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, commands.size_bytes(), commands.data());
+    commands_count += commands.size();
+
+    return offset;
+}
+
+void DrawIndirectBuffer::allocate(std::size_t new_commands_capacity) {
+    commands_capacity = std::max(new_commands_capacity, commands_capacity);
+    commands_count = 0;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_id);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands_capacity * sizeof(Command), nullptr, GL_STREAM_DRAW);
+}
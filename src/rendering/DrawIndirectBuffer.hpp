@@ -0,0 +1,63 @@
+#pragma once
+
+#include "datatypes.hpp"
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief Streams commands of glMultiDrawElementsIndirect to the draw indirect
+ * buffer. Like InstanceBuffer, the buffer is orphaned every frame.
+ *
+ * Requires OpenGL 4.3 or ARB_multi_draw_indirect with ARB_base_instance.
+ */
+class DrawIndirectBuffer {
+public:
+    /**
+     * @brief Layout is defined by OpenGL.
+     */
+    struct Command {
+        std::uint32_t count;
+        std::uint32_t instances_count;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        std::uint32_t base_instance;
+    };
+
+    DrawIndirectBuffer();
+    DrawIndirectBuffer(const DrawIndirectBuffer& other) = delete;
+    DrawIndirectBuffer(DrawIndirectBuffer&& other) = delete;
+    ~DrawIndirectBuffer();
+
+    DrawIndirectBuffer& operator=(const DrawIndirectBuffer& other) = delete;
+    DrawIndirectBuffer& operator=(DrawIndirectBuffer&& other) = delete;
+
+    [[nodiscard]] static bool is_supported();
+
+    void begin_frame();
+    /**
+     * @brief Writes the commands and leaves the buffer bound to GL_DRAW_INDIRECT_BUFFER.
+     * @return Offset of the first command in the buffer, in bytes.
+     */
+    [[nodiscard]] std::size_t push(std::span<const Command> commands);
+    /**
+     * @brief Returns an empty list for gathering commands before pushing them.
+     * It keeps its capacity between draws.
+     */
+    [[nodiscard]] std::vector<Command>& get_commands_batch() noexcept {
+        commands_batch.clear();
+        return commands_batch;
+    }
+
+private:
+    BufferID buffer_id = 0;
+    std::size_t commands_capacity = 0;
+    std::size_t commands_count = 0;
+    std::vector<Command> commands_batch;
+
+    void allocate(std::size_t new_commands_capacity);
+};
+}
@@ -0,0 +1,62 @@
+#include "DrawRecorder.hpp"
+#include "utils/WorkerPool.hpp"
+
+#include <algorithm>
+
+using namespace llengine;
+
+void DrawRecorder::record(
+    std::span<Drawable* const> drawables, const Frustum& frustum,
+    const glm::vec3& camera_position, WorkerPool* pool
+) {
+    this->frustum = frustum;
+    this->camera_position = camera_position;
+
+    tasks_count = 1;
+    if (pool != nullptr) {
+        tasks_count = std::clamp<std::size_t>(
+            drawables.size() / MIN_DRAWABLES_PER_TASK, 1, pool->get_threads_count()
+        );
+    }
+    if (lists.size() < tasks_count) {
+        lists.resize(tasks_count);
+    }
+    for (std::vector<Draw>& list : lists) {
+        list.clear();
+    }
+
+    const auto record_task = [&] (std::size_t task) {
+        const std::size_t first = drawables.size() * task / tasks_count;
+        const std::size_t last = drawables.size() * (task + 1) / tasks_count;
+        record_range(drawables.subspan(first, last - first), frustum, camera_position, lists[task]);
+    };
+    if (tasks_count == 1) {
+        record_task(0);
+    }
+    else {
+        pool->run(tasks_count, record_task);
+    }
+}
+
+void DrawRecorder::record_range(
+    std::span<Drawable* const> drawables, const Frustum& frustum,
+    const glm::vec3& camera_position, std::vector<Draw>& list
+) {
+    for (Drawable* drawable : drawables) {
+        if (!drawable->is_enabled()) {
+            continue;
+        }
+
+        RenderKeyParts parts;
+        switch (drawable->prepare_concurrently(frustum, camera_position, parts)) {
+        case DrawPreparation::CULLED:
+            break;
+        case DrawPreparation::PREPARED:
+            list.push_back({drawable, parts, false});
+            break;
+        case DrawPreparation::DEFERRED:
+            list.push_back({drawable, {}, true});
+            break;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "nodes/rendering/Drawable.hpp"
+#include "math/Frustum.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <span>
+#include <vector>
+#include <cstddef>
+
+namespace llengine {
+class WorkerPool;
+
+/**
+ * @brief Culls drawables and computes their render key parts on worker threads.
+ *
+ * Drawables are split into contiguous ranges, every task records the visible
+ * drawables of its range into its own list, so no synchronization is needed
+ * while recording. The rendering thread then replays the lists in order, which
+ * keeps the order of drawables the same as without threads. Drawables whose
+ * preparation is deferred are prepared during the replay.
+ *
+ * Only the CPU work before the render queue is recorded, not graphics API
+ * commands. Programs, material blocks and instanced or multi-draw batches
+ * are known only after the queue is sorted, and uniform ring buffer writes
+ * are not thread-safe, so all the GL calls stay on the rendering thread.
+ */
+class DrawRecorder {
+public:
+    struct Draw {
+        Drawable* drawable;
+        RenderKeyParts parts;
+        // Whether culling and the key parts are left to the replay.
+        bool deferred;
+    };
+
+    // With less drawables per task, waking the workers costs more than it saves.
+    static constexpr std::size_t MIN_DRAWABLES_PER_TASK = 256;
+
+    /**
+     * @param pool Null to record on the calling thread only.
+     */
+    void record(
+        std::span<Drawable* const> drawables, const Frustum& frustum,
+        const glm::vec3& camera_position, WorkerPool* pool
+    );
+
+    /**
+     * @brief Calls function(drawable, parts) for every recorded visible drawable
+     * in the order of the recorded span. Must be called on the rendering thread.
+     */
+    template<typename Function>
+    void replay(Function&& function) const {
+        for (const std::vector<Draw>& list : lists) {
+            for (const Draw& draw : list) {
+                if (!draw.deferred) {
+                    function(*draw.drawable, draw.parts);
+                }
+                else if (!draw.drawable->is_outside_the_frustum(frustum)) {
+                    function(*draw.drawable, draw.drawable->get_render_key_parts(camera_position));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Amount of lists the last recording was split into.
+     */
+    [[nodiscard]] std::size_t get_tasks_count() const noexcept {
+        return tasks_count;
+    }
+
+private:
+    // Lists beyond tasks_count are empty and kept only for their capacity.
+    std::vector<std::vector<Draw>> lists;
+    std::size_t tasks_count = 0;
+    Frustum frustum {};
+    glm::vec3 camera_position {};
+
+    static void record_range(
+        std::span<Drawable* const> drawables, const Frustum& frustum,
+        const glm::vec3& camera_position, std::vector<Draw>& list
+    );
+};
+}
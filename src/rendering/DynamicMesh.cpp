@@ -0,0 +1,168 @@
+#include "rendering/DynamicMesh.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
+
+#include <GL/glew.h>
+
+#include <bit>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+using namespace llengine;
+
+constexpr GLbitfield PERSISTENT_MAPPING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+DynamicMesh::DynamicMesh(bool with_uvs, std::size_t vertices_capacity) : with_uvs(with_uvs) {
+    glGenVertexArrays(1, &vao_id);
+    allocate_buffer(std::max<std::size_t>(vertices_capacity, 1));
+}
+
+DynamicMesh::~DynamicMesh() {
+    delete_buffer();
+    if (auto rendering_server = rs_opt()) {
+        rendering_server->_get_gl_state().forget_vertex_array(vao_id);
+    }
+    glDeleteVertexArrays(1, &vao_id);
+}
+
+void DynamicMesh::update(std::span<const glm::vec3> vertices, std::span<const glm::vec2> uvs) {
+    if (with_uvs ? uvs.size() != vertices.size() : !uvs.empty()) {
+        throw std::runtime_error("Can't update dynamic mesh: unequal amounts of components.");
+    }
+
+    // Draws of the current data are issued already, so the fence goes after them.
+    if (current_region_drawn) {
+        fences[current_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        current_region_drawn = false;
+    }
+
+    if (vertices.size() > vertices_capacity) {
+        allocate_buffer(std::bit_ceil(vertices.size()));
+        current_region = 0;
+    }
+    else {
+        current_region = (current_region + 1) % FRAMES_COUNT;
+    }
+    vertices_count = vertices.size();
+    if (vertices.empty()) {
+        return;
+    }
+
+    const std::size_t stride = get_stride();
+    const std::size_t region_offset = current_region * vertices_capacity * stride;
+    std::byte* data = nullptr;
+    if (persistent_data != nullptr) {
+        static_cast<void>(wait_for_region(current_region, true));
+        data = persistent_data + region_offset;
+    }
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
+        GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        if (!wait_for_region(current_region, false)) {
+            // The GPU is too far behind. Orphan the buffer instead of waiting for it.
+            glBufferData(GL_ARRAY_BUFFER, FRAMES_COUNT * vertices_capacity * stride, nullptr, GL_STREAM_DRAW);
+            for (void*& fence : fences) {
+                if (fence != nullptr) {
+                    glDeleteSync(static_cast<GLsync>(fence));
+                    fence = nullptr;
+                }
+            }
+        }
+        data = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, region_offset, vertices.size() * stride, access));
+    }
+
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        std::memcpy(data + i * stride, &vertices[i], sizeof(glm::vec3));
+        if (with_uvs) {
+            std::memcpy(data + i * stride + sizeof(glm::vec3), &uvs[i], sizeof(glm::vec2));
+        }
+    }
+
+    if (persistent_data == nullptr) {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+}
+
+void DynamicMesh::bind_vao() const {
+    rs()._get_gl_state().bind_vertex_array(vao_id, with_uvs ? 0b11u : 0b01u);
+}
+
+void DynamicMesh::draw(std::size_t first, std::size_t count) const {
+    glDrawArrays(
+        GL_TRIANGLES, static_cast<GLint>(current_region * vertices_capacity + first),
+        static_cast<GLsizei>(count)
+    );
+    current_region_drawn = true;
+}
+
+void DynamicMesh::draw() const {
+    draw(0, vertices_count);
+}
+
+[[nodiscard]] std::size_t DynamicMesh::get_stride() const {
+    return with_uvs ? sizeof(glm::vec3) + sizeof(glm::vec2) : sizeof(glm::vec3);
+}
+
+void DynamicMesh::allocate_buffer(std::size_t new_vertices_capacity) {
+    delete_buffer();
+    vertices_capacity = new_vertices_capacity;
+
+    const std::size_t stride = get_stride();
+    const std::size_t size = FRAMES_COUNT * vertices_capacity * stride;
+
+    rs()._get_gl_state().bind_vertex_array(vao_id);
+    glGenBuffers(1, &buffer_id);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
+    if (GLEW_ARB_buffer_storage) {
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, PERSISTENT_MAPPING_FLAGS);
+        persistent_data = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, PERSISTENT_MAPPING_FLAGS));
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr);
+    if (with_uvs) {
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(sizeof(glm::vec3)));
+    }
+}
+
+void DynamicMesh::delete_buffer() {
+    for (void*& fence : fences) {
+        if (fence != nullptr) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    current_region_drawn = false;
+
+    if (buffer_id == 0) {
+        return;
+    }
+    if (persistent_data != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        persistent_data = nullptr;
+    }
+    glDeleteBuffers(1, &buffer_id);
+    buffer_id = 0;
+}
+
+[[nodiscard]] bool DynamicMesh::wait_for_region(std::size_t region, bool block) {
+    if (fences[region] == nullptr) {
+        return true;
+    }
+
+    const GLsync fence = static_cast<GLsync>(fences[region]);
+    const GLuint64 timeout = block ? std::numeric_limits<GLuint64>::max() : 0;
+    const GLenum result = glClientWaitSync(fence, block ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+
+    glDeleteSync(fence);
+    fences[region] = nullptr;
+    return true;
+}
@@ -1,4 +1,6 @@
 #include "ExposureController.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
 #include "rendering/ManagedFramebufferID.hpp"
 #include "rendering/Mesh.hpp"
 #include "rendering/Shader.hpp"
@@ -17,7 +19,7 @@ static std::uint32_t calculate_last_mipmap(glm::u32vec2 size) {
 static Texture initialize_color_attachment(glm::u32vec2 size) {
     ManagedTextureID texture_id;
     glGenTextures(1, &texture_id.get_ref());
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
 
     glTexStorage2D(
         GL_TEXTURE_2D,
@@ -72,12 +74,12 @@ void ExposureController::render_to_luminance_fb(const Texture& main_color_textur
     glBindFramebuffer(GL_FRAMEBUFFER, luminance_framebuffer);
 
     Mesh::get_quad()->bind_vao(true, false, false);
-    glDrawArrays(GL_TRIANGLES, 0, Mesh::get_quad()->get_amount_of_vertices());
-    Mesh::get_quad()->unbind_vao(true, false, false);
+    Mesh::get_quad()->draw();
 }
 
 float ExposureController::extract_average_luminance() const {
-    glBindTexture(GL_TEXTURE_2D, luminance_attachment);
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, luminance_attachment);
     glGenerateMipmap(GL_TEXTURE_2D);
 
     glm::vec4 result;
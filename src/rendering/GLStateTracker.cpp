@@ -0,0 +1,186 @@
+#include "GLStateTracker.hpp"
+
+#include <GL/glew.h>
+
+using namespace llengine;
+
+constexpr std::uint32_t MAX_TRACKED_VERTEX_ATTRIBUTES = 16;
+
+[[nodiscard]] static std::optional<std::size_t> tracked_target_index(GraphicsAPIEnum target) {
+    switch (target) {
+    case GL_TEXTURE_1D:
+        return 0;
+    case GL_TEXTURE_2D:
+        return 1;
+    case GL_TEXTURE_CUBE_MAP:
+        return 2;
+    case GL_TEXTURE_BUFFER:
+        return 3;
+    default:
+        return std::nullopt;
+    }
+}
+
+GLStateTracker::GLStateTracker() {
+    GLint units_count = 0;
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units_count);
+    texture_units.resize(static_cast<std::size_t>(units_count));
+}
+
+void GLStateTracker::invalidate() {
+    // Vertex attribute arrays are kept, they belong to VAOs which are modified only by the engine.
+    program_id = std::nullopt;
+    vao_id = std::nullopt;
+    active_texture_unit = std::nullopt;
+    for (TextureUnit& unit : texture_units) {
+        unit = {};
+    }
+
+    blending = std::nullopt;
+    blend_func = std::nullopt;
+    depth_test = std::nullopt;
+    depth_mask = std::nullopt;
+    depth_func = std::nullopt;
+    face_culling = std::nullopt;
+    cull_face = std::nullopt;
+}
+
+void GLStateTracker::use_program(ShaderID program_id) {
+    if (change(this->program_id, program_id, skipped_calls.program)) {
+        glUseProgram(program_id);
+    }
+}
+
+void GLStateTracker::bind_vertex_array(VertexArrayID vao_id) {
+    if (change(this->vao_id, vao_id, skipped_calls.vertex_array)) {
+        glBindVertexArray(vao_id);
+    }
+}
+
+void GLStateTracker::bind_vertex_array(VertexArrayID vao_id, std::uint32_t enabled_attributes) {
+    bind_vertex_array(vao_id);
+
+    // Arrays of new VAOs are disabled.
+    std::uint32_t& current_attributes = vao_enabled_attributes[vao_id];
+    for (std::uint32_t attribute = 0; attribute < MAX_TRACKED_VERTEX_ATTRIBUTES; attribute++) {
+        const std::uint32_t bit = 1u << attribute;
+        if ((current_attributes & bit) == (enabled_attributes & bit)) {
+            // Count only the enables, disabling was never issued for unused arrays.
+            if (enabled_attributes & bit) {
+                skipped_calls.vertex_array++;
+            }
+        }
+        else if (enabled_attributes & bit) {
+            glEnableVertexAttribArray(attribute);
+        }
+        else {
+            glDisableVertexAttribArray(attribute);
+        }
+    }
+    current_attributes = enabled_attributes;
+}
+
+void GLStateTracker::forget_vertex_array(VertexArrayID vao_id) {
+    // A deleted VAO is unbound.
+    if (this->vao_id == vao_id) {
+        this->vao_id = 0;
+    }
+    vao_enabled_attributes.erase(vao_id);
+}
+
+void GLStateTracker::bind_texture(std::uint32_t unit, GraphicsAPIEnum target, TextureID texture_id) {
+    // The unit is made active even when the texture is already bound there,
+    // because callers edit and query the texture through the active unit.
+    if (change(active_texture_unit, unit, skipped_calls.texture)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    const std::optional<std::size_t> target_index = tracked_target_index(target);
+    if (
+        target_index.has_value() && unit < texture_units.size() &&
+        !change(texture_units[unit].textures[*target_index], texture_id, skipped_calls.texture)
+    ) {
+        return;
+    }
+
+    glBindTexture(target, texture_id);
+}
+
+void GLStateTracker::forget_texture(TextureID texture_id) {
+    // A deleted texture is unbound from all the units.
+    for (TextureUnit& unit : texture_units) {
+        for (std::optional<TextureID>& bound_texture : unit.textures) {
+            if (bound_texture == texture_id) {
+                bound_texture = 0;
+            }
+        }
+    }
+}
+
+void GLStateTracker::bind_sampler(std::uint32_t unit, SamplerID sampler_id) {
+    if (unit < texture_units.size() && !change(texture_units[unit].sampler, sampler_id, skipped_calls.sampler)) {
+        return;
+    }
+
+    glBindSampler(unit, sampler_id);
+}
+
+void GLStateTracker::set_blending(bool enabled) {
+    set_capability(blending, GL_BLEND, enabled);
+}
+
+void GLStateTracker::set_blend_func(GraphicsAPIEnum source_factor, GraphicsAPIEnum destination_factor) {
+    if (change(blend_func, {source_factor, destination_factor}, skipped_calls.render_state)) {
+        glBlendFunc(source_factor, destination_factor);
+    }
+}
+
+void GLStateTracker::set_depth_test(bool enabled) {
+    set_capability(depth_test, GL_DEPTH_TEST, enabled);
+}
+
+void GLStateTracker::set_depth_mask(bool enabled) {
+    if (change(depth_mask, enabled, skipped_calls.render_state)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLStateTracker::set_depth_func(GraphicsAPIEnum func) {
+    if (change(depth_func, func, skipped_calls.render_state)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLStateTracker::set_face_culling(bool enabled) {
+    set_capability(face_culling, GL_CULL_FACE, enabled);
+}
+
+void GLStateTracker::set_cull_face(GraphicsAPIEnum mode) {
+    if (change(cull_face, mode, skipped_calls.render_state)) {
+        glCullFace(mode);
+    }
+}
+
+void GLStateTracker::set_capability(std::optional<bool>& current, GraphicsAPIEnum capability, bool enabled) {
+    if (!change(current, enabled, skipped_calls.render_state)) {
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    }
+    else {
+        glDisable(capability);
+    }
+}
+
+template<typename T>
+[[nodiscard]] bool GLStateTracker::change(std::optional<T>& current, const T& value, std::size_t& skipped_counter) {
+    if (current == value) {
+        skipped_counter++;
+        return false;
+    }
+
+    current = value;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "datatypes.hpp"
+#include "rendering/RenderStatistics.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace llengine {
+/**
+ * @brief Shadow copy of the OpenGL state that skips calls which wouldn't change it.
+ *
+ * The tracked state must be changed only through the tracker, otherwise the copy
+ * goes out of sync. Code that changes it directly must call invalidate afterwards.
+ * Until a value is set through the tracker it is unknown and the first call
+ * is always issued.
+ */
+class GLStateTracker {
+public:
+    GLStateTracker();
+
+    /**
+     * @brief Forgets all the state, so the next calls are issued unconditionally.
+     */
+    void invalidate();
+
+    void use_program(ShaderID program_id);
+
+    /**
+     * @brief Binds the VAO, leaving its vertex attribute arrays as they are.
+     */
+    void bind_vertex_array(VertexArrayID vao_id);
+    /**
+     * @brief Binds the VAO and enables exactly the vertex attribute arrays
+     * whose bits are set in the mask. Arrays are the state of the VAO, so
+     * they are remembered for every VAO separately.
+     */
+    void bind_vertex_array(VertexArrayID vao_id, std::uint32_t enabled_attributes);
+    /**
+     * @brief Must be called when the VAO is deleted, as its ID may be reused.
+     */
+    void forget_vertex_array(VertexArrayID vao_id);
+
+    /**
+     * @brief Binds the texture to the target of the texture unit and makes the unit
+     * active, so the texture can be edited or queried right after the call.
+     * Only the bind itself is skipped if the texture is already bound there.
+     */
+    void bind_texture(std::uint32_t unit, GraphicsAPIEnum target, TextureID texture_id);
+    /**
+     * @brief Must be called when the texture is deleted, as its ID may be reused.
+     */
+    void forget_texture(TextureID texture_id);
+    void bind_sampler(std::uint32_t unit, SamplerID sampler_id);
+
+    void set_blending(bool enabled);
+    void set_blend_func(GraphicsAPIEnum source_factor, GraphicsAPIEnum destination_factor);
+    void set_depth_test(bool enabled);
+    void set_depth_mask(bool enabled);
+    void set_depth_func(GraphicsAPIEnum func);
+    void set_face_culling(bool enabled);
+    void set_cull_face(GraphicsAPIEnum mode);
+
+    [[nodiscard]] const SkippedStateCalls& get_skipped_calls() const noexcept {
+        return skipped_calls;
+    }
+    void reset_skipped_calls() noexcept {
+        skipped_calls = {};
+    }
+
+private:
+    // 1D, 2D, cubemap and buffer textures. Binds to other targets aren't tracked.
+    static constexpr std::size_t TRACKED_TARGETS_COUNT = 4;
+
+    struct TextureUnit {
+        std::array<std::optional<TextureID>, TRACKED_TARGETS_COUNT> textures;
+        std::optional<SamplerID> sampler;
+    };
+
+    std::optional<ShaderID> program_id;
+    std::optional<VertexArrayID> vao_id;
+    // Masks of enabled vertex attribute arrays of VAOs.
+    std::unordered_map<VertexArrayID, std::uint32_t> vao_enabled_attributes;
+    std::optional<std::uint32_t> active_texture_unit;
+    std::vector<TextureUnit> texture_units;
+
+    std::optional<bool> blending;
+    std::optional<std::array<GraphicsAPIEnum, 2>> blend_func;
+    std::optional<bool> depth_test;
+    std::optional<bool> depth_mask;
+    std::optional<GraphicsAPIEnum> depth_func;
+    std::optional<bool> face_culling;
+    std::optional<GraphicsAPIEnum> cull_face;
+
+    SkippedStateCalls skipped_calls;
+
+    void set_capability(std::optional<bool>& current, GraphicsAPIEnum capability, bool enabled);
+    template<typename T>
+    [[nodiscard]] bool change(std::optional<T>& current, const T& value, std::size_t& skipped_counter);
+};
+}
@@ -10,6 +10,7 @@
 #include <GL/glew.h>
 #include "GLTF.hpp"
 #include "logger.hpp"
+#include "rendering/Mesh.hpp"
 #include "utils/json_conversion.hpp"
 
 using namespace llengine;
@@ -128,6 +129,7 @@ static void construct_texture_params(GLTF& gltf, const json& gltf_json,
         else {
             throw std::runtime_error("glTF image doesn't have URI or buffer view.");
         }
+        result.mime_type = get_optional<std::string>(image_json, "mimeType", "");
 
         gltf.textures.push_back(result);
     }
@@ -476,6 +478,10 @@ static void construct_mesh_params(GLTF& gltf, const json& gltf_json, std::string
         gltf_json, gltf_path, bin_chunk_offset, stream_pool
     };
 
+    // For the report about 32-bit indices narrowed to 16 bits.
+    std::size_t narrowed_meshes_count = 0;
+    std::size_t saved_bytes = 0;
+
     gltf.meshes.reserve(gltf_json["meshes"].size());
     for (const json& mesh_json : gltf_json["meshes"]) {
         GLTF::MeshParameters result;
@@ -539,10 +545,19 @@ static void construct_mesh_params(GLTF& gltf, const json& gltf_json, std::string
                     args, accessor_json
                 );
                 break;
-            case GL_UNSIGNED_INT:
-                result.indices = read_from_accessor<uint32_t>(
-                    args, accessor_json
-                );
+            case GL_UNSIGNED_INT: {
+                auto indices = read_from_accessor<uint32_t>(args, accessor_json);
+                auto narrowed_indices = Mesh::narrow_indices(indices);
+                if (narrowed_indices.has_value()) {
+                    narrowed_meshes_count++;
+                    saved_bytes += indices.size() * (sizeof(uint32_t) - sizeof(uint16_t));
+                    result.indices = std::move(*narrowed_indices);
+                }
+                else {
+                    result.indices = std::move(indices);
+                }
+                break;
+            }
             default:
                 throw std::runtime_error("Invalid accessor component type for indices.");
             }
@@ -550,6 +565,13 @@ static void construct_mesh_params(GLTF& gltf, const json& gltf_json, std::string
 
         gltf.meshes.push_back(result);
     }
+
+    if (narrowed_meshes_count != 0) {
+        logger::info(fmt::format(
+            "Indices of {} meshes in \"{}\" were narrowed to 16 bits, saving {} bytes.",
+            narrowed_meshes_count, gltf_path, saved_bytes
+        ));
+    }
 }
 
 GLTF::Node::Node(
@@ -2,6 +2,7 @@
 #include "node_cast.hpp"
 #include "node_registration.hpp"
 #include "rendering/Mesh.hpp"
+#include "rendering/RenderingServer.hpp"
 #include "physics/shapes/Shape.hpp"
 #include "physics/shapes/BoxShape.hpp"
 #include "physics/shapes/SphereShape.hpp"
@@ -193,6 +194,9 @@ static std::unique_ptr<SpatialNode> to_node(
     }
 }
 
+// Smaller meshes are cheaper to draw whole than to cull by parts.
+constexpr std::size_t MESHLETS_MIN_TRIANGLES = 4096;
+
 static std::shared_ptr<Mesh> construct_mesh(const GLTF::MeshParameters& mesh_params) {
     std::shared_ptr<Mesh> result = std::make_shared<Mesh>();
 
@@ -217,6 +221,14 @@ static std::shared_ptr<Mesh> construct_mesh(const GLTF::MeshParameters& mesh_par
         result->set_tangents(*mesh_params.tangents);
     }
 
+    if (result->get_amount_of_vertices() / 3 >= MESHLETS_MIN_TRIANGLES) {
+        result->build_meshlets();
+    }
+
+    if (rs().get_quality_settings().release_mesh_data_after_upload) {
+        result->set_residency(Mesh::Residency::GPU_WITH_POSITIONS);
+    }
+
     return result;
 }
 
@@ -294,7 +306,7 @@ static std::shared_ptr<Material> construct_material(const BasicMaterial<uint32_t
     std::vector<std::shared_ptr<Texture>> textures;
     textures.reserve(this->textures.size());
     for (auto& cur_tex_params : this->textures) {
-        textures.emplace_back(std::make_shared<Texture>(std::move(Texture::from_file(cur_tex_params))));
+        textures.emplace_back(rs().get_texture_cache().from_file(cur_tex_params));
     }
 
     // Construct materials.
@@ -0,0 +1,99 @@
+#include "IBLCache.hpp"
+#include "logger.hpp"
+
+#include <GL/glew.h>
+#include <fmt/format.h>
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+namespace llengine::ibl_cache {
+constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+constexpr std::uint64_t FNV_PRIME = 0x100000001b3;
+
+// Increment when the way cached textures are computed changes.
+constexpr std::uint32_t CACHE_FORMAT_VERSION = 1;
+
+static std::uint64_t fnv1a(std::uint64_t hash, const std::uint8_t* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+[[nodiscard]] std::uint64_t hash_file(const std::string& file_path) {
+    std::ifstream stream(file_path, std::ios::in | std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error(fmt::format("Failed to open file \"{}\" for hashing.", file_path));
+    }
+
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    std::array<std::uint8_t, 64 * 1024> buffer;
+    while (stream) {
+        stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        hash = fnv1a(hash, buffer.data(), static_cast<std::size_t>(stream.gcount()));
+    }
+
+    if (!stream.eof()) {
+        throw std::runtime_error(fmt::format("Failed to read file \"{}\" for hashing.", file_path));
+    }
+
+    return hash;
+}
+
+[[nodiscard]] Texture load_or_compute(
+    const std::filesystem::path& directory,
+    std::uint64_t source_hash,
+    std::string_view parameters,
+    const std::function<Texture()>& compute
+) {
+    const std::string key_string {fmt::format("{:016x} {} v{}", source_hash, parameters, CACHE_FORMAT_VERSION)};
+    const std::uint64_t key = fnv1a(
+        FNV_OFFSET_BASIS, reinterpret_cast<const std::uint8_t*>(key_string.data()), key_string.size()
+    );
+    const std::filesystem::path file_path {directory / fmt::format("{:016x}.ktx2", key)};
+
+    std::error_code error_code;
+    if (std::filesystem::exists(file_path, error_code)) {
+        TexLoadingParams params;
+        params.file_path = file_path.string();
+        params.magnification_filter = GL_LINEAR;
+        params.minification_filter = GL_LINEAR;
+        params.wrap_s = GL_CLAMP_TO_EDGE;
+        params.wrap_t = GL_CLAMP_TO_EDGE;
+
+        try {
+            return Texture::from_file(params);
+        }
+        catch (const std::exception& exception) {
+            logger::warning(fmt::format(
+                "Failed to load cached IBL texture \"{}\", computing it again: {}",
+                params.file_path, exception.what()
+            ));
+        }
+        catch (...) {
+            // TextureLoadingError doesn't expose std::exception publicly.
+            logger::warning(fmt::format(
+                "Failed to load cached IBL texture \"{}\", computing it again.", params.file_path
+            ));
+        }
+    }
+
+    Texture result {compute()};
+
+    try {
+        std::filesystem::create_directories(directory);
+        result.save_to_ktx2(file_path.string());
+    }
+    catch (const std::exception& exception) {
+        logger::warning(fmt::format(
+            "Failed to save IBL texture to cache \"{}\": {}", file_path.string(), exception.what()
+        ));
+    }
+
+    return result;
+}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "rendering/Texture.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+
+// On-disk cache of textures precomputed for image-based lighting. Textures are
+// stored as KTX2 files named after a hash of the source image and parameters.
+namespace llengine::ibl_cache {
+/**
+ * @brief Computes FNV-1a hash of the whole file contents.
+ *
+ * Throws std::runtime_error if the file can't be read.
+ */
+[[nodiscard]] std::uint64_t hash_file(const std::string& file_path);
+
+/**
+ * @brief Loads texture from the cache or computes it and saves to the cache.
+ *
+ * Failures of the cache are not fatal: they are logged and the texture
+ * is computed as if there were no cache.
+ * @param directory cache directory. Created if it doesn't exist.
+ * @param source_hash hash of the source image.
+ * @param parameters description of everything else the result depends on.
+ * @param compute function that computes the texture on cache miss.
+ */
+[[nodiscard]] Texture load_or_compute(
+    const std::filesystem::path& directory,
+    std::uint64_t source_hash,
+    std::string_view parameters,
+    const std::function<Texture()>& compute
+);
+}
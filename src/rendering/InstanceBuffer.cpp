@@ -0,0 +1,111 @@
+#include "InstanceBuffer.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
+
+#include <GL/glew.h>
+#include <glm/matrix.hpp>
+
+#include <bit>
+#include <vector>
+#include <numeric>
+#include <cassert>
+#include <algorithm>
+
+using namespace llengine;
+
+constexpr std::size_t INITIAL_INSTANCES_CAPACITY = 1024;
+
+InstanceBuffer::InstanceBuffer() {
+    GLint max_texels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+    max_instances_count = std::min(static_cast<std::size_t>(max_texels) / TEXELS_PER_INSTANCE, INSTANCE_INDICES_COUNT);
+
+    std::vector<std::uint32_t> instance_indices(INSTANCE_INDICES_COUNT);
+    std::iota(instance_indices.begin(), instance_indices.end(), 0u);
+    glGenBuffers(1, &indices_buffer_id);
+    glBindBuffer(GL_ARRAY_BUFFER, indices_buffer_id);
+    glBufferData(
+        GL_ARRAY_BUFFER, instance_indices.size() * sizeof(std::uint32_t),
+        instance_indices.data(), GL_STATIC_DRAW
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &buffer_id);
+    glGenTextures(1, &texture_id);
+    allocate(std::min(INITIAL_INSTANCES_CAPACITY, max_instances_count));
+
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_BUFFER, texture_id);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer_id);
+}
+
+InstanceBuffer::~InstanceBuffer() {
+    if (auto rendering_server = rs_opt()) {
+        rendering_server->_get_gl_state().forget_texture(texture_id);
+    }
+    glDeleteTextures(1, &texture_id);
+    glDeleteBuffers(1, &buffer_id);
+    glDeleteBuffers(1, &indices_buffer_id);
+}
+
+void InstanceBuffer::begin_frame() {
+    if (instances_count != 0) {
+        allocate(instances_capacity);
+    }
+}
+
+[[nodiscard]] std::int32_t InstanceBuffer::push(
+    std::span<const glm::mat4> model_matrices, std::span<const ObjectLights::Indices> object_lights
+) {
+    assert(model_matrices.size() <= max_instances_count);
+    assert(object_lights.empty() || object_lights.size() == model_matrices.size());
+
+    if (instances_count + model_matrices.size() > instances_capacity) {
+        // Draws issued already keep reading the orphaned storage.
+        allocate(std::min(std::bit_ceil(model_matrices.size() * 2), max_instances_count));
+    }
+
+    texels.resize(model_matrices.size() * TEXELS_PER_INSTANCE);
+    for (std::size_t i = 0; i < model_matrices.size(); i++) {
+        const glm::mat4& model_matrix = model_matrices[i];
+        const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
+
+        glm::vec4* instance_texels = &texels[i * TEXELS_PER_INSTANCE];
+        for (int column = 0; column < 4; column++) {
+            instance_texels[column] = model_matrix[column];
+        }
+        for (int column = 0; column < 3; column++) {
+            instance_texels[4 + column] = glm::vec4(normal_matrix[column], 0.0f);
+        }
+
+        // Indices are small enough to be exact in floats.
+        const ObjectLights::Indices lights = object_lights.empty() ? ObjectLights::no_lights() : object_lights[i];
+        for (std::size_t texel = 0; texel < 2; texel++) {
+            instance_texels[7 + texel] = glm::vec4(
+                lights[texel * 4], lights[texel * 4 + 1], lights[texel * 4 + 2], lights[texel * 4 + 3]
+            );
+        }
+    }
+
+    const std::size_t first_instance = instances_count;
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_id);
+    glBufferSubData(
+        GL_TEXTURE_BUFFER, first_instance * TEXELS_PER_INSTANCE * sizeof(glm::vec4),
+        texels.size() * sizeof(glm::vec4), texels.data()
+    );
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    instances_count += model_matrices.size();
+
+    return static_cast<std::int32_t>(first_instance);
+}
+
+void InstanceBuffer::allocate(std::size_t new_instances_capacity) {
+    instances_capacity = std::max(new_instances_capacity, instances_capacity);
+    instances_count = 0;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_id);
+    glBufferData(
+        GL_TEXTURE_BUFFER, instances_capacity * TEXELS_PER_INSTANCE * sizeof(glm::vec4),
+        nullptr, GL_STREAM_DRAW
+    );
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "datatypes.hpp"
+#include "rendering/ObjectLights.hpp"
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief Streams per-instance model and normal matrices to a buffer texture.
+ *
+ * Every instance takes TEXELS_PER_INSTANCE RGBA32F texels: 4 columns of the
+ * model matrix, 3 columns of the normal matrix, then 2 texels of ObjectLights
+ * indices. The buffer is orphaned
+ * every frame, so draws of the previous frame don't stall the writes.
+ *
+ * Shaders find the instance by the first instance of the draw plus the
+ * instance index attribute. It is read from a static buffer of consecutive
+ * indices with divisor 1, so unlike gl_InstanceID it includes the base
+ * instance of indirect draws.
+ */
+class InstanceBuffer {
+public:
+    InstanceBuffer();
+    InstanceBuffer(const InstanceBuffer& other) = delete;
+    InstanceBuffer(InstanceBuffer&& other) = delete;
+    ~InstanceBuffer();
+
+    InstanceBuffer& operator=(const InstanceBuffer& other) = delete;
+    InstanceBuffer& operator=(InstanceBuffer&& other) = delete;
+
+    /**
+     * @brief Per-instance data gathered by a drawable before pushing it.
+     */
+    struct Batch {
+        std::vector<glm::mat4> model_matrices;
+        std::vector<ObjectLights::Indices> object_lights;
+    };
+
+    void begin_frame();
+    /**
+     * @brief Writes matrices of instances, at most get_max_instances_count of them.
+     * @param object_lights Empty if instances have no lights, as many as
+     * matrices otherwise.
+     * @return Index of the first written instance in the buffer texture.
+     */
+    [[nodiscard]] std::int32_t push(
+        std::span<const glm::mat4> model_matrices, std::span<const ObjectLights::Indices> object_lights = {}
+    );
+
+    /**
+     * @brief Returns an empty batch that keeps its capacity between draws.
+     */
+    [[nodiscard]] Batch& get_batch() noexcept { return clear_batch(batch); }
+    /**
+     * @brief Like get_batch, but separate from it, because instanced draws are
+     * nested into multi-draws.
+     */
+    [[nodiscard]] Batch& get_multi_draw_batch() noexcept { return clear_batch(multi_draw_batch); }
+
+    [[nodiscard]] TextureID get_texture_id() const noexcept { return texture_id; }
+    [[nodiscard]] BufferID get_instance_indices_buffer_id() const noexcept { return indices_buffer_id; }
+    /**
+     * @brief Returns the maximum amount of instances of one push and of one draw.
+     */
+    [[nodiscard]] std::size_t get_max_instances_count() const noexcept { return max_instances_count; }
+
+    static constexpr std::size_t TEXELS_PER_INSTANCE = 9;
+    static constexpr std::size_t INSTANCE_INDICES_COUNT = 65536;
+
+private:
+    BufferID buffer_id = 0;
+    BufferID indices_buffer_id = 0;
+    TextureID texture_id = 0;
+    std::size_t max_instances_count = 0;
+    std::size_t instances_capacity = 0;
+    std::size_t instances_count = 0;
+    std::vector<glm::vec4> texels;
+    Batch batch;
+    Batch multi_draw_batch;
+
+    void allocate(std::size_t new_instances_capacity);
+    static Batch& clear_batch(Batch& batch) noexcept {
+        batch.model_matrices.clear();
+        batch.object_lights.clear();
+        return batch;
+    }
+};
+}
@@ -0,0 +1,49 @@
+#include "LightClusterBuffer.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "nodes/rendering/CameraNode.hpp"
+#include "GLStateTracker.hpp"
+
+#include <GL/glew.h>
+
+using namespace llengine;
+
+LightClusterBuffer::LightClusterBuffer() {
+    glGenBuffers(1, &buffer_id);
+    glGenTextures(1, &texture_id);
+
+    // Empty clusters until the first update.
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_id);
+    glBufferData(
+        GL_TEXTURE_BUFFER, grid.get_data().size() * sizeof(std::uint32_t),
+        grid.get_data().data(), GL_STREAM_DRAW
+    );
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_BUFFER, texture_id);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, buffer_id);
+}
+
+LightClusterBuffer::~LightClusterBuffer() {
+    if (auto rendering_server = rs_opt()) {
+        rendering_server->_get_gl_state().forget_texture(texture_id);
+    }
+    glDeleteTextures(1, &texture_id);
+    glDeleteBuffers(1, &buffer_id);
+}
+
+void LightClusterBuffer::update(const CameraNode& camera_node, std::span<const uniform_blocks::PointLightData> lights) {
+    grid_lights.clear();
+    for (const uniform_blocks::PointLightData& light : lights) {
+        grid_lights.push_back({light.position, light.range});
+    }
+    grid.build(
+        camera_node.get_view_matrix(), camera_node.get_proj_matrix(),
+        camera_node.get_near_distance(), camera_node.get_far_distance(), grid_lights
+    );
+
+    // Orphaned, so the draws of the previous frame don't stall the write.
+    const std::vector<std::uint32_t>& data = grid.get_data();
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_id);
+    glBufferData(GL_TEXTURE_BUFFER, data.size() * sizeof(std::uint32_t), data.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "datatypes.hpp"
+#include "rendering/LightClusterGrid.hpp"
+#include "rendering/UniformBlocks.hpp"
+
+#include <span>
+#include <vector>
+
+namespace llengine {
+class CameraNode;
+
+/**
+ * @brief Builds the light cluster grid every frame and uploads it
+ * to an R32UI buffer texture for the PBR shader.
+ */
+class LightClusterBuffer {
+public:
+    LightClusterBuffer();
+    LightClusterBuffer(const LightClusterBuffer& other) = delete;
+    LightClusterBuffer(LightClusterBuffer&& other) = delete;
+    ~LightClusterBuffer();
+
+    LightClusterBuffer& operator=(const LightClusterBuffer& other) = delete;
+    LightClusterBuffer& operator=(LightClusterBuffer&& other) = delete;
+
+    void update(const CameraNode& camera_node, std::span<const uniform_blocks::PointLightData> lights);
+
+    [[nodiscard]] TextureID get_texture_id() const noexcept { return texture_id; }
+    [[nodiscard]] const LightClusterGrid& get_grid() const noexcept { return grid; }
+
+private:
+    BufferID buffer_id = 0;
+    TextureID texture_id = 0;
+    LightClusterGrid grid;
+    // Kept to reuse the capacity.
+    std::vector<LightClusterGrid::Light> grid_lights;
+};
+}
@@ -0,0 +1,108 @@
+#include "LightClusterGrid.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/common.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace llengine;
+
+[[nodiscard]] static std::uint32_t ndc_to_tile(float ndc, std::uint32_t tiles_count) {
+    const float tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tiles_count));
+    return static_cast<std::uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tiles_count - 1)));
+}
+
+void LightClusterGrid::build(
+    const glm::mat4& view_matrix, const glm::mat4& proj_matrix,
+    float near_distance, float far_distance, std::span<const Light> lights
+) {
+    const float log_depth_ratio = std::log(far_distance / near_distance);
+    z_scale = static_cast<float>(SIZE_Z) / log_depth_ratio;
+    z_bias = -static_cast<float>(SIZE_Z) * std::log(near_distance) / log_depth_ratio;
+
+    ranges.clear();
+    light_indices.clear();
+    for (std::uint32_t i = 0; i < lights.size(); i++) {
+        const glm::vec3 center {view_matrix * glm::vec4(lights[i].position, 1.0f)};
+        const float radius = lights[i].radius;
+        const float min_depth = -center.z - radius;
+        const float max_depth = -center.z + radius;
+        if (max_depth < near_distance || min_depth > far_distance) {
+            continue;
+        }
+
+        // The screen rectangle of the sphere's bounding box is the one of its corners,
+        // unless the box crosses the near plane and its projection is unbounded.
+        glm::vec2 min_ndc {-1.0f, -1.0f};
+        glm::vec2 max_ndc {1.0f, 1.0f};
+        if (min_depth > near_distance) {
+            min_ndc = glm::vec2(1.0f, 1.0f);
+            max_ndc = glm::vec2(-1.0f, -1.0f);
+            for (int corner = 0; corner < 8; corner++) {
+                const glm::vec3 offset {
+                    corner & 1 ? radius : -radius, corner & 2 ? radius : -radius, corner & 4 ? radius : -radius
+                };
+                const glm::vec4 clip = proj_matrix * glm::vec4(center + offset, 1.0f);
+                const glm::vec2 ndc {clip.x / clip.w, clip.y / clip.w};
+                min_ndc = glm::min(min_ndc, ndc);
+                max_ndc = glm::max(max_ndc, ndc);
+            }
+            if (max_ndc.x < -1.0f || max_ndc.y < -1.0f || min_ndc.x > 1.0f || min_ndc.y > 1.0f) {
+                continue;
+            }
+        }
+
+        ranges.push_back({
+            ndc_to_tile(min_ndc.x, SIZE_X), ndc_to_tile(max_ndc.x, SIZE_X),
+            ndc_to_tile(min_ndc.y, SIZE_Y), ndc_to_tile(max_ndc.y, SIZE_Y),
+            depth_to_slice(std::max(min_depth, near_distance)), depth_to_slice(std::min(max_depth, far_distance))
+        });
+        light_indices.push_back(i);
+    }
+
+    // Count lights of every cluster, then place the lists one after another.
+    data.assign(CLUSTERS_COUNT * 2, 0);
+    const auto for_each_cluster = [] (const ClusterRange& range, auto&& function) {
+        for (std::uint32_t z = range.min_z; z <= range.max_z; z++) {
+            for (std::uint32_t y = range.min_y; y <= range.max_y; y++) {
+                for (std::uint32_t x = range.min_x; x <= range.max_x; x++) {
+                    function((z * SIZE_Y + y) * SIZE_X + x);
+                }
+            }
+        }
+    };
+    for (const ClusterRange& range : ranges) {
+        for_each_cluster(range, [&] (std::uint32_t cluster) {
+            data[cluster * 2 + 1]++;
+        });
+    }
+
+    std::uint32_t offset = CLUSTERS_COUNT * 2;
+    for (std::uint32_t cluster = 0; cluster < CLUSTERS_COUNT; cluster++) {
+        data[cluster * 2] = offset;
+        offset += data[cluster * 2 + 1];
+        // Counts are restored while filling the lists.
+        data[cluster * 2 + 1] = 0;
+    }
+    data.resize(offset);
+
+    for (std::size_t i = 0; i < ranges.size(); i++) {
+        for_each_cluster(ranges[i], [&] (std::uint32_t cluster) {
+            data[data[cluster * 2] + data[cluster * 2 + 1]++] = light_indices[i];
+        });
+    }
+}
+
+[[nodiscard]] std::span<const std::uint32_t> LightClusterGrid::get_cluster_lights(
+    std::uint32_t x, std::uint32_t y, std::uint32_t z
+) const {
+    const std::uint32_t cluster = (z * SIZE_Y + y) * SIZE_X + x;
+    return {data.data() + data[cluster * 2], data[cluster * 2 + 1]};
+}
+
+[[nodiscard]] std::uint32_t LightClusterGrid::depth_to_slice(float depth) const {
+    const float slice = std::floor(std::log(depth) * z_scale + z_bias);
+    return static_cast<std::uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(SIZE_Z - 1)));
+}
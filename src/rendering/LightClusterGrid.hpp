@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief Assigns point lights to clusters of the view frustum for clustered forward shading.
+ *
+ * The frustum is split into SIZE_X * SIZE_Y screen tiles and SIZE_Z depth slices
+ * of exponentially growing thickness. For every cluster the grid keeps the list
+ * of lights whose spheres may intersect it.
+ */
+class LightClusterGrid {
+public:
+    static constexpr std::uint32_t SIZE_X = 16;
+    static constexpr std::uint32_t SIZE_Y = 9;
+    static constexpr std::uint32_t SIZE_Z = 24;
+    static constexpr std::uint32_t CLUSTERS_COUNT = SIZE_X * SIZE_Y * SIZE_Z;
+
+    struct Light {
+        glm::vec3 position;
+        float radius;
+    };
+
+    /**
+     * @brief Rebuilds the grid for a perspective camera.
+     * @param lights Lights in the world space. Their indices are stored in the clusters.
+     */
+    void build(
+        const glm::mat4& view_matrix, const glm::mat4& proj_matrix,
+        float near_distance, float far_distance, std::span<const Light> lights
+    );
+
+    /**
+     * @brief Returns the offset and the amount of light indices for every cluster,
+     * followed by the light indices. Offsets are counted from the beginning.
+     * Cluster (x, y, z) is the (z * SIZE_Y + y) * SIZE_X + x one, tile (0, 0)
+     * is in the bottom left corner of the screen.
+     */
+    [[nodiscard]] const std::vector<std::uint32_t>& get_data() const noexcept { return data; }
+    [[nodiscard]] std::span<const std::uint32_t> get_cluster_lights(std::uint32_t x, std::uint32_t y, std::uint32_t z) const;
+
+    /**
+     * @brief Slice of a view depth is floor(log(depth) * z_scale + z_bias).
+     */
+    [[nodiscard]] float get_z_scale() const noexcept { return z_scale; }
+    [[nodiscard]] float get_z_bias() const noexcept { return z_bias; }
+
+private:
+    struct ClusterRange {
+        std::uint32_t min_x, max_x;
+        std::uint32_t min_y, max_y;
+        std::uint32_t min_z, max_z;
+    };
+
+    std::vector<std::uint32_t> data = std::vector<std::uint32_t>(CLUSTERS_COUNT * 2, 0);
+    float z_scale = 0.0f;
+    float z_bias = 0.0f;
+
+    // Scratch buffers of build, kept to reuse their capacity.
+    std::vector<ClusterRange> ranges;
+    std::vector<std::uint32_t> light_indices;
+
+    [[nodiscard]] std::uint32_t depth_to_slice(float depth) const;
+};
+}
@@ -1,8 +1,17 @@
 #include "rendering/LightingEnvironment.hpp"
 #include "utils/texture_utils.hpp"
+#include "IBLCache.hpp"
+
+#include <fmt/format.h>
 
 namespace llengine {
-void LightingEnvironment::set_base_cubemap(const std::shared_ptr<Texture>& new_base_map) {
+// Spherical harmonics keep only low frequencies, so small faces are enough.
+constexpr std::uint32_t SH_SOURCE_FACE_SIZE = 64;
+
+void LightingEnvironment::set_base_cubemap(
+    const std::shared_ptr<Texture>& new_base_map,
+    std::optional<std::uint64_t> source_hash
+) {
     if (new_base_map == nullptr) {
         return;
     }
@@ -12,8 +21,14 @@ void LightingEnvironment::set_base_cubemap(const std::shared_ptr<Texture>& new_b
     }
 
     base_map = new_base_map;
+    this->source_hash = source_hash;
     irradiance_map = std::nullopt;
     prefiltered_specular_map = std::nullopt;
+    irradiance_sh = std::nullopt;
+}
+
+void LightingEnvironment::set_cache_directory(const std::filesystem::path& directory) {
+    cache_directory = directory;
 }
 
 [[nodiscard]] std::shared_ptr<const Texture> LightingEnvironment::get_base_cubemap() const {
@@ -21,7 +36,20 @@ void LightingEnvironment::set_base_cubemap(const std::shared_ptr<Texture>& new_b
 }
 
 [[nodiscard]] const std::optional<Texture>& LightingEnvironment::get_irradiance_map() const {
-    if (base_map != nullptr && !irradiance_map.has_value()) {
+    if (base_map == nullptr || irradiance_map.has_value()) {
+        return irradiance_map;
+    }
+
+    if (source_hash.has_value() && !cache_directory.empty()) {
+        const std::string parameters {fmt::format(
+            "irradiance {}x{} from {}x{}", tex_utils::IRRADIANCE_MAP_SIZE.x, tex_utils::IRRADIANCE_MAP_SIZE.y,
+            base_map->get_size().x, base_map->get_size().y
+        )};
+        irradiance_map = ibl_cache::load_or_compute(cache_directory, *source_hash, parameters, [this] () {
+            return tex_utils::compute_irradiance_map(*base_map);
+        });
+    }
+    else {
         irradiance_map = tex_utils::compute_irradiance_map(*base_map);
     }
 
@@ -29,10 +57,39 @@ void LightingEnvironment::set_base_cubemap(const std::shared_ptr<Texture>& new_b
 }
 
 [[nodiscard]] const std::optional<Texture>& LightingEnvironment::get_prefiltered_specular_map() const {
-    if (base_map != nullptr && !prefiltered_specular_map.has_value()) {
+    if (base_map == nullptr || prefiltered_specular_map.has_value()) {
+        return prefiltered_specular_map;
+    }
+
+    if (source_hash.has_value() && !cache_directory.empty()) {
+        const std::string parameters {fmt::format(
+            "prefiltered specular {}x{} with {} levels from {}x{}",
+            tex_utils::SPECULAR_MAP_SIZE.x, tex_utils::SPECULAR_MAP_SIZE.y, tex_utils::SPECULAR_MAP_MIPMAP_LEVELS,
+            base_map->get_size().x, base_map->get_size().y
+        )};
+        prefiltered_specular_map = ibl_cache::load_or_compute(cache_directory, *source_hash, parameters, [this] () {
+            return tex_utils::compute_prefiltered_specular_map(*base_map);
+        });
+    }
+    else {
         prefiltered_specular_map = tex_utils::compute_prefiltered_specular_map(*base_map);
     }
 
     return prefiltered_specular_map;
 }
+
+[[nodiscard]] const std::optional<SphericalHarmonics>& LightingEnvironment::get_irradiance_sh() const {
+    if (base_map == nullptr || irradiance_sh.has_value()) {
+        return irradiance_sh;
+    }
+
+    const auto pixels = tex_utils::read_cubemap_pixels(*base_map, SH_SOURCE_FACE_SIZE);
+    const std::array<std::span<const float>, 6> faces {
+        pixels.faces[0], pixels.faces[1], pixels.faces[2],
+        pixels.faces[3], pixels.faces[4], pixels.faces[5]
+    };
+    irradiance_sh = SphericalHarmonics::from_cubemap(faces, pixels.face_size).radiance_to_irradiance();
+
+    return irradiance_sh;
+}
 }
@@ -1,4 +1,6 @@
 #include "MainFramebuffer.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
 #include "BloomRenderer.hpp"
 #include "datatypes.hpp"
 #include "rendering/ExposureController.hpp"
@@ -53,7 +55,7 @@ void MainFramebuffer::render_to_window(float delta_time) {
         bloom_renderer->render_to_bloom_texture(color_attachment_lods, 0.00375f);
     }
 
-    glDisable(GL_DEPTH_TEST);
+    rs()._get_gl_state().set_depth_test(false);
     static Shader<"main_image", "bloom_image", "exposure"> postprocessing_shader(
         #include "shaders/postprocessing/postprocessing.vert"
         ,
@@ -69,9 +71,8 @@ void MainFramebuffer::render_to_window(float delta_time) {
     glViewport(0, 0, framebuffer_size.x, framebuffer_size.y);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     Mesh::get_quad()->bind_vao(true, false, false);
-    glDrawArrays(GL_TRIANGLES, 0, Mesh::get_quad()->get_amount_of_vertices());
-    Mesh::get_quad()->unbind_vao(true, false, false);
-    glEnable(GL_DEPTH_TEST);
+    Mesh::get_quad()->draw();
+    rs()._get_gl_state().set_depth_test(true);
 }
 
 [[nodiscard]] FramebufferID MainFramebuffer::get_framebuffer_id() const {
@@ -106,7 +107,7 @@ void MainFramebuffer::assign_framebuffer_size(glm::u32vec2 size) {
 static Texture initialize_color_attachment_lod(glm::u32vec2 size) {
     ManagedTextureID tex_id;
     glGenTextures(1, &tex_id.get_ref());
-    glBindTexture(GL_TEXTURE_2D, tex_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, tex_id);
     glTexImage2D(
         GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, size.x, size.y, 0,
         GL_RGB, GL_FLOAT, nullptr
@@ -127,7 +128,8 @@ void MainFramebuffer::initialize_depth_attachment(glm::u32vec2 size) {
 }
 
 static glm::vec3 compute_average_color(const std::vector<Texture>& color_attachment_lods) {
-    glBindTexture(GL_TEXTURE_2D, color_attachment_lods.back().get_id());
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, color_attachment_lods.back().get_id());
 
     glm::vec4 result;
     glGetTexImage(
@@ -142,7 +144,7 @@ static glm::vec3 compute_average_color(const std::vector<Texture>& color_attachm
 }
 
 void MainFramebuffer::generate_lods_for_color_attachment() {
-    glDisable(GL_DEPTH_TEST);
+    rs()._get_gl_state().set_depth_test(false);
     static Shader<"previous_lod"> main_fb_color_downsample_shader(
         #include "shaders/postprocessing/main_fb_color_downsample.vert"
         ,
@@ -157,10 +159,9 @@ void MainFramebuffer::generate_lods_for_color_attachment() {
 
         glViewport(0, 0, color_attachment_lods[lod].get_size().x, color_attachment_lods[lod].get_size().y);
         Mesh::get_quad()->bind_vao(true, false, false);
-        glDrawArrays(GL_TRIANGLES, 0, Mesh::get_quad()->get_amount_of_vertices());
-        Mesh::get_quad()->unbind_vao(true, false, false);
+        Mesh::get_quad()->draw();
     }
-    glEnable(GL_DEPTH_TEST);
+    rs()._get_gl_state().set_depth_test(true);
 }
 
 void MainFramebuffer::initialize_framebuffer_lods(glm::u32vec2 size) {
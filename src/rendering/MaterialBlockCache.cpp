@@ -0,0 +1,59 @@
+#include "MaterialBlockCache.hpp"
+
+#include <GL/glew.h>
+
+#include <bit>
+#include <cstring>
+#include <algorithm>
+
+using namespace llengine;
+
+[[nodiscard]] std::size_t MaterialBlockCache::BlockBytesHash::operator()(const BlockBytes& bytes) const noexcept {
+    std::uint64_t result = 0xCBF29CE484222325u;
+    for (std::size_t i = 0; i < bytes.size(); i += sizeof(std::uint32_t)) {
+        std::uint32_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        result = (result ^ word) * 0x100000001B3u;
+    }
+    return static_cast<std::size_t>(result ^ (result >> 32));
+}
+
+MaterialBlockCache::MaterialBlockCache() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const std::size_t offset_alignment = static_cast<std::size_t>(std::max(alignment, 1));
+    slot_stride = (sizeof(BlockBytes) + offset_alignment - 1) / offset_alignment * offset_alignment;
+
+    glGenBuffers(1, &buffer_id);
+    allocate();
+}
+
+MaterialBlockCache::~MaterialBlockCache() {
+    glDeleteBuffers(1, &buffer_id);
+}
+
+void MaterialBlockCache::bind(const Material& material, std::uint32_t binding) {
+    const auto block = uniform_blocks::make_material_block(material);
+    const auto bytes = std::bit_cast<BlockBytes>(block);
+
+    auto iter = slots.find(bytes);
+    if (iter == slots.end()) {
+        if (slots.size() == SLOTS_COUNT) {
+            allocate();
+        }
+        iter = slots.emplace(bytes, slots.size()).first;
+
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+        glBufferSubData(GL_UNIFORM_BUFFER, iter->second * slot_stride, bytes.size(), bytes.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer_id, iter->second * slot_stride, bytes.size());
+}
+
+void MaterialBlockCache::allocate() {
+    slots.clear();
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+    glBufferData(GL_UNIFORM_BUFFER, SLOTS_COUNT * slot_stride, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "UniformBlocks.hpp"
+#include "datatypes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace llengine {
+/**
+ * @brief Keeps material uniform blocks in one uniform buffer across frames.
+ *
+ * Blocks are found by their contents, so materials with equal parameters
+ * share a block and changed materials get a new one. When all slots are
+ * used, the buffer is orphaned and the cache starts over.
+ */
+class MaterialBlockCache {
+public:
+    MaterialBlockCache();
+    MaterialBlockCache(const MaterialBlockCache& other) = delete;
+    MaterialBlockCache(MaterialBlockCache&& other) = delete;
+    ~MaterialBlockCache();
+
+    MaterialBlockCache& operator=(const MaterialBlockCache& other) = delete;
+    MaterialBlockCache& operator=(MaterialBlockCache&& other) = delete;
+
+    /**
+     * @brief Binds the block of the material, uploading it first if it isn't cached.
+     */
+    void bind(const Material& material, std::uint32_t binding);
+
+    static constexpr std::size_t SLOTS_COUNT = 1024;
+
+private:
+    using BlockBytes = std::array<std::byte, sizeof(uniform_blocks::MaterialBlock)>;
+    struct BlockBytesHash {
+        [[nodiscard]] std::size_t operator()(const BlockBytes& bytes) const noexcept;
+    };
+
+    BufferID buffer_id = 0;
+    std::size_t slot_stride = 0;
+    std::unordered_map<BlockBytes, std::size_t, BlockBytesHash> slots;
+
+    void allocate();
+};
+}
@@ -1,23 +1,25 @@
-#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
 #include <utility>
 #include <limits>
 #include <stdexcept>
+#include <array>
+#include <cstring>
 
 #include <GL/glew.h>
 
 #include "rendering/Mesh.hpp"
+#include "rendering/MeshBufferArena.hpp"
+#include "rendering/GLStateTracker.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "utils/vertex_packing.hpp"
+#include "utils/mesh_indexing.hpp"
+#include "utils/meshlet_generation.hpp"
 
 using namespace llengine;
 
 GraphicsAPISize Mesh::get_amount_of_vertices() const {
-    if (is_indexed()) {
-        return std::visit([] (const auto& vector) -> GraphicsAPISize {
-            return static_cast<GraphicsAPISize>(vector.size());
-        }, indices);
-    }
-    else {
-        return static_cast<GraphicsAPISize>(vertices.size());
-    }
+    return static_cast<GraphicsAPISize>(is_indexed() ? indices_count : vertices_count);
 }
 
 GLenum Mesh::get_indices_type() const {
@@ -29,276 +31,511 @@ GLenum Mesh::get_indices_type() const {
     }
 }
 
+bool Mesh::is_indexed() const {
+    return indices_count != 0;
+}
+
+BufferID Mesh::get_indices_id() const {
+    upload_if_needed();
+    return allocation == nullptr ? 0 : allocation->get_block().get_index_buffer_id();
+}
+
+BufferID Mesh::get_vertex_buffer_id() const {
+    upload_if_needed();
+    return allocation == nullptr ? 0 : allocation->get_block().get_vertex_buffer_id();
+}
+
+GraphicsAPISize Mesh::get_base_vertex() const {
+    upload_if_needed();
+    return allocation == nullptr ? 0 : static_cast<GraphicsAPISize>(allocation->get_first_vertex());
+}
+
+std::size_t Mesh::get_indices_offset() const {
+    upload_if_needed();
+    return allocation == nullptr ? 0 : allocation->get_indices_offset();
+}
+
+Mesh::VertexLayout Mesh::get_vertex_layout() const {
+    return vertex_layout;
+}
+
+void Mesh::update_vertex_layout() {
+    VertexLayout layout;
+    // Other attributes are packed into 4 bytes each, see vertex_packing.hpp.
+    if (!uvs.empty()) {
+        layout.uv_offset = layout.stride;
+        layout.stride += sizeof(std::uint32_t);
+    }
+    if (!normals.empty()) {
+        layout.normal_offset = layout.stride;
+        layout.stride += sizeof(std::uint32_t);
+    }
+    if (!tangents.empty()) {
+        layout.tangent_offset = layout.stride;
+        layout.stride += sizeof(std::uint32_t);
+    }
+    vertex_layout = layout;
+}
+
 void Mesh::bind_vao(bool enable_uv, bool enable_normals, bool enable_tangents) const {
-    if (vao_id == 0) {
-        initialize_vao();
+    upload_if_needed();
+    if (allocation == nullptr) {
+        return;
     }
 
-    glBindVertexArray(vao_id);
-    if (vertices_id != 0) glEnableVertexAttribArray(0);
-    if (uvs_id != 0 && enable_uv) glEnableVertexAttribArray(1);
-    if (normals_id != 0 && enable_normals) glEnableVertexAttribArray(2);
-    if (tangents_id != 0 && enable_tangents) glEnableVertexAttribArray(3);
+    std::uint32_t enabled_attributes = (1u << 0) | (1u << INSTANCE_INDEX_ATTRIBUTE);
+    if (has_uvs() && enable_uv) enabled_attributes |= 1u << 1;
+    if (has_normals() && enable_normals) enabled_attributes |= 1u << 2;
+    if (has_tangents() && enable_tangents) enabled_attributes |= 1u << 3;
+    rs()._get_gl_state().bind_vertex_array(allocation->get_block().get_vao_id(), enabled_attributes);
+}
+
+[[nodiscard]] VertexArrayID Mesh::get_vao_id() const noexcept {
+    return allocation == nullptr || upload_needed ? 0 : allocation->get_block().get_vao_id();
 }
 
-void Mesh::unbind_vao(bool unbind_uv, bool unbind_normals, bool unbind_tangents) const {
-    if (vao_id != 0) {
-        glBindVertexArray(0);
-        if (vertices_id != 0) glDisableVertexAttribArray(0);
-        if (uvs_id != 0 && unbind_uv) glDisableVertexAttribArray(1);
-        if (normals_id != 0 && unbind_normals) glDisableVertexAttribArray(2);
-        if (tangents_id != 0 && unbind_tangents) glDisableVertexAttribArray(3);
+void Mesh::draw() const {
+    if (allocation == nullptr) {
+        return;
+    }
+
+    if (is_indexed()) {
+        glDrawElementsBaseVertex(
+            GL_TRIANGLES, get_amount_of_vertices(), get_indices_type(),
+            reinterpret_cast<const void*>(allocation->get_indices_offset()),
+            static_cast<GLint>(allocation->get_first_vertex())
+        );
+    }
+    else {
+        glDrawArrays(
+            GL_TRIANGLES, static_cast<GLint>(allocation->get_first_vertex()),
+            get_amount_of_vertices()
+        );
+    }
+}
+
+void Mesh::draw_instanced(std::size_t instances_count) const {
+    if (allocation == nullptr) {
+        return;
+    }
+
+    if (is_indexed()) {
+        glDrawElementsInstancedBaseVertex(
+            GL_TRIANGLES, get_amount_of_vertices(), get_indices_type(),
+            reinterpret_cast<const void*>(allocation->get_indices_offset()),
+            static_cast<GLsizei>(instances_count), static_cast<GLint>(allocation->get_first_vertex())
+        );
+    }
+    else {
+        glDrawArraysInstanced(
+            GL_TRIANGLES, static_cast<GLint>(allocation->get_first_vertex()),
+            get_amount_of_vertices(), static_cast<GLsizei>(instances_count)
+        );
     }
 }
 
-template<typename T, GLenum TARGET>
-static BufferID handle_buffer(std::vector<T>& buffer) {
-    BufferID buffer_id;
+void Mesh::draw_meshlets(std::span<const std::uint32_t> meshlet_indices) const {
+    if (allocation == nullptr || meshlet_indices.empty()) {
+        return;
+    }
 
-    glGenBuffers(1, &buffer_id);
+    const std::size_t index_size = get_indices_type() == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+    std::vector<GLsizei> counts;
+    std::vector<std::size_t> offsets;
+    for (const std::uint32_t meshlet_index : meshlet_indices) {
+        const Meshlet& meshlet = meshlets[meshlet_index];
+        const std::size_t offset = allocation->get_indices_offset() + meshlet.first_index * index_size;
+        if (!counts.empty() && offsets.back() + counts.back() * index_size == offset) {
+            counts.back() += static_cast<GLsizei>(meshlet.indices_count);
+        }
+        else {
+            counts.push_back(static_cast<GLsizei>(meshlet.indices_count));
+            offsets.push_back(offset);
+        }
+    }
 
-    glBindBuffer(TARGET, buffer_id);
-    glBufferData(TARGET, buffer.size() * sizeof(T),
-                 buffer.data(), GL_STATIC_DRAW);
+    std::vector<const void*> offset_pointers(offsets.size());
+    std::transform(offsets.begin(), offsets.end(), offset_pointers.begin(), [] (std::size_t offset) {
+        return reinterpret_cast<const void*>(offset);
+    });
+    std::vector<GLint> base_vertices(counts.size(), static_cast<GLint>(allocation->get_first_vertex()));
+    glMultiDrawElementsBaseVertex(
+        GL_TRIANGLES, counts.data(), get_indices_type(), offset_pointers.data(),
+        static_cast<GLsizei>(counts.size()), base_vertices.data()
+    );
+}
 
-    return buffer_id;
+void Mesh::build_meshlets() {
+    if (!is_indexed()) {
+        return;
+    }
+    read_back_if_released();
+
+    std::vector<std::uint32_t> new_indices = std::visit([] (const auto& vector) {
+        return std::vector<std::uint32_t>(vector.begin(), vector.end());
+    }, indices);
+    auto new_meshlets = meshlet_generation::build_meshlets(vertices, new_indices);
+
+    set_indices(new_indices);
+    meshlets = std::move(new_meshlets);
 }
 
 template<typename T>
 void Mesh::set_indices(const std::vector<T>& new_indices) {
-    indices = new_indices;
-    indices_id = handle_buffer<T, GL_ELEMENT_ARRAY_BUFFER>(
-        std::get<std::vector<T>>(indices)
-    );
+    // Released vertex data stays on the GPU.
+    reuse_gpu_vertices = residency.is_released();
+    if constexpr (std::is_same_v<T, std::uint32_t>) {
+        auto narrowed = narrow_indices(new_indices);
+        if (narrowed.has_value()) {
+            indices = std::move(*narrowed);
+        }
+        else {
+            indices = new_indices;
+        }
+    }
+    else {
+        indices = new_indices;
+    }
+    indices_count = new_indices.size();
+    meshlets.clear();
+    upload_needed = true;
 }
 template void Mesh::set_indices(const std::vector<uint16_t> &new_indices);
 template void Mesh::set_indices(const std::vector<uint32_t> &new_indices);
 
 void Mesh::set_vertices(const std::vector<glm::vec3>& new_vertices) {
+    read_back_if_released();
     vertices = new_vertices;
-    vertices_id = handle_buffer<glm::vec3, GL_ARRAY_BUFFER>(vertices);
-    reset_vao_if_needed();
-    compute_min_and_max_vertex_values();
+    vertices_count = new_vertices.size();
+    meshlets.clear();
+    upload_needed = true;
+    compute_bounding_volumes();
 }
 
 void Mesh::set_uvs(const std::vector<glm::vec2>& new_uvs) {
+    read_back_if_released();
     uvs = new_uvs;
-    uvs_id = handle_buffer<glm::vec2, GL_ARRAY_BUFFER>(uvs);
-    reset_vao_if_needed();
+    update_vertex_layout();
+    upload_needed = true;
 }
 
 void Mesh::set_normals(const std::vector<glm::vec3>& new_normals) {
+    read_back_if_released();
     normals = new_normals;
-    normals_id = handle_buffer<glm::vec3, GL_ARRAY_BUFFER>(normals);
-    reset_vao_if_needed();
+    update_vertex_layout();
+    upload_needed = true;
 }
 
 void Mesh::set_tangents(const std::vector<glm::vec4>& new_tangents) {
+    read_back_if_released();
     tangents = new_tangents;
-    tangents_id = handle_buffer<glm::vec4, GL_ARRAY_BUFFER>(tangents);
-    reset_vao_if_needed();
+    update_vertex_layout();
+    upload_needed = true;
 }
 
-Mesh::HandledBufferID::HandledBufferID() : buffer_id(0) {
+[[nodiscard]] std::optional<std::vector<std::uint16_t>> Mesh::narrow_indices(
+    std::span<const std::uint32_t> indices
+) {
+    // Both loops are simple enough to be vectorized by the compiler.
+    std::uint32_t max_index = 0;
+    for (const std::uint32_t index : indices) {
+        max_index = std::max(max_index, index);
+    }
+    if (max_index > std::numeric_limits<std::uint16_t>::max()) {
+        return std::nullopt;
+    }
 
+    std::vector<std::uint16_t> result(indices.size());
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        result[i] = static_cast<std::uint16_t>(indices[i]);
+    }
+    return result;
 }
 
-Mesh::HandledBufferID::HandledBufferID(BufferID buffer_id) : buffer_id(buffer_id) {
+void Mesh::set_residency(Residency new_residency) {
+    if (residency.request(new_residency)) {
+        // The new mode keeps more data than the current one.
+        read_back_released_data();
+    }
 
+    release_cpu_data_if_needed();
 }
 
-Mesh::HandledBufferID::HandledBufferID(Mesh::HandledBufferID&& other) noexcept {
-    this->buffer_id = other.get();
-    other.buffer_id = 0;
+[[nodiscard]] const std::vector<glm::vec3>& Mesh::get_vertices() const {
+    if (residency.get_current() == Residency::GPU_ONLY) {
+        throw std::runtime_error("Vertex positions of the mesh were released from RAM.");
+    }
+
+    return vertices;
 }
 
-Mesh::HandledBufferID::~HandledBufferID() {
-    if (buffer_id != 0) {
-        glDeleteBuffers(1, &buffer_id);
-    }
+template<typename T>
+static void release_vector(std::vector<T>& vector) {
+    std::vector<T>().swap(vector);
 }
 
-Mesh::HandledBufferID& Mesh::HandledBufferID::operator=(Mesh::HandledBufferID&& other) noexcept {
-    if (buffer_id != 0) {
-        glDeleteBuffers(1, &buffer_id);
+template<typename T>
+static void write_attribute(
+    std::vector<std::uint8_t>& buffer, const std::vector<T>& attribute,
+    std::optional<std::size_t> offset, std::size_t stride
+) {
+    if (!offset.has_value()) {
+        return;
     }
 
-    this->buffer_id = other.buffer_id;
-    other.buffer_id = 0;
-
-    return *this;
+    for (std::size_t i = 0; i < attribute.size(); i++) {
+        std::memcpy(buffer.data() + i * stride + *offset, &attribute[i], sizeof(T));
+    }
 }
 
-Mesh::HandledBufferID& Mesh::HandledBufferID::operator=(BufferID buffer_id) {
-    if (this->buffer_id != 0) {
-        glDeleteBuffers(1, &this->buffer_id);
+template<typename T, typename Unpacker>
+static void read_attribute(
+    const std::vector<std::uint8_t>& buffer, std::vector<T>& attribute,
+    std::optional<std::size_t> offset, std::size_t stride, std::size_t count, Unpacker unpack
+) {
+    if (!offset.has_value()) {
+        return;
     }
 
-    this->buffer_id = buffer_id;
-
-    return *this;
+    attribute.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint32_t packed;
+        std::memcpy(&packed, buffer.data() + i * stride + *offset, sizeof(packed));
+        attribute[i] = unpack(packed);
+    }
 }
 
-Mesh::ManagedVertexArrayID::ManagedVertexArrayID() : vao_id(0){
+void Mesh::upload_if_needed() const {
+    if (!upload_needed) {
+        return;
+    }
 
-}
+    if (reuse_gpu_vertices) {
+        std::visit([&] (const auto& vector) {
+            allocation = rs()._get_mesh_buffer_arena().allocate_with_vertices_of(
+                *allocation, vertex_layout, vector.data(), vector.size() * sizeof(vector[0])
+            );
+        }, indices);
 
-Mesh::ManagedVertexArrayID::ManagedVertexArrayID(VertexArrayID vao_id) : vao_id(vao_id) {
+        reuse_gpu_vertices = false;
+        upload_needed = false;
+        release_cpu_data_if_needed();
+        return;
+    }
 
-}
+    if ((has_uvs() && uvs.size() != vertices.size()) ||
+        (has_normals() && normals.size() != vertices.size()) ||
+        (has_tangents() && tangents.size() != vertices.size())) {
+        throw std::runtime_error("Can't upload mesh data: unequal amounts of components.");
+    }
 
-Mesh::ManagedVertexArrayID::ManagedVertexArrayID(ManagedVertexArrayID&& other) noexcept {
-    this->vao_id = other.get();
-    other.vao_id = 0;
-}
+    const VertexLayout& layout = vertex_layout;
+    std::vector<std::uint8_t> interleaved(vertices.size() * layout.stride);
+    write_attribute(interleaved, vertices, 0, layout.stride);
 
-Mesh::ManagedVertexArrayID::~ManagedVertexArrayID() {
-    if (vao_id != 0) {
-        glDeleteVertexArrays(1, &vao_id);
+    std::vector<std::uint32_t> packed(vertices.size());
+    if (has_uvs()) {
+        vertex_packing::pack_uvs(uvs, packed);
+        write_attribute(interleaved, packed, layout.uv_offset, layout.stride);
     }
-}
-
-Mesh::ManagedVertexArrayID& Mesh::ManagedVertexArrayID::operator=(ManagedVertexArrayID&& other) noexcept {
-    if (this->vao_id != 0) {
-        glDeleteVertexArrays(1, &this->vao_id);
+    if (has_normals()) {
+        vertex_packing::pack_normals(normals, packed);
+        write_attribute(interleaved, packed, layout.normal_offset, layout.stride);
+    }
+    if (has_tangents()) {
+        vertex_packing::pack_tangents(tangents, packed);
+        write_attribute(interleaved, packed, layout.tangent_offset, layout.stride);
     }
 
-    this->vao_id = other.get();
-    other.vao_id = 0;
+    // Free the old ranges first so they can be reused right away, unless copies share them.
+    allocation = nullptr;
+    if (!vertices.empty()) {
+        std::visit([&] (const auto& vector) {
+            allocation = rs()._get_mesh_buffer_arena().allocate(
+                layout, interleaved.data(), vertices.size(),
+                vector.data(), vector.size() * sizeof(vector[0])
+            );
+        }, indices);
+    }
 
-    return *this;
+    upload_needed = false;
+    release_cpu_data_if_needed();
 }
 
-Mesh::ManagedVertexArrayID& Mesh::ManagedVertexArrayID::operator=(VertexArrayID vao_id) {
-    if (this->vao_id != 0) {
-        glDeleteVertexArrays(1, &this->vao_id);
+void Mesh::release_cpu_data_if_needed() const {
+    if (upload_needed || allocation == nullptr || !residency.release_to_requested()) {
+        return;
     }
 
-    this->vao_id = vao_id;
-
-    return *this;
+    std::visit([] (auto& vector) {
+        release_vector(vector);
+    }, indices);
+    release_vector(uvs);
+    release_vector(normals);
+    release_vector(tangents);
+    if (residency.get_current() == Residency::GPU_ONLY) {
+        release_vector(vertices);
+    }
 }
 
-struct CompleteVertex {
-    glm::vec3 vertex;
-    glm::vec2 uv;
-    glm::vec3 normal;
-
-    bool operator==(const CompleteVertex& other) const noexcept {
-        return vertex == other.vertex && uv == other.uv && normal == other.normal;
+void Mesh::read_back_if_released() {
+    if (residency.is_released()) {
+        read_back_released_data();
     }
-};
+}
 
-struct CompleteVertexHasher {
-    std::size_t operator()(const CompleteVertex& cv) const {
-        size_t res = 17;
-        std::hash<float> hash;
+void Mesh::read_back() {
+    if (residency.request(Residency::CPU_AND_GPU)) {
+        read_back_released_data();
+    }
+}
 
-        res = res * 31 + hash(cv.vertex.x);
-        res = res * 31 + hash(cv.vertex.y);
-        res = res * 31 + hash(cv.vertex.z);
-        res = res * 31 + hash(cv.uv.x);
-        res = res * 31 + hash(cv.uv.y);
-        res = res * 31 + hash(cv.normal.x);
-        res = res * 31 + hash(cv.normal.y);
-        res = res * 31 + hash(cv.normal.z);
+void Mesh::read_back_released_data() {
+    const MeshBufferBlock& block = allocation->get_block();
 
-        return res;
+    std::vector<std::uint8_t> interleaved(vertices_count * vertex_layout.stride);
+    glBindBuffer(GL_COPY_READ_BUFFER, block.get_vertex_buffer_id());
+    glGetBufferSubData(
+        GL_COPY_READ_BUFFER, allocation->get_first_vertex() * vertex_layout.stride,
+        interleaved.size(), interleaved.data()
+    );
+    vertices.resize(vertices_count);
+    for (std::size_t i = 0; i < vertices_count; i++) {
+        std::memcpy(&vertices[i], interleaved.data() + i * vertex_layout.stride, sizeof(glm::vec3));
     }
-};
+    // Packed attributes come back with the precision of their packed formats.
+    read_attribute(
+        interleaved, uvs, vertex_layout.uv_offset, vertex_layout.stride,
+        vertices_count, vertex_packing::unpack_uv
+    );
+    read_attribute(
+        interleaved, normals, vertex_layout.normal_offset, vertex_layout.stride,
+        vertices_count, vertex_packing::unpack_normal
+    );
+    read_attribute(
+        interleaved, tangents, vertex_layout.tangent_offset, vertex_layout.stride,
+        vertices_count, vertex_packing::unpack_tangent
+    );
 
-template<typename T>
-void Mesh::index_data() {
-    if (vertices.size() != uvs.size() ||
-        vertices.size() != normals.size()) {
-        throw std::runtime_error("Can't index mesh data: unequal amounts of components.");
+    // Indices set after the release are newer than the uploaded ones.
+    if (!reuse_gpu_vertices) {
+        std::visit([&] (auto& vector) {
+            vector.resize(indices_count);
+            glBindBuffer(GL_COPY_READ_BUFFER, block.get_index_buffer_id());
+            glGetBufferSubData(
+                GL_COPY_READ_BUFFER, allocation->get_indices_offset(),
+                vector.size() * sizeof(vector[0]), vector.data()
+            );
+        }, indices);
     }
 
-    auto& indices = std::get<std::vector<T>>(this->indices);
+    reuse_gpu_vertices = false;
+    residency.mark_read_back();
+}
 
-    // Copy input data.
-    auto in_vertices = vertices;
-    auto in_uvs = uvs;
-    auto in_normals = normals;
+// On several cores, sorting overtakes the hash table at about this amount of vertices.
+constexpr std::size_t PARALLEL_INDEXING_THRESHOLD = 1 << 20;
 
-    indices.clear();
-    vertices.clear();
-    uvs.clear();
-    normals.clear();
+template<typename T>
+[[nodiscard]] static std::vector<T> gather(const std::vector<T>& source, const std::vector<std::uint32_t>& positions) {
+    std::vector<T> result(positions.size());
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        result[i] = source[positions[i]];
+    }
+    return result;
+}
 
-    std::unordered_map<CompleteVertex, T, CompleteVertexHasher> vertex_to_index;
+void Mesh::index_data(bool compare_tangents, IndexingAlgorithm algorithm) {
+    read_back_if_released();
 
-    for (std::size_t i = 0; i < in_vertices.size(); i++) {
-        CompleteVertex complete {in_vertices[i], in_uvs[i], in_normals[i]};
+    if ((has_uvs() && uvs.size() != vertices.size()) ||
+        (has_normals() && normals.size() != vertices.size()) ||
+        (has_tangents() && tangents.size() != vertices.size())) {
+        throw std::runtime_error("Can't index mesh data: unequal amounts of components.");
+    }
 
-        auto find_result = vertex_to_index.find(complete);
+    if (algorithm == IndexingAlgorithm::AUTOMATIC) {
+        algorithm = vertices.size() >= PARALLEL_INDEXING_THRESHOLD ?
+            IndexingAlgorithm::PARALLEL_SORT : IndexingAlgorithm::HASH_TABLE;
+    }
 
-        if (find_result != vertex_to_index.end()) {
-            // Needed vertex already present in the out_* arguments.
-            // Add index only.
-            indices.push_back(find_result->second);
-        }
-        else {
-            // Needed vertex doesn't present in the out_* arguments.
-            // Add the vertex and it's index.
-            vertices.push_back(complete.vertex);
-            uvs.push_back(complete.uv);
-            normals.push_back(complete.normal);
-
-            std::uint32_t new_index = static_cast<std::uint32_t>(vertices.size()) - 1;
-            vertex_to_index.insert(std::make_pair(complete, new_index));
-            indices.push_back(new_index);
-        }
+    const mesh_indexing::VertexStreams streams {vertices, uvs, normals, tangents};
+    mesh_indexing::IndexingResult result = algorithm == IndexingAlgorithm::PARALLEL_SORT ?
+        mesh_indexing::index_with_parallel_sort(streams, compare_tangents) :
+        mesh_indexing::index_with_hash_table(streams, compare_tangents);
+
+    if (is_indexed()) {
+        std::visit([&result] (const auto& old_indices) {
+            result.indices = gather(result.indices, std::vector<std::uint32_t>(old_indices.begin(), old_indices.end()));
+        }, indices);
     }
-}
 
-void Mesh::index_data() {
-    if (std::holds_alternative<std::vector<uint16_t>>(indices)) {
-        index_data<uint16_t>();
+    vertices = gather(vertices, result.unique_vertices);
+    if (has_uvs()) {
+        uvs = gather(uvs, result.unique_vertices);
     }
-    else {
-        index_data<uint32_t>();
+    if (has_normals()) {
+        normals = gather(normals, result.unique_vertices);
+    }
+    if (has_tangents()) {
+        tangents = gather(tangents, result.unique_vertices);
     }
+    vertices_count = vertices.size();
+
+    set_indices(result.indices);
 }
 
 Mesh::Mesh(const Mesh& other) {
-    std::visit([this] (const auto& vector) {
-        this->set_indices(vector);
-    }, other.indices);
-    set_vertices(other.vertices);
-    set_uvs(other.uvs);
-    set_normals(other.normals);
-    set_tangents(other.tangents);
+    *this = other;
+}
+
+Mesh& Mesh::operator=(const Mesh& other) {
+    indices = other.indices;
+    meshlets = other.meshlets;
+    vertices = other.vertices;
+    uvs = other.uvs;
+    normals = other.normals;
+    tangents = other.tangents;
+
+    min_vertex_value = other.min_vertex_value;
+    max_vertex_value = other.max_vertex_value;
+    bounding_sphere = other.bounding_sphere;
+    obb = other.obb;
+
+    vertex_layout = other.vertex_layout;
+    vertices_count = other.vertices_count;
+    indices_count = other.indices_count;
+
+    allocation = other.allocation;
+    upload_needed = other.upload_needed;
+    reuse_gpu_vertices = other.reuse_gpu_vertices;
+    residency = other.residency;
+
+    return *this;
 }
 
 Mesh::Mesh(Mesh&& other) noexcept :
+    allocation(std::move(other.allocation)),
+    upload_needed(other.upload_needed),
+    reuse_gpu_vertices(other.reuse_gpu_vertices),
+    residency(other.residency),
     indices(std::move(other.indices)),
     vertices(std::move(other.vertices)),
     uvs(std::move(other.uvs)),
     normals(std::move(other.normals)),
     tangents(std::move(other.tangents)),
-    vao_id(std::move(other.vao_id)),
-    indices_id(std::move(other.indices_id)),
-    vertices_id(std::move(other.vertices_id)),
-    uvs_id(std::move(other.uvs_id)),
-    normals_id(std::move(other.normals_id)),
-    tangents_id(std::move(other.tangents_id)) {}
-
-Mesh::~Mesh() {
+    meshlets(std::move(other.meshlets)),
+    vertex_layout(other.vertex_layout),
+    vertices_count(other.vertices_count),
+    indices_count(other.indices_count),
+    min_vertex_value(other.min_vertex_value),
+    max_vertex_value(other.max_vertex_value),
+    bounding_sphere(other.bounding_sphere),
+    obb(other.obb) {}
 
-}
+Mesh::Mesh() = default;
 
-Mesh& Mesh::operator=(const Mesh& other) {
-    std::visit([this] (const auto& vector) {
-        this->set_indices(vector);
-    }, other.indices);
-    set_vertices(other.vertices);
-    set_uvs(other.uvs);
-    set_normals(other.normals);
-    set_tangents(other.tangents);
-
-    return *this;
-}
+Mesh::~Mesh() = default;
 
 Mesh& Mesh::operator=(Mesh&& other) noexcept {
     indices = std::move(other.indices);
@@ -306,63 +543,64 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
     uvs = std::move(other.uvs);
     normals = std::move(other.normals);
     tangents = std::move(other.tangents);
+    meshlets = std::move(other.meshlets);
+
+    min_vertex_value = other.min_vertex_value;
+    max_vertex_value = other.max_vertex_value;
+    bounding_sphere = other.bounding_sphere;
+    obb = other.obb;
+
+    vertex_layout = other.vertex_layout;
+    vertices_count = other.vertices_count;
+    indices_count = other.indices_count;
 
-    vao_id = std::move(other.vao_id);
-    indices_id = std::move(other.indices_id);
-    vertices_id = std::move(other.vertices_id);
-    uvs_id = std::move(other.uvs_id);
-    normals_id = std::move(other.normals_id);
-    tangents_id = std::move(other.tangents_id);
+    allocation = std::move(other.allocation);
+    upload_needed = other.upload_needed;
+    reuse_gpu_vertices = other.reuse_gpu_vertices;
+    residency = other.residency;
 
     return *this;
 }
 
-static void bind_vertex_attrib_pointer(GLuint buffer_id, GLuint vertex_attrib_index, GLint size) {
-    if (buffer_id != 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
-        glVertexAttribPointer(vertex_attrib_index, size, GL_FLOAT, GL_FALSE, 0, 0);
+void Mesh::compute_min_and_max_vertex_values() {
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+
+    // Several vertices are processed together with per-component accumulators,
+    // so the loop has no dependencies between lanes and compiles to SIMD min and max.
+    constexpr std::size_t LANES = 8 * 3;
+    std::array<float, LANES> lane_min;
+    std::array<float, LANES> lane_max;
+    lane_min.fill(std::numeric_limits<float>::max());
+    lane_max.fill(std::numeric_limits<float>::lowest());
+
+    const float* const values = reinterpret_cast<const float*>(vertices.data());
+    const std::size_t values_count = vertices.size() * 3;
+    std::size_t i = 0;
+    for (; i + LANES <= values_count; i += LANES) {
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            const float value = values[i + lane];
+            lane_min[lane] = value < lane_min[lane] ? value : lane_min[lane];
+            lane_max[lane] = value > lane_max[lane] ? value : lane_max[lane];
+        }
     }
-}
-
-void Mesh::reset_vao_if_needed() const {
-    if (vao_id == 0) {
-        return;
+    // The tail starts at a vertex boundary, so value i goes to lane i % 3.
+    for (std::size_t lane = 0; i < values_count; i++, lane++) {
+        lane_min[lane] = std::min(lane_min[lane], values[i]);
+        lane_max[lane] = std::max(lane_max[lane], values[i]);
     }
 
-    initialize_vao();
+    for (std::size_t component = 0; component < 3; component++) {
+        min_vertex_value[component] = std::numeric_limits<float>::max();
+        max_vertex_value[component] = std::numeric_limits<float>::lowest();
+        for (std::size_t lane = component; lane < LANES; lane += 3) {
+            min_vertex_value[component] = std::min(min_vertex_value[component], lane_min[lane]);
+            max_vertex_value[component] = std::max(max_vertex_value[component], lane_max[lane]);
+        }
+    }
 }
 
-void Mesh::initialize_vao() const {
-    vao_id = ManagedVertexArrayID();
-    glGenVertexArrays(1, &vao_id.get());
-    glBindVertexArray(vao_id);
-
-    bind_vertex_attrib_pointer(vertices_id, 0, 3);
-    bind_vertex_attrib_pointer(uvs_id,      1, 2);
-    bind_vertex_attrib_pointer(normals_id,  2, 3);
-    bind_vertex_attrib_pointer(tangents_id, 3, 4);
+void Mesh::compute_bounding_volumes() {
+    compute_min_and_max_vertex_values();
+    bounding_sphere = BoundingSphere::from_points(vertices, get_aabb());
+    obb = OBB::from_points(vertices, get_aabb());
 }
-
-void Mesh::compute_min_and_max_vertex_values() {
-    min_vertex_value = {
-        std::numeric_limits<float>::max(),
-        std::numeric_limits<float>::max(),
-        std::numeric_limits<float>::max()
-    };
-    max_vertex_value = {
-        std::numeric_limits<float>::lowest(),
-        std::numeric_limits<float>::lowest(),
-        std::numeric_limits<float>::lowest()
-    };
-
-    for (const glm::vec3& cur_vertex : vertices) {
-        for (std::size_t i = 0; i < 3; i++) {
-            if (cur_vertex[i] > max_vertex_value[i]) {
-                max_vertex_value[i] = cur_vertex[i];
-            }
-            if (cur_vertex[i] < min_vertex_value[i]) {
-                min_vertex_value[i] = cur_vertex[i];
-            }
-        }
-    }
-}
\ No newline at end of file
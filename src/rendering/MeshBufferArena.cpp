@@ -0,0 +1,260 @@
+#include "rendering/MeshBufferArena.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
+#include "rendering/InstanceBuffer.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+
+using namespace llengine;
+
+// Capacities of regular blocks. Meshes that don't fit get a dedicated block.
+constexpr std::size_t VERTEX_BLOCK_SIZE = 32 * 1024 * 1024;
+constexpr std::size_t INDEX_BLOCK_SIZE = 8 * 1024 * 1024;
+// Index offsets are kept aligned to the largest index type.
+constexpr std::size_t INDICES_ALIGNMENT = sizeof(std::uint32_t);
+
+FreeList::FreeList(std::size_t capacity) : capacity(capacity), free_size(capacity) {
+    if (capacity != 0) {
+        free_ranges.emplace(0, capacity);
+    }
+}
+
+[[nodiscard]] std::optional<std::size_t> FreeList::allocate(std::size_t size, std::size_t alignment) {
+    if (size == 0) {
+        return 0;
+    }
+
+    for (auto iter = free_ranges.begin(); iter != free_ranges.end(); iter++) {
+        const auto [range_offset, range_size] = *iter;
+        const std::size_t aligned_offset = (range_offset + alignment - 1) / alignment * alignment;
+        if (aligned_offset + size > range_offset + range_size) {
+            continue;
+        }
+
+        free_ranges.erase(iter);
+        if (aligned_offset != range_offset) {
+            free_ranges.emplace(range_offset, aligned_offset - range_offset);
+        }
+        if (aligned_offset + size != range_offset + range_size) {
+            free_ranges.emplace(aligned_offset + size, range_offset + range_size - aligned_offset - size);
+        }
+
+        free_size -= size;
+        return aligned_offset;
+    }
+
+    return std::nullopt;
+}
+
+void FreeList::free(std::size_t offset, std::size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    auto [iter, inserted] = free_ranges.emplace(offset, size);
+    free_size += size;
+
+    // Merge with the next range.
+    const auto next = std::next(iter);
+    if (next != free_ranges.end() && iter->first + iter->second == next->first) {
+        iter->second += next->second;
+        free_ranges.erase(next);
+    }
+
+    // Merge with the previous range.
+    if (iter != free_ranges.begin()) {
+        const auto prev = std::prev(iter);
+        if (prev->first + prev->second == iter->first) {
+            prev->second += iter->second;
+            free_ranges.erase(iter);
+        }
+    }
+}
+
+static void bind_vertex_attrib_pointer(
+    GLuint vertex_attrib_index, GLint size, GLenum type, GLboolean normalized,
+    GLsizei stride, std::optional<std::size_t> offset
+) {
+    if (offset.has_value()) {
+        glVertexAttribPointer(
+            vertex_attrib_index, size, type, normalized, stride,
+            reinterpret_cast<const void*>(*offset)
+        );
+    }
+}
+
+static void allocate_storage(GLenum target, std::size_t size) {
+    if (GLEW_ARB_buffer_storage) {
+        // Ranges are still filled with glBufferSubData and glCopyBufferSubData.
+        glBufferStorage(target, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+    else {
+        glBufferData(target, size, nullptr, GL_STATIC_DRAW);
+    }
+}
+
+MeshBufferBlock::MeshBufferBlock(
+    const Mesh::VertexLayout& layout, std::size_t vertices_capacity, std::size_t indices_capacity,
+    bool dedicated
+) : vertices(vertices_capacity), indices(indices_capacity), dedicated(dedicated) {
+    glGenVertexArrays(1, &vao_id);
+    GLStateTracker& gl_state = rs()._get_gl_state();
+    gl_state.bind_vertex_array(vao_id);
+
+    glGenBuffers(1, &vertex_buffer_id);
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id);
+    allocate_storage(GL_ARRAY_BUFFER, vertices_capacity * layout.stride);
+
+    // Formats of packed attributes are described in vertex_packing.hpp.
+    bind_vertex_attrib_pointer(0, 3, GL_FLOAT, GL_FALSE, layout.stride, 0);
+    bind_vertex_attrib_pointer(1, 2, GL_HALF_FLOAT, GL_FALSE, layout.stride, layout.uv_offset);
+    bind_vertex_attrib_pointer(2, 2, GL_SHORT, GL_TRUE, layout.stride, layout.normal_offset);
+    bind_vertex_attrib_pointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, layout.stride, layout.tangent_offset);
+
+    // Instance indices are shared by all the VAOs, see InstanceBuffer.
+    glBindBuffer(GL_ARRAY_BUFFER, rs()._get_instance_buffer().get_instance_indices_buffer_id());
+    glVertexAttribIPointer(Mesh::INSTANCE_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0, nullptr);
+    glVertexAttribDivisor(Mesh::INSTANCE_INDEX_ATTRIBUTE, 1);
+
+    if (indices_capacity != 0) {
+        // The element array buffer binding is the state of the VAO.
+        glGenBuffers(1, &index_buffer_id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id);
+        allocate_storage(GL_ELEMENT_ARRAY_BUFFER, indices_capacity);
+    }
+}
+
+MeshBufferBlock::~MeshBufferBlock() {
+    if (auto rendering_server = rs_opt()) {
+        rendering_server->_get_gl_state().forget_vertex_array(vao_id);
+    }
+    glDeleteVertexArrays(1, &vao_id);
+    glDeleteBuffers(1, &vertex_buffer_id);
+    if (index_buffer_id != 0) {
+        glDeleteBuffers(1, &index_buffer_id);
+    }
+}
+
+MeshBufferAllocation::MeshBufferAllocation(
+    std::shared_ptr<MeshBufferBlock> block, std::size_t first_vertex, std::size_t vertices_count,
+    std::size_t indices_offset, std::size_t indices_size
+) : block(std::move(block)), first_vertex(first_vertex), vertices_count(vertices_count),
+    indices_offset(indices_offset), indices_size(indices_size) {}
+
+MeshBufferAllocation::~MeshBufferAllocation() {
+    block->get_vertices().free(first_vertex, vertices_count);
+    block->get_indices().free(indices_offset, indices_size);
+
+    // The block itself is destroyed with the last reference, which is ours if the arena releases it.
+    if (block->is_empty()) {
+        if (auto rendering_server = rs_opt()) {
+            rendering_server->_get_mesh_buffer_arena().on_block_emptied(*block);
+        }
+    }
+}
+
+[[nodiscard]] std::unique_ptr<MeshBufferAllocation> MeshBufferArena::allocate(
+    const Mesh::VertexLayout& layout, const void* vertex_data, std::size_t vertices_count,
+    const void* index_data, std::size_t indices_size
+) {
+    auto result = allocate_ranges(layout, vertices_count, indices_size);
+
+    glBindBuffer(GL_ARRAY_BUFFER, result->get_block().get_vertex_buffer_id());
+    glBufferSubData(
+        GL_ARRAY_BUFFER, result->get_first_vertex() * layout.stride,
+        vertices_count * layout.stride, vertex_data
+    );
+    upload_indices(*result, index_data, indices_size);
+
+    return result;
+}
+
+[[nodiscard]] std::unique_ptr<MeshBufferAllocation> MeshBufferArena::allocate_with_vertices_of(
+    const MeshBufferAllocation& source, const Mesh::VertexLayout& layout,
+    const void* index_data, std::size_t indices_size
+) {
+    auto result = allocate_ranges(layout, source.get_vertices_count(), indices_size);
+
+    // Source and destination ranges never overlap, even in the same buffer.
+    glBindBuffer(GL_COPY_READ_BUFFER, source.get_block().get_vertex_buffer_id());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, result->get_block().get_vertex_buffer_id());
+    glCopyBufferSubData(
+        GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+        source.get_first_vertex() * layout.stride, result->get_first_vertex() * layout.stride,
+        source.get_vertices_count() * layout.stride
+    );
+    upload_indices(*result, index_data, indices_size);
+
+    return result;
+}
+
+[[nodiscard]] std::unique_ptr<MeshBufferAllocation> MeshBufferArena::allocate_ranges(
+    const Mesh::VertexLayout& layout, std::size_t vertices_count, std::size_t indices_size
+) {
+    auto& layout_blocks = blocks[layout];
+
+    const auto try_allocate = [&] (const std::shared_ptr<MeshBufferBlock>& block) -> std::unique_ptr<MeshBufferAllocation> {
+        const auto first_vertex = block->get_vertices().allocate(vertices_count);
+        if (!first_vertex.has_value()) {
+            return nullptr;
+        }
+        const auto indices_offset = block->get_indices().allocate(indices_size, INDICES_ALIGNMENT);
+        if (!indices_offset.has_value()) {
+            block->get_vertices().free(*first_vertex, vertices_count);
+            return nullptr;
+        }
+
+        return std::make_unique<MeshBufferAllocation>(
+            block, *first_vertex, vertices_count, *indices_offset, indices_size
+        );
+    };
+
+    for (const auto& block : layout_blocks) {
+        auto result = try_allocate(block);
+        if (result != nullptr) {
+            return result;
+        }
+    }
+
+    const std::size_t regular_vertices_capacity = VERTEX_BLOCK_SIZE / layout.stride;
+    const bool dedicated = vertices_count > regular_vertices_capacity || indices_size > INDEX_BLOCK_SIZE;
+    layout_blocks.push_back(std::make_shared<MeshBufferBlock>(
+        layout, std::max(regular_vertices_capacity, vertices_count),
+        std::max(INDEX_BLOCK_SIZE, indices_size), dedicated
+    ));
+    return try_allocate(layout_blocks.back());
+}
+
+void MeshBufferArena::on_block_emptied(const MeshBufferBlock& block) {
+    for (auto& [layout, layout_blocks] : blocks) {
+        const auto iter = std::find_if(layout_blocks.begin(), layout_blocks.end(), [&] (const auto& layout_block) {
+            return layout_block.get() == &block;
+        });
+        if (iter == layout_blocks.end()) {
+            continue;
+        }
+
+        // One empty regular block is kept, so a mesh reloaded right away doesn't create it again.
+        const auto regular_blocks_count = std::count_if(layout_blocks.begin(), layout_blocks.end(), [] (const auto& layout_block) {
+            return !layout_block->is_dedicated();
+        });
+        if (block.is_dedicated() || regular_blocks_count > 1) {
+            layout_blocks.erase(iter);
+        }
+        return;
+    }
+}
+
+void MeshBufferArena::upload_indices(
+    const MeshBufferAllocation& allocation, const void* index_data, std::size_t indices_size
+) {
+    if (indices_size == 0) {
+        return;
+    }
+
+    // The element array buffer is reachable only through the VAO.
+    rs()._get_gl_state().bind_vertex_array(allocation.get_block().get_vao_id());
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, allocation.get_indices_offset(), indices_size, index_data);
+}
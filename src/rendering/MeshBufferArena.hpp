@@ -0,0 +1,158 @@
+#pragma once
+
+#include "datatypes.hpp"
+#include "rendering/Mesh.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <optional>
+
+namespace llengine {
+/**
+ * @brief First-fit free list over an abstract range of units with
+ * coalescing of adjacent free ranges.
+ */
+class FreeList {
+public:
+    explicit FreeList(std::size_t capacity);
+
+    /**
+     * @brief Finds a free range of the specified size and marks it used.
+     * @return Offset of the allocated range or std::nullopt if there is no
+     * free range large enough.
+     */
+    [[nodiscard]] std::optional<std::size_t> allocate(std::size_t size, std::size_t alignment = 1);
+    void free(std::size_t offset, std::size_t size);
+
+    [[nodiscard]] std::size_t get_capacity() const {
+        return capacity;
+    }
+    [[nodiscard]] std::size_t get_free_size() const {
+        return free_size;
+    }
+
+private:
+    // Offset to size of every free range.
+    std::map<std::size_t, std::size_t> free_ranges;
+    std::size_t capacity;
+    std::size_t free_size;
+};
+
+/**
+ * @brief A pair of big vertex and index buffers with one VAO, shared by
+ * many meshes with the same vertex layout. Buffers have immutable storage
+ * where ARB_buffer_storage is supported.
+ */
+class MeshBufferBlock {
+public:
+    /**
+     * @param dedicated Whether the block is made for a single mesh that doesn't fit into a regular one.
+     */
+    MeshBufferBlock(
+        const Mesh::VertexLayout& layout, std::size_t vertices_capacity, std::size_t indices_capacity,
+        bool dedicated = false
+    );
+    MeshBufferBlock(const MeshBufferBlock& other) = delete;
+    MeshBufferBlock(MeshBufferBlock&& other) = delete;
+    ~MeshBufferBlock();
+
+    MeshBufferBlock& operator=(const MeshBufferBlock& other) = delete;
+    MeshBufferBlock& operator=(MeshBufferBlock&& other) = delete;
+
+    [[nodiscard]] BufferID get_vertex_buffer_id() const { return vertex_buffer_id; }
+    [[nodiscard]] BufferID get_index_buffer_id() const { return index_buffer_id; }
+    [[nodiscard]] VertexArrayID get_vao_id() const { return vao_id; }
+
+    [[nodiscard]] FreeList& get_vertices() { return vertices; }
+    [[nodiscard]] FreeList& get_indices() { return indices; }
+
+    [[nodiscard]] bool is_dedicated() const { return dedicated; }
+    [[nodiscard]] bool is_empty() const {
+        return vertices.get_free_size() == vertices.get_capacity() &&
+            indices.get_free_size() == indices.get_capacity();
+    }
+
+private:
+    BufferID vertex_buffer_id = 0;
+    BufferID index_buffer_id = 0;
+    VertexArrayID vao_id = 0;
+    // In vertices.
+    FreeList vertices;
+    // In bytes.
+    FreeList indices;
+    bool dedicated;
+};
+
+/**
+ * @brief Ranges of a MeshBufferBlock owned by a single mesh. Returns them
+ * to the block on destruction, and the block to the arena if it becomes empty.
+ */
+class MeshBufferAllocation {
+public:
+    MeshBufferAllocation(
+        std::shared_ptr<MeshBufferBlock> block, std::size_t first_vertex, std::size_t vertices_count,
+        std::size_t indices_offset, std::size_t indices_size
+    );
+    MeshBufferAllocation(const MeshBufferAllocation& other) = delete;
+    ~MeshBufferAllocation();
+
+    MeshBufferAllocation& operator=(const MeshBufferAllocation& other) = delete;
+
+    [[nodiscard]] const MeshBufferBlock& get_block() const { return *block; }
+    [[nodiscard]] std::size_t get_first_vertex() const { return first_vertex; }
+    [[nodiscard]] std::size_t get_vertices_count() const { return vertices_count; }
+    // In bytes.
+    [[nodiscard]] std::size_t get_indices_offset() const { return indices_offset; }
+
+private:
+    std::shared_ptr<MeshBufferBlock> block;
+    std::size_t first_vertex;
+    std::size_t vertices_count;
+    std::size_t indices_offset;
+    std::size_t indices_size;
+};
+
+/**
+ * @brief Suballocates mesh data from a few big buffers instead of creating
+ * buffer objects for every mesh.
+ *
+ * Meshes are grouped by their vertex layout, so all meshes in one block
+ * share a VAO and are drawn with base vertex draw calls. Empty blocks are
+ * released, except the first regular block of every layout.
+ */
+class MeshBufferArena {
+public:
+    /**
+     * @brief Allocates space and uploads the interleaved vertex data and
+     * the index data into it.
+     */
+    [[nodiscard]] std::unique_ptr<MeshBufferAllocation> allocate(
+        const Mesh::VertexLayout& layout, const void* vertex_data, std::size_t vertices_count,
+        const void* index_data, std::size_t indices_size
+    );
+    /**
+     * @brief Allocates space, copies vertices of the source allocation into it
+     * on the GPU and uploads the index data.
+     */
+    [[nodiscard]] std::unique_ptr<MeshBufferAllocation> allocate_with_vertices_of(
+        const MeshBufferAllocation& source, const Mesh::VertexLayout& layout,
+        const void* index_data, std::size_t indices_size
+    );
+
+    /**
+     * @brief Called by allocations when the block becomes empty. Releases it
+     * unless it's the only regular block of its layout.
+     */
+    void on_block_emptied(const MeshBufferBlock& block);
+
+private:
+    std::map<Mesh::VertexLayout, std::vector<std::shared_ptr<MeshBufferBlock>>> blocks;
+
+    [[nodiscard]] std::unique_ptr<MeshBufferAllocation> allocate_ranges(
+        const Mesh::VertexLayout& layout, std::size_t vertices_count, std::size_t indices_size
+    );
+    static void upload_indices(const MeshBufferAllocation& allocation, const void* index_data, std::size_t indices_size);
+};
+}
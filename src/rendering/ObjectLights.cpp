@@ -0,0 +1,51 @@
+#include "ObjectLights.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+using namespace llengine;
+
+void ObjectLights::set_lights(std::span<const uniform_blocks::PointLightData> lights) {
+    this->lights.assign(lights.begin(), lights.end());
+}
+
+[[nodiscard]] ObjectLights::Indices ObjectLights::select(const AABB& box) const {
+    Indices result = no_lights();
+    std::array<float, MAX_LIGHTS> relevances {};
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        const uniform_blocks::PointLightData& light = lights[i];
+        const glm::vec3 nearest_point = glm::clamp(light.position, box.point_min, box.point_max);
+        const glm::vec3 offset = nearest_point - light.position;
+        const float distance_squared = glm::dot(offset, offset);
+        if (distance_squared >= light.range * light.range) {
+            continue;
+        }
+
+        // Brightness at the nearest point, with the attenuation of the shader.
+        const float distance_ratio_squared = distance_squared / (light.range * light.range);
+        const float window = 1.0f - distance_ratio_squared * distance_ratio_squared;
+        const float relevance =
+            std::max({light.color.x, light.color.y, light.color.z}) * window * window /
+            std::max(distance_squared, 1e-4f);
+        if (count == MAX_LIGHTS && relevance <= relevances.back()) {
+            continue;
+        }
+
+        // Insert keeping the lights sorted, the dimmest one drops out if there is no place.
+        std::size_t position = std::min(count, MAX_LIGHTS - 1);
+        while (position > 0 && relevances[position - 1] < relevance) {
+            relevances[position] = relevances[position - 1];
+            result[position] = result[position - 1];
+            position--;
+        }
+        relevances[position] = relevance;
+        result[position] = static_cast<std::int32_t>(i);
+        count = std::min(count + 1, MAX_LIGHTS);
+    }
+
+    return result;
+}
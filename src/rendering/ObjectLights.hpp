@@ -0,0 +1,44 @@
+#pragma once
+
+#include "math/AABB.hpp"
+#include "rendering/UniformBlocks.hpp"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief Picks point lights for every object when lights are assigned per object.
+ */
+class ObjectLights {
+public:
+    static constexpr std::size_t MAX_LIGHTS = 8;
+    /**
+     * @brief Indices of lights in the frame block, unused ones are -1.
+     */
+    using Indices = std::array<std::int32_t, MAX_LIGHTS>;
+
+    /**
+     * @brief Sets the lights of the frame block to select from.
+     */
+    void set_lights(std::span<const uniform_blocks::PointLightData> lights);
+
+    /**
+     * @brief Returns lights whose range spheres intersect the box, the brightest
+     * at the nearest point of the box first.
+     */
+    [[nodiscard]] Indices select(const AABB& box) const;
+
+    [[nodiscard]] static constexpr Indices no_lights() {
+        Indices result {};
+        result.fill(-1);
+        return result;
+    }
+
+private:
+    std::vector<uniform_blocks::PointLightData> lights;
+};
+}
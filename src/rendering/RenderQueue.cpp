@@ -0,0 +1,204 @@
+#include "RenderQueue.hpp"
+
+#include <array>
+#include <algorithm>
+
+using namespace llengine;
+
+constexpr std::uint32_t PROGRAM_BITS = 12;
+constexpr std::uint32_t MATERIAL_BITS = 14;
+constexpr std::uint32_t VERTEX_ARRAY_BITS = 8;
+constexpr std::uint32_t MESH_BITS = 16;
+constexpr std::uint32_t DEPTH_BITS = 12;
+// Depth bits above the mesh in the depth pre-pass key.
+constexpr std::uint32_t DEPTH_BUCKET_BITS = 4;
+
+template<typename Key>
+[[nodiscard]] static std::uint32_t get_ordinal(std::unordered_map<Key, std::uint32_t>& ordinals, const Key& key) {
+    const auto ordinal = static_cast<std::uint32_t>(ordinals.size());
+    return ordinals.try_emplace(key, ordinal).first->second;
+}
+
+void RenderQueue::clear() {
+    entries.clear();
+    items.clear();
+    program_ordinals.clear();
+    material_ordinals.clear();
+    vertex_array_ordinals.clear();
+    mesh_ordinals.clear();
+}
+
+void RenderQueue::push(Drawable& drawable, const RenderKeyParts& parts, Pass pass, float max_depth) {
+    const std::uint64_t key = make_key(
+        pass,
+        get_ordinal(program_ordinals, parts.program_id),
+        get_ordinal(material_ordinals, parts.material),
+        get_ordinal(vertex_array_ordinals, parts.vertex_array_id),
+        get_ordinal(mesh_ordinals, parts.mesh),
+        parts.depth / max_depth
+    );
+    items.push_back({key, static_cast<std::uint32_t>(entries.size())});
+    entries.push_back({&drawable, parts});
+}
+
+[[nodiscard]] static bool can_be_instanced_together(const RenderKeyParts& first, const RenderKeyParts& second) {
+    return first.mesh != nullptr && first.program_id != 0 && first.material != nullptr &&
+        first.program_id == second.program_id && first.material == second.material &&
+        first.mesh == second.mesh;
+}
+
+[[nodiscard]] static bool can_be_multi_drawn_together(const RenderKeyParts& first, const RenderKeyParts& second) {
+    return first.mesh != nullptr && second.mesh != nullptr && first.program_id != 0 &&
+        first.material != nullptr && first.vertex_array_id != 0 && first.program_id == second.program_id &&
+        first.material == second.material && first.vertex_array_id == second.vertex_array_id;
+}
+
+[[nodiscard]] RenderStatistics RenderQueue::submit(bool instancing, bool multi_draw) {
+    radix_sort(items, scratch);
+
+    RenderStatistics statistics;
+    const Entry* previous = nullptr;
+    for (std::size_t first = 0; first < items.size();) {
+        const Entry& entry = entries[items[first].entry];
+        const RenderKeyParts& parts = entry.parts;
+
+        // Equal meshes of a material are neighbours, unless their ordinals overflowed.
+        batch.assign(1, entry.drawable);
+        bool multi_drawn = false;
+        std::size_t last = first + 1;
+        for (; last < items.size(); last++) {
+            const RenderKeyParts& next_parts = entries[items[last].entry].parts;
+            if (instancing && can_be_instanced_together(parts, next_parts)) {
+                batch.push_back(entries[items[last].entry].drawable);
+            }
+            else if (multi_draw && can_be_multi_drawn_together(parts, next_parts)) {
+                batch.push_back(entries[items[last].entry].drawable);
+                multi_drawn = true;
+            }
+            else {
+                break;
+            }
+        }
+
+        // Nothing is known about the state left by drawables without a material,
+        // and zero IDs are not created yet, so everything is bound again.
+        RenderStateChanges changes;
+        if (previous != nullptr && previous->parts.material != nullptr && parts.material != nullptr) {
+            changes.program = parts.program_id == 0 || parts.program_id != previous->parts.program_id;
+            changes.material = changes.program || parts.material != previous->parts.material;
+            changes.vertex_array = parts.vertex_array_id == 0 ||
+                parts.vertex_array_id != previous->parts.vertex_array_id;
+        }
+
+        if (batch.size() == 1) {
+            entry.drawable->draw_queued(changes);
+        }
+        else if (multi_drawn) {
+            entry.drawable->draw_queued_multi(changes, batch);
+        }
+        else {
+            entry.drawable->draw_queued_instances(changes, batch);
+        }
+
+        statistics.draws_count++;
+        statistics.objects_count += batch.size();
+        statistics.program_changes += changes.program;
+        statistics.material_changes += changes.material;
+        statistics.vertex_array_changes += changes.vertex_array;
+        previous = &entries[items[last - 1].entry];
+        first = last;
+    }
+
+    return statistics;
+}
+
+[[nodiscard]] std::size_t RenderQueue::submit_depth_prepass() {
+    // Coarse depth goes before the mesh and fine depth after it, the rest of the key is not needed.
+    constexpr std::uint32_t FINE_DEPTH_BITS = DEPTH_BITS - DEPTH_BUCKET_BITS;
+    depth_items.clear();
+    for (const Item& item : items) {
+        const std::uint64_t depth = item.key & ((1u << DEPTH_BITS) - 1);
+        const std::uint64_t mesh = (item.key >> DEPTH_BITS) & ((1u << MESH_BITS) - 1);
+        const std::uint64_t bucket = depth >> FINE_DEPTH_BITS;
+        const std::uint64_t fine_depth = depth & ((1u << FINE_DEPTH_BITS) - 1);
+        depth_items.push_back({
+            (bucket << (MESH_BITS + FINE_DEPTH_BITS)) | (mesh << FINE_DEPTH_BITS) | fine_depth, item.entry
+        });
+    }
+    radix_sort(depth_items, scratch);
+
+    std::size_t draws_count = 0;
+    for (std::size_t first = 0; first < depth_items.size();) {
+        const Entry& entry = entries[depth_items[first].entry];
+        batch.assign(1, entry.drawable);
+        std::size_t last = first + 1;
+        for (; last < depth_items.size(); last++) {
+            const Entry& next_entry = entries[depth_items[last].entry];
+            if (
+                entry.parts.mesh == nullptr || entry.parts.mesh != next_entry.parts.mesh ||
+                entry.parts.program_id != next_entry.parts.program_id
+            ) {
+                break;
+            }
+            batch.push_back(next_entry.drawable);
+        }
+
+        draws_count += entry.drawable->draw_to_depth_prepass(batch);
+        first = last;
+    }
+
+    return draws_count;
+}
+
+[[nodiscard]] std::uint64_t RenderQueue::make_key(
+    Pass pass, std::uint32_t program, std::uint32_t material,
+    std::uint32_t vertex_array, std::uint32_t mesh, float normalized_depth
+) {
+    constexpr float MAX_DEPTH = static_cast<float>((1u << DEPTH_BITS) - 1);
+    // Also maps NaN to zero.
+    const float clamped_depth = normalized_depth > 0.0f ? std::min(normalized_depth, 1.0f) : 0.0f;
+    const auto depth = static_cast<std::uint32_t>(clamped_depth * MAX_DEPTH + 0.5f);
+
+    // Ordinals beyond the field share the last value, the order among them is lost.
+    std::uint64_t key = static_cast<std::uint64_t>(pass);
+    key = (key << PROGRAM_BITS) | std::min(program, (1u << PROGRAM_BITS) - 1);
+    key = (key << MATERIAL_BITS) | std::min(material, (1u << MATERIAL_BITS) - 1);
+    key = (key << VERTEX_ARRAY_BITS) | std::min(vertex_array, (1u << VERTEX_ARRAY_BITS) - 1);
+    key = (key << MESH_BITS) | std::min(mesh, (1u << MESH_BITS) - 1);
+    key = (key << DEPTH_BITS) | depth;
+    return key;
+}
+
+void RenderQueue::radix_sort(std::vector<Item>& items, std::vector<Item>& scratch) {
+    if (items.empty()) {
+        return;
+    }
+
+    constexpr std::size_t DIGITS_COUNT = sizeof(std::uint64_t);
+    std::array<std::array<std::uint32_t, 256>, DIGITS_COUNT> histograms {};
+    for (const Item& item : items) {
+        for (std::size_t digit = 0; digit < DIGITS_COUNT; digit++) {
+            histograms[digit][(item.key >> (digit * 8)) & 0xFFu]++;
+        }
+    }
+
+    scratch.resize(items.size());
+    for (std::size_t digit = 0; digit < DIGITS_COUNT; digit++) {
+        auto& histogram = histograms[digit];
+        const std::size_t shift = digit * 8;
+        if (histogram[(items.front().key >> shift) & 0xFFu] == items.size()) {
+            continue;
+        }
+
+        std::uint32_t offset = 0;
+        for (std::uint32_t& count : histogram) {
+            const std::uint32_t bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const Item& item : items) {
+            scratch[histogram[(item.key >> shift) & 0xFFu]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "nodes/rendering/Drawable.hpp"
+#include "rendering/RenderStatistics.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace llengine {
+/**
+ * @brief Collects drawables of a frame and submits them ordered by
+ * 64-bit keys, so drawables sharing a program, material or vertex array
+ * are drawn one after another.
+ *
+ * Key layout from the most significant bit: pass (2 bits), program (12 bits),
+ * material (14 bits), vertex array (8 bits), mesh (16 bits), quantized depth
+ * (12 bits). Programs, materials, vertex arrays and meshes are numbered in
+ * order of their first appearance in the frame.
+ */
+class RenderQueue {
+public:
+    enum class Pass : std::uint8_t {
+        OPAQUE = 0
+    };
+
+    struct Item {
+        std::uint64_t key;
+        std::uint32_t entry;
+    };
+
+    void clear();
+    /**
+     * @param max_depth Depth mapped to the largest quantized value, usually
+     * the camera far distance. Greater depths are clamped.
+     */
+    void push(Drawable& drawable, const RenderKeyParts& parts, Pass pass, float max_depth);
+    /**
+     * @brief Draws all pushed drawables ordered by their keys.
+     * @param instancing Whether to draw neighbours with the same mesh together.
+     * @param multi_draw Whether to draw neighbours with the same vertex array,
+     * but different meshes, together.
+     */
+    [[nodiscard]] RenderStatistics submit(bool instancing, bool multi_draw = false);
+    /**
+     * @brief Draws depth of all pushed drawables roughly front to back, instancing
+     * neighbours with the same program and mesh.
+     *
+     * Drawables are ordered by coarse depth buckets first and by mesh inside
+     * of them, so equal meshes at similar depths are drawn together.
+     * @return Amount of draws.
+     */
+    [[nodiscard]] std::size_t submit_depth_prepass();
+
+    [[nodiscard]] static std::uint64_t make_key(
+        Pass pass, std::uint32_t program, std::uint32_t material,
+        std::uint32_t vertex_array, std::uint32_t mesh, float normalized_depth
+    );
+    /**
+     * @brief Stable LSD radix sort by keys, one byte per pass. Passes over
+     * bytes that are equal in all keys are skipped.
+     * @param scratch Buffer for the intermediate results, resized if needed.
+     */
+    static void radix_sort(std::vector<Item>& items, std::vector<Item>& scratch);
+
+private:
+    struct Entry {
+        Drawable* drawable;
+        RenderKeyParts parts;
+    };
+    std::vector<Entry> entries;
+    std::vector<Item> items;
+    std::vector<Item> depth_items;
+    std::vector<Item> scratch;
+    std::vector<Drawable*> batch;
+
+    std::unordered_map<ShaderID, std::uint32_t> program_ordinals;
+    std::unordered_map<const void*, std::uint32_t> material_ordinals;
+    std::unordered_map<VertexArrayID, std::uint32_t> vertex_array_ordinals;
+    std::unordered_map<const void*, std::uint32_t> mesh_ordinals;
+};
+}
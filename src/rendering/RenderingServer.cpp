@@ -3,8 +3,23 @@
 #include "rendering/GLFWWindow.hpp" // GLFWWindow
 #include "nodes/rendering/CameraNode.hpp"
 #include "nodes/rendering/Drawable.hpp"
+#include "nodes/rendering/PointLightNode.hpp"
 #include "nodes/gui/GUICanvas.hpp"
+#include "GLStateTracker.hpp"
 #include "MainFramebuffer.hpp"
+#include "TextureUploader.hpp"
+#include "MeshBufferArena.hpp"
+#include "RenderQueue.hpp"
+#include "DrawRecorder.hpp"
+#include "utils/WorkerPool.hpp"
+#include "InstanceBuffer.hpp"
+#include "DrawIndirectBuffer.hpp"
+#include "LightClusterBuffer.hpp"
+#include "ObjectLights.hpp"
+#include "SamplesPassedQuery.hpp"
+#include "UniformRingBuffer.hpp"
+#include "MaterialBlockCache.hpp"
+#include "rendering/Mesh.hpp"
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -17,15 +32,39 @@ using namespace llengine;
 static RenderingServer* current_rendering_server = nullptr;
 static std::uint32_t next_context_id = 0;
 
-RenderingServer::RenderingServer(glm::ivec2 window_size, std::string_view window_title) :
-    window(GLFWWindow(window_size, window_title, 3, 3)) {
-    main_framebuffer = std::make_unique<MainFramebuffer>(window_size);
+// Limits time spent on texture streaming in a single frame.
+constexpr std::size_t TEXTURE_UPLOAD_BYTES_PER_FRAME = 32 * 1024 * 1024;
+
+RenderingServer::RenderingServer(
+    glm::ivec2 window_size, std::string_view window_title, int gl_version_major, int gl_version_minor
+) : window(GLFWWindow(window_size, window_title, gl_version_major, gl_version_minor)) {
+    // Members below create OpenGL objects through the state tracker.
     current_rendering_server = this;
+    gl_state = std::make_unique<GLStateTracker>();
+    main_framebuffer = std::make_unique<MainFramebuffer>(window_size);
+    texture_uploader = std::make_unique<TextureUploader>();
+    // VAOs of the arena read instance indices from the instance buffer.
+    instance_buffer = std::make_unique<InstanceBuffer>();
+    if (DrawIndirectBuffer::is_supported()) {
+        draw_indirect_buffer = std::make_unique<DrawIndirectBuffer>();
+    }
+    light_cluster_buffer = std::make_unique<LightClusterBuffer>();
+    object_lights = std::make_unique<ObjectLights>();
+    opaque_samples_query = std::make_unique<SamplesPassedQuery>();
+    mesh_buffer_arena = std::make_unique<MeshBufferArena>();
+    render_queue = std::make_unique<RenderQueue>();
+    draw_recorder = std::make_unique<DrawRecorder>();
+    worker_pool = std::make_unique<WorkerPool>();
+    uniform_ring_buffer = std::make_unique<UniformRingBuffer>();
+    material_block_cache = std::make_unique<MaterialBlockCache>();
     context_id = next_context_id++;
 }
 
 RenderingServer::~RenderingServer() {
-
+    // Objects destroyed after it must not reach the destroyed members.
+    if (current_rendering_server == this) {
+        current_rendering_server = nullptr;
+    }
 }
 
 [[nodiscard]] RenderingServer& RenderingServer::current() {
@@ -44,13 +83,13 @@ RenderingServer::~RenderingServer() {
     return current().context_id;
 }
 
-void RenderingServer::set_cubemap(const std::shared_ptr<Texture>& cubemap) {
+void RenderingServer::set_cubemap(const std::shared_ptr<Texture>& cubemap, std::optional<std::uint64_t> source_hash) {
     if (cubemap->get_type() != Texture::Type::TEX_CUBEMAP) {
         throw std::invalid_argument("Specified cubemap texture for skybox is not actually a cubemap.");
     }
 
     this->skybox = std::make_unique<Skybox>(cubemap);
-    this->global_lighting_environment.set_base_cubemap(cubemap);
+    this->global_lighting_environment.set_base_cubemap(cubemap, source_hash);
 }
 
 void RenderingServer::main_loop() {
@@ -63,12 +102,16 @@ void RenderingServer::main_loop() {
         auto duration = now - prev_frame_time;
         prev_frame_time = now;
         delta_time = std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
+        frame_index++;
+        gl_state->reset_skipped_calls();
 
         unblock_mouse_press();
 
         // Invoke callback.
         update_callback(delta_time);
 
+        texture_uploader->process_pending_uploads(TEXTURE_UPLOAD_BYTES_PER_FRAME);
+
         main_framebuffer->assign_framebuffer_size(get_window().get_framebuffer_size());
         glBindFramebuffer(GL_FRAMEBUFFER, main_framebuffer->get_framebuffer_id());
         glClear(GL_DEPTH_BUFFER_BIT);
@@ -78,21 +121,22 @@ void RenderingServer::main_loop() {
 
         // Draw skybox.
         if (skybox != nullptr) {
-            glDepthMask(GL_FALSE);
+            gl_state->set_depth_mask(false);
             skybox->draw(*this);
-            glDepthMask(GL_TRUE);
+            gl_state->set_depth_mask(true);
         }
 
         // Draw overlay objects.
         glClear(GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl_state->set_blending(true);
+        gl_state->set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         for (GUICanvas* canvas : gui_canvases) {
             canvas->draw();
         }
-        glDisable(GL_BLEND);
+        gl_state->set_blending(false);
 
         main_framebuffer->render_to_window(delta_time);
+        render_statistics.skipped_state_calls = gl_state->get_skipped_calls();
 
         window.swap_buffers();
         glfwPollEvents();
@@ -123,6 +167,42 @@ void RenderingServer::block_mouse_press() {
     return main_framebuffer->get_framebuffer_id();
 }
 
+[[nodiscard]] GLStateTracker& RenderingServer::_get_gl_state() {
+    return *gl_state;
+}
+
+[[nodiscard]] TextureUploader& RenderingServer::_get_texture_uploader() {
+    return *texture_uploader;
+}
+
+[[nodiscard]] MeshBufferArena& RenderingServer::_get_mesh_buffer_arena() {
+    return *mesh_buffer_arena;
+}
+
+[[nodiscard]] InstanceBuffer& RenderingServer::_get_instance_buffer() {
+    return *instance_buffer;
+}
+
+[[nodiscard]] DrawIndirectBuffer* RenderingServer::_get_draw_indirect_buffer() {
+    return draw_indirect_buffer.get();
+}
+
+[[nodiscard]] LightClusterBuffer& RenderingServer::_get_light_cluster_buffer() {
+    return *light_cluster_buffer;
+}
+
+[[nodiscard]] const ObjectLights& RenderingServer::_get_object_lights() const {
+    return *object_lights;
+}
+
+[[nodiscard]] UniformRingBuffer& RenderingServer::_get_uniform_ring_buffer() {
+    return *uniform_ring_buffer;
+}
+
+[[nodiscard]] MaterialBlockCache& RenderingServer::_get_material_block_cache() {
+    return *material_block_cache;
+}
+
 void RenderingServer::unblock_mouse_press() {
     mouse_button_blocked = false;
 }
@@ -150,12 +230,12 @@ void RenderingServer::apply_quality_settings(const QualitySettings& settings) {
 
 void RenderingServer::enable_face_culling() {
     face_culling_enabled = true;
-    glCullFace(GL_TRUE);
+    gl_state->set_face_culling(true);
 }
 
 void RenderingServer::disable_face_culling() {
     face_culling_enabled = false;
-    glCullFace(GL_FALSE);
+    gl_state->set_face_culling(false);
 }
 
 void RenderingServer::register_drawable(Drawable* drawable) noexcept {
@@ -242,13 +322,132 @@ void RenderingServer::unregister_point_light(PointLightNode* point_light) noexce
 }
 
 void RenderingServer::draw_non_overlay_objects() {
-    const Frustum frustum = get_current_camera_node().get_frustum();
+    const CameraNode& camera_node = get_current_camera_node();
+    camera_frustum = camera_node.get_frustum();
+    const glm::vec3 camera_position = camera_node.get_global_position();
 
-    for (const auto& cur_drawable : get_drawables()) {
-        if (cur_drawable->is_enabled() && !cur_drawable->is_outside_the_frustum(frustum)) {
-            cur_drawable->draw();
+    bind_frame_uniform_block(camera_node);
+
+    draw_recorder->record(
+        get_drawables(), camera_frustum, camera_position,
+        quality_settings.parallel_draw_recording ? worker_pool.get() : nullptr
+    );
+    render_queue->clear();
+    draw_recorder->replay([&] (Drawable& drawable, const RenderKeyParts& parts) {
+        render_queue->push(drawable, parts, RenderQueue::Pass::OPAQUE, camera_node.get_far_distance());
+    });
+
+    instance_buffer->begin_frame();
+    const bool multi_draw = quality_settings.multi_draw_indirect_enabled && draw_indirect_buffer != nullptr;
+    if (multi_draw) {
+        draw_indirect_buffer->begin_frame();
+    }
+
+    std::size_t depth_prepass_draws_count = 0;
+    if (quality_settings.depth_prepass_enabled) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        depth_prepass_draws_count = render_queue->submit_depth_prepass();
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    opaque_samples_query->begin();
+    render_statistics = render_queue->submit(quality_settings.instancing_enabled, multi_draw);
+    opaque_samples_query->end();
+
+    render_statistics.depth_prepass_draws_count = depth_prepass_draws_count;
+    if (const auto samples = opaque_samples_query->get_latest_result()) {
+        const glm::u32vec2 framebuffer_size = get_window().get_framebuffer_size();
+        render_statistics.overdraw = static_cast<float>(*samples) /
+            static_cast<float>(std::max(framebuffer_size.x * framebuffer_size.y, 1u));
+    }
+}
+
+void RenderingServer::bind_frame_uniform_block(const CameraNode& camera_node) {
+    uniform_blocks::FrameBlock block {};
+    block.view_proj_matrix = camera_node.get_view_proj_matrix();
+    block.camera_position = camera_node.get_global_position();
+    block.ambient = glm::vec3(0.01f, 0.01f, 0.01f);
+
+    if (shadow_map.has_value()) {
+        assert(shadow_map->get_size().x == shadow_map->get_size().y);
+        block.shadow_view_proj_matrix = shadow_map->get_view_proj_matrix();
+        block.shadow_light_direction = shadow_map->get_light_direction();
+        block.shadow_map_bias_at_45_deg = shadow_map->get_adjusted_bias_at_45_deg();
+        block.pcf_sparsity = 1.0f / shadow_map->get_size().x;
+    }
+
+    if (quality_settings.sh_irradiance_enabled && global_lighting_environment.get_base_cubemap() != nullptr) {
+        const auto& irradiance_sh = global_lighting_environment.get_irradiance_sh().value();
+        for (std::size_t i = 0; i < SphericalHarmonics::COEFFICIENTS_COUNT; i++) {
+            block.sh_coefficients[i] = glm::vec4(irradiance_sh.coefficients[i], 0.0f);
         }
     }
+
+    // Lights beyond the block capacity are ignored.
+    const std::size_t point_lights_count = std::min(point_lights.size(), uniform_blocks::MAX_POINT_LIGHTS);
+    block.point_lights_count = static_cast<std::int32_t>(point_lights_count);
+    for (std::size_t i = 0; i < point_lights_count; i++) {
+        block.point_lights[i].position = point_lights[i]->get_global_position();
+        block.point_lights[i].color = point_lights[i]->color;
+        block.point_lights[i].range = point_lights[i]->get_effective_range();
+    }
+
+    block.light_assignment = static_cast<std::int32_t>(quality_settings.light_assignment);
+    object_lights->set_lights(
+        quality_settings.light_assignment == LightAssignment::PER_OBJECT ?
+        std::span(block.point_lights.data(), point_lights_count) : std::span<const uniform_blocks::PointLightData>()
+    );
+    if (quality_settings.light_assignment == LightAssignment::CLUSTERED) {
+        light_cluster_buffer->update(camera_node, std::span(block.point_lights.data(), point_lights_count));
+
+        const glm::vec2 framebuffer_size {get_window().get_framebuffer_size()};
+        block.camera_forward = camera_node.get_direction();
+        block.cluster_xy_scale = glm::vec2(LightClusterGrid::SIZE_X, LightClusterGrid::SIZE_Y) / framebuffer_size;
+        block.cluster_z_scale = light_cluster_buffer->get_grid().get_z_scale();
+        block.cluster_z_bias = light_cluster_buffer->get_grid().get_z_bias();
+    }
+
+    uniform_ring_buffer->bind_block(uniform_blocks::FRAME_BINDING, block);
+}
+
+void RenderingServer::_draw_mesh_culled(const Mesh& mesh, const glm::mat4& model_matrix) {
+    const std::vector<Meshlet>& meshlets = mesh.get_meshlets();
+    if (meshlets.empty() || !quality_settings.meshlet_culling_enabled) {
+        mesh.draw();
+        return;
+    }
+
+    // Bounding spheres are tested in the world space, cones in the model space.
+    const glm::mat3 linear_part {model_matrix};
+    const float max_scale = std::max({
+        glm::length(linear_part[0]), glm::length(linear_part[1]), glm::length(linear_part[2])
+    });
+    const glm::vec3 camera_position {
+        glm::inverse(model_matrix) * glm::vec4(get_current_camera_node().get_global_position(), 1.0f)
+    };
+    // Mirroring transforms swap front and back faces.
+    const bool cone_culling = face_culling_enabled && glm::determinant(linear_part) > 0.0f;
+
+    std::vector<std::uint32_t> visible_meshlets;
+    visible_meshlets.reserve(meshlets.size());
+    for (std::uint32_t i = 0; i < meshlets.size(); i++) {
+        const Meshlet& meshlet = meshlets[i];
+        const glm::vec3 center {model_matrix * glm::vec4(meshlet.bounding_sphere_center, 1.0f)};
+        if (!camera_frustum.is_sphere_on_frustum(center, meshlet.bounding_sphere_radius * max_scale)) {
+            continue;
+        }
+        if (cone_culling && meshlet.is_backfacing(camera_position)) {
+            continue;
+        }
+        visible_meshlets.push_back(i);
+    }
+
+    if (visible_meshlets.size() == meshlets.size()) {
+        mesh.draw();
+    }
+    else {
+        mesh.draw_meshlets(visible_meshlets);
+    }
 }
 
 void RenderingServer::update_shadow_map() {
@@ -0,0 +1,44 @@
+#include "SamplesPassedQuery.hpp"
+
+#include <GL/glew.h>
+
+using namespace llengine;
+
+SamplesPassedQuery::SamplesPassedQuery() {
+    glGenQueries(static_cast<GLsizei>(query_ids.size()), query_ids.data());
+}
+
+SamplesPassedQuery::~SamplesPassedQuery() {
+    glDeleteQueries(static_cast<GLsizei>(query_ids.size()), query_ids.data());
+}
+
+void SamplesPassedQuery::begin() {
+    // The query issued FRAMES_COUNT frames ago is reused.
+    const QueryID query_id = query_ids[current_query];
+    if (issued[current_query]) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query_id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != GL_TRUE) {
+            // Waiting would stall, so this frame isn't measured and the query keeps its slot.
+            measuring = false;
+            return;
+        }
+
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(query_id, GL_QUERY_RESULT, &samples);
+        latest_result = samples;
+    }
+
+    glBeginQuery(GL_SAMPLES_PASSED, query_id);
+    measuring = true;
+}
+
+void SamplesPassedQuery::end() {
+    if (!measuring) {
+        return;
+    }
+
+    glEndQuery(GL_SAMPLES_PASSED);
+    issued[current_query] = true;
+    current_query = (current_query + 1) % FRAMES_COUNT;
+}
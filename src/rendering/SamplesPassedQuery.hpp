@@ -0,0 +1,45 @@
+#pragma once
+
+#include "datatypes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace llengine {
+/**
+ * @brief Counts samples that passed the depth test between begin and end
+ * once a frame. Results are read FRAMES_COUNT frames later, when they are
+ * ready, so reading them doesn't stall. If the GPU is even further behind,
+ * the frame isn't measured and the previous result is kept.
+ */
+class SamplesPassedQuery {
+public:
+    SamplesPassedQuery();
+    SamplesPassedQuery(const SamplesPassedQuery& other) = delete;
+    SamplesPassedQuery(SamplesPassedQuery&& other) = delete;
+    ~SamplesPassedQuery();
+
+    SamplesPassedQuery& operator=(const SamplesPassedQuery& other) = delete;
+    SamplesPassedQuery& operator=(SamplesPassedQuery&& other) = delete;
+
+    void begin();
+    void end();
+
+    /**
+     * @brief Returns the result of the latest finished query, if there is any.
+     */
+    [[nodiscard]] std::optional<std::uint64_t> get_latest_result() const noexcept { return latest_result; }
+
+    static constexpr std::size_t FRAMES_COUNT = 3;
+
+private:
+    std::array<QueryID, FRAMES_COUNT> query_ids {};
+    std::array<bool, FRAMES_COUNT> issued {};
+    std::size_t current_query = 0;
+    // Whether the query was begun in this frame.
+    bool measuring = false;
+    std::optional<std::uint64_t> latest_result;
+};
+}
@@ -1,4 +1,6 @@
 #include "rendering/Shader.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
 #include "utils/shader_loader.hpp"
 
 #include <GL/glew.h>
@@ -6,7 +8,7 @@
 
 namespace llengine::internal {
 void use_shader(ShaderID shader_id) {
-    glUseProgram(shader_id);
+    rs()._get_gl_state().use_program(shader_id);
 }
 
 void set_int(ShaderID shader_id, ShaderUniformID uniform_id, std::int32_t value) {
@@ -43,8 +45,7 @@ void set_mat4(ShaderID shader_id, ShaderUniformID uniform_id, const glm::mat4& v
 
 static void bind_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id, GraphicsAPIEnum target) {
     glUniform1i(uniform_id, unit);
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(target, texture_id);
+    rs()._get_gl_state().bind_texture(unit, target, texture_id);
 }
 
 void bind_1d_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id) {
@@ -59,6 +60,10 @@ void bind_cubemap_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, Text
     bind_texture(uniform_id, unit, texture_id, GL_TEXTURE_CUBE_MAP);
 }
 
+void bind_buffer_texture(ShaderUniformID uniform_id, GraphicsAPIEnum unit, TextureID texture_id) {
+    bind_texture(uniform_id, unit, texture_id, GL_TEXTURE_BUFFER);
+}
+
 void load_shader(
     std::string_view vertex_shader_code, std::string_view fragment_shader_code,
     const std::vector<std::string>& defines, ShaderID& id_out
@@ -1,4 +1,6 @@
 #include "rendering/ShadowMap.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
 
 #include <GL/glew.h>
 
@@ -12,7 +14,7 @@ ShadowMap::ShadowMap(glm::u32vec2 size) {
 
     glGenFramebuffers(1, &framebuffer.get_ref());
     glGenTextures(1, &texture_id.get_ref());
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, size.x, size.y, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -122,14 +124,14 @@ void ShadowMap::prepare_for_drawing() {
     glViewport(0, 0, get_size().x, get_size().y);
     glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
     glClear(GL_DEPTH_BUFFER_BIT);
-    glDisable(GL_CULL_FACE);
+    rs()._get_gl_state().set_face_culling(false);
 }
 
 void ShadowMap::finish_drawing(
     bool enable_face_culling, FramebufferID default_framebuffer, glm::u32vec2 default_framebuffer_size
 ) {
     if (enable_face_culling) {
-        glEnable(GL_CULL_FACE);
+        rs()._get_gl_state().set_face_culling(true);
     }
     glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer);
     const auto framebuffer_size = default_framebuffer_size;
@@ -2,6 +2,7 @@
 
 #include "rendering/Skybox.hpp" // Skybox
 #include "rendering/RenderingServer.hpp" // RenderingServer
+#include "GLStateTracker.hpp"
 #include "rendering/Mesh.hpp"
 #include "nodes/rendering/CameraNode.hpp"
 
@@ -36,13 +37,8 @@ void Skybox::draw(RenderingServer& rs) {
 
     shader->use_shader();
     shader->set_mat4<"mvp">(mvp);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_texture->get_id());
+    rs._get_gl_state().bind_texture(0, GL_TEXTURE_CUBE_MAP, cubemap_texture->get_id());
 
     cube_mesh->bind_vao(false, false, false);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_mesh->get_indices_id());
-    glDrawElements(GL_TRIANGLES, cube_mesh->get_amount_of_vertices(), cube_mesh->get_indices_type(), nullptr);
-
-    cube_mesh->unbind_vao(false, false, false);
+    cube_mesh->draw();
 }
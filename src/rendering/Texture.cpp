@@ -2,6 +2,8 @@
 #include "datatypes.hpp"
 #include "NodeProperty.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
+#include "TextureUploader.hpp"
 
 #include <glm/mat4x4.hpp>
 #include <GL/glew.h>
@@ -21,6 +23,20 @@ TexLoadingParams::TexLoadingParams() {
     file_path = "";
     offset = 0;
     size = 0;
+    mime_type = "";
+}
+
+[[nodiscard]] TexLoadingParams TexLoadingParams::from_property(const NodeProperty& property) {
+    if (property.get<std::string>("type") != "texture") {
+        throw std::runtime_error("Failed to load a texture from node property: invalid property type.");
+    }
+
+    TexLoadingParams params;
+    params.file_path = property.get<std::string>("path");
+    params.offset = property.get_optional<std::int64_t>("offset").value_or(0);
+    params.size = property.get_optional<std::int64_t>("size").value_or(0);
+
+    return params;
 }
 
 ManagedTextureID::ManagedTextureID() = default;
@@ -61,6 +77,13 @@ void ManagedTextureID::set_id(TextureID id) {
 }
 
 void ManagedTextureID::delete_texture() {
+    if (id == 0) {
+        return;
+    }
+
+    if (auto rendering_server = rs_opt()) {
+        rendering_server->_get_gl_state().forget_texture(id);
+    }
     glDeleteTextures(1, &id);
     id = 0;
 }
@@ -131,6 +154,21 @@ static std::pair<GLenum, GLenum> opengl_format_and_internal_format(Texture::Form
     }
 }
 
+static std::size_t opengl_components_count(GLenum format) {
+    switch (format) {
+    case GL_RED:
+        return 1;
+    case GL_RG:
+        return 2;
+    case GL_RGB:
+        return 3;
+    case GL_RGBA:
+        return 4;
+    default:
+        throw std::runtime_error("Invalid pixel format specified.");
+    }
+}
+
 static GLenum opengl_target(Texture::Type type) {
     switch (type) {
     case Texture::Type::TEX_1D:
@@ -144,6 +182,52 @@ static GLenum opengl_target(Texture::Type type) {
     }
 }
 
+[[nodiscard]] std::size_t Texture::compute_memory_usage() const {
+    if (texture_id == 0) {
+        return 0;
+    }
+
+    const GLenum target = opengl_target(type);
+    const GLenum level_target = type == Type::TEX_CUBEMAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+    const std::size_t faces_count = type == Type::TEX_CUBEMAP ? 6 : 1;
+
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, target, texture_id);
+
+    GLint max_level = 0;
+    glGetTexParameteriv(target, GL_TEXTURE_MAX_LEVEL, &max_level);
+
+    std::size_t result = 0;
+    for (GLint level = 0; level <= max_level; level++) {
+        GLint width = 0, height = 0;
+        glGetTexLevelParameteriv(level_target, level, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(level_target, level, GL_TEXTURE_HEIGHT, &height);
+        if (width == 0 || height == 0) {
+            // There are no more allocated levels.
+            break;
+        }
+
+        GLint is_compressed = GL_FALSE;
+        glGetTexLevelParameteriv(level_target, level, GL_TEXTURE_COMPRESSED, &is_compressed);
+        if (is_compressed) {
+            GLint compressed_size = 0;
+            glGetTexLevelParameteriv(level_target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressed_size);
+            result += static_cast<std::size_t>(compressed_size) * faces_count;
+            continue;
+        }
+
+        GLint bits_per_pixel = 0;
+        for (GLenum component : {GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE}) {
+            GLint component_size = 0;
+            glGetTexLevelParameteriv(level_target, level, component, &component_size);
+            bits_per_pixel += component_size;
+        }
+        result += static_cast<std::size_t>(width) * height * bits_per_pixel / 8 * faces_count;
+    }
+
+    return result;
+}
+
 template<typename T>
 static GLenum opengl_type() {
     if constexpr (std::is_same_v<T, float>) {
@@ -173,22 +257,34 @@ template<typename T>
     throw_if_invalid_format<T>(format);
     auto [gl_format, gl_internal_format] = opengl_format_and_internal_format(format);
 
+    const GLenum gl_type = opengl_type<T>();
+
     GLuint texture_id {};
     glGenTextures(1, &texture_id);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(target, texture_id);
-    
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, target, texture_id);
+
+    // Only allocate storage here, pixel data goes through the staging buffers.
+    TextureUploader::Destination destination;
+    destination.texture_id = texture_id;
+    destination.target = target;
+    destination.size = resolution;
+    destination.format = gl_format;
+    destination.type = gl_type;
+    destination.pixel_size = opengl_components_count(gl_format) * sizeof(T);
+
     switch (type) {
     case Type::TEX_1D:
         glTexImage1D(
             target, 0, gl_internal_format, resolution.x, 0,
-            gl_format, std::is_same_v<T, float> ? GL_FLOAT : GL_BYTE, pixel_data
+            gl_format, gl_type, nullptr
         );
+        destination.size.y = 1;
         break;
     case Type::TEX_2D:
         glTexImage2D(
             target, 0, gl_internal_format, resolution.x, resolution.y, 0,
-            gl_format, std::is_same_v<T, float> ? GL_FLOAT : GL_BYTE, pixel_data
+            gl_format, gl_type, nullptr
         );
         glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         break;
@@ -196,7 +292,7 @@ template<typename T>
         for (std::size_t i = 0; i < 6; i++) {
             glTexImage2D(
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GraphicsAPIEnum>(i), 0, gl_internal_format,
-                resolution.x, resolution.y, 0, gl_format, std::is_same_v<T, float> ? GL_FLOAT : GL_BYTE, pixel_data
+                resolution.x, resolution.y, 0, gl_format, gl_type, nullptr
             );
             glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
@@ -214,6 +310,19 @@ template<typename T>
         anisotropy_override == 0.0f ? rs().get_quality_settings().anisotropy : anisotropy_override
     );
 
+    // Upload may rebind textures, so it goes after all the parameters are set.
+    auto& uploader = rs()._get_texture_uploader();
+    if (type == Type::TEX_CUBEMAP) {
+        for (std::size_t i = 0; i < 6; i++) {
+            destination.image_target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GraphicsAPIEnum>(i);
+            uploader.upload(destination, pixel_data);
+        }
+    }
+    else {
+        destination.image_target = target;
+        uploader.upload(destination, pixel_data);
+    }
+
     return Texture(texture_id, resolution, type);
 }
 
@@ -247,6 +356,13 @@ template<std::size_t ArraySize>
 }
 
 [[nodiscard]] Texture Texture::from_file(const TexLoadingParams& params) {
+    if (params.mime_type == "image/ktx" || params.mime_type == "image/ktx2") {
+        return from_ktx(params);
+    }
+    else if (params.mime_type == "image/x-hdr") {
+        return from_rgbe(params);
+    }
+
     // Try to determine the file type with extension, if the file must be readed as a whole.
     if (params.offset == 0 && params.size == 0) {
         if (params.file_path.ends_with(".ktx") || params.file_path.ends_with(".ktx2")) {
@@ -275,25 +391,11 @@ template<std::size_t ArraySize>
 }
 
 [[nodiscard]] Texture Texture::from_file(const TexLoadingParams& params, const std::string& mime_type) {
-    if (mime_type == "image/ktx" || mime_type == "image/ktx2") {
-        return from_ktx(params);
-    }
-    else if (mime_type == "image/x-hdr") {
-        return from_rgbe(params);
-    }
-
-    return from_file(params);
+    TexLoadingParams params_with_mime_type = params;
+    params_with_mime_type.mime_type = mime_type;
+    return from_file(params_with_mime_type);
 }
 
 [[nodiscard]] Texture Texture::from_property(const NodeProperty& property) {
-    if (property.get<std::string>("type") != "texture") {
-        throw std::runtime_error("Failed to load a texture from node property: invalid property type.");
-    }
-
-    TexLoadingParams params;
-    params.file_path = property.get<std::string>("path");
-    params.offset = property.get_optional<std::int64_t>("offset").value_or(0);
-    params.size = property.get_optional<std::int64_t>("size").value_or(0);
-
-    return from_file(params);
+    return from_file(TexLoadingParams::from_property(property));
 }
\ No newline at end of file
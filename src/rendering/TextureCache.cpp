@@ -0,0 +1,91 @@
+#include "rendering/TextureCache.hpp"
+#include "NodeProperty.hpp"
+
+#include <algorithm> // std::max
+
+using namespace llengine;
+
+[[nodiscard]] std::shared_ptr<Texture> TextureCache::from_file(const TexLoadingParams& params) {
+    return get_or_load(params, [] (const TexLoadingParams& params) {
+        return Texture::from_file(params);
+    });
+}
+
+[[nodiscard]] std::shared_ptr<Texture> TextureCache::from_file(
+    const TexLoadingParams& params, std::string_view mime_type
+) {
+    // The MIME type is a part of the key, the same bytes may be decoded differently.
+    TexLoadingParams params_with_mime_type = params;
+    params_with_mime_type.mime_type = mime_type;
+    return from_file(params_with_mime_type);
+}
+
+[[nodiscard]] std::shared_ptr<Texture> TextureCache::from_property(const NodeProperty& property) {
+    return from_file(TexLoadingParams::from_property(property));
+}
+
+[[nodiscard]] std::shared_ptr<Texture> TextureCache::get_or_load(
+    const TexLoadingParams& params, const std::function<Texture(const TexLoadingParams&)>& loader
+) {
+    if (auto texture = find(params)) {
+        return texture;
+    }
+
+    auto texture = std::make_shared<Texture>(loader(params));
+    insert(params, texture);
+    return texture;
+}
+
+[[nodiscard]] TextureCache::Statistics TextureCache::get_statistics() const {
+    Statistics result;
+    result.hits = hits;
+    result.misses = misses;
+
+    for (const auto& [params, entry] : entries) {
+        if (entry.texture.expired()) {
+            continue;
+        }
+
+        result.resident_textures++;
+        result.resident_bytes += entry.memory_usage;
+    }
+
+    return result;
+}
+
+void TextureCache::reset_counters() noexcept {
+    hits = 0;
+    misses = 0;
+}
+
+[[nodiscard]] std::shared_ptr<Texture> TextureCache::find(const TexLoadingParams& params) {
+    const auto iter = entries.find(params);
+    if (iter != entries.end()) {
+        if (auto texture = iter->second.texture.lock()) {
+            hits++;
+            return texture;
+        }
+    }
+
+    misses++;
+    return nullptr;
+}
+
+void TextureCache::insert(const TexLoadingParams& params, const std::shared_ptr<Texture>& texture) {
+    // An expired entry with the same parameters is replaced in place.
+    if (entries.size() >= sweep_threshold) {
+        remove_expired_entries();
+        sweep_threshold = std::max(MIN_ENTRIES_TO_SWEEP, entries.size() * 2);
+    }
+    entries.insert_or_assign(params, Entry { texture, texture->compute_memory_usage() });
+}
+
+void TextureCache::remove_expired_entries() {
+    for (auto iter = entries.begin(); iter != entries.end();) {
+        if (iter->second.texture.expired()) {
+            iter = entries.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
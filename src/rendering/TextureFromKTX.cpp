@@ -1,10 +1,13 @@
 #include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
 #include "rendering/Texture.hpp"
 
 #include <ktx.h>
 #include <fmt/format.h>
 #include <GL/glew.h>
+#include <glm/common.hpp>
 
+#include <vector>
 #include <fstream>
 #include <filesystem>
 
@@ -158,7 +161,7 @@ Texture Texture::from_ktx(const TexLoadingParams& params) {
         glm::u32vec2(ktx_texture.get()->baseWidth, ktx_texture.get()->baseHeight),
         ktx_texture.get()->isCubemap ? Type::TEX_CUBEMAP : Type::TEX_2D
     };
-    glBindTexture(tex_target, texture_id);
+    rs()._get_gl_state().bind_texture(0, tex_target, texture_id);
     glTexParameteri(tex_target, GL_TEXTURE_MAG_FILTER, params.magnification_filter);
     glTexParameteri(tex_target, GL_TEXTURE_MIN_FILTER, params.minification_filter);
     glTexParameteri(tex_target, GL_TEXTURE_WRAP_S, params.wrap_s);
@@ -173,4 +176,88 @@ Texture Texture::from_ktx(const TexLoadingParams& params) {
     );
     
     return texture;
+}
+
+// Value of VK_FORMAT_R16G16B16_SFLOAT. KTX2 describes formats in terms of Vulkan.
+constexpr std::uint32_t KTX2_RGB16F_FORMAT = 90;
+
+void Texture::save_to_ktx2(const std::string& file_path) const {
+    if (type != Type::TEX_2D && type != Type::TEX_CUBEMAP) {
+        throw std::runtime_error("Only 2D textures and cubemaps can be saved to KTX2.");
+    }
+
+    const GLenum target = type == Type::TEX_CUBEMAP ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    const GLenum level_target = type == Type::TEX_CUBEMAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : GL_TEXTURE_2D;
+    const std::uint32_t faces_count = type == Type::TEX_CUBEMAP ? 6 : 1;
+
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, target, texture_id);
+
+    // Count levels that are actually allocated.
+    GLint max_level = 0;
+    glGetTexParameteriv(target, GL_TEXTURE_MAX_LEVEL, &max_level);
+    std::uint32_t levels_count = 0;
+    for (GLint level = 0; level <= max_level; level++) {
+        GLint width = 0;
+        glGetTexLevelParameteriv(level_target, level, GL_TEXTURE_WIDTH, &width);
+        if (width == 0) {
+            break;
+        }
+        levels_count++;
+    }
+
+    ktxTextureCreateInfo create_info {};
+    create_info.vkFormat = KTX2_RGB16F_FORMAT;
+    create_info.baseWidth = tex_size.x;
+    create_info.baseHeight = tex_size.y;
+    create_info.baseDepth = 1;
+    create_info.numDimensions = 2;
+    create_info.numLevels = levels_count;
+    create_info.numLayers = 1;
+    create_info.numFaces = faces_count;
+    create_info.isArray = KTX_FALSE;
+    create_info.generateMipmaps = KTX_FALSE;
+
+    ktxTexture2* ktx_texture2 = nullptr;
+    KTX_error_code error = ktxTexture2_Create(&create_info, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &ktx_texture2);
+    if (error != KTX_SUCCESS) {
+        throw std::runtime_error(fmt::format(
+            "Failed to create KTX2 texture. Error code: {}", ktx_error_to_string(error)
+        ));
+    }
+    KTXTextureWrapper ktx_texture {ktxTexture(ktx_texture2)};
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    std::vector<std::uint16_t> image_data;
+    glm::u32vec2 level_size {tex_size};
+    for (std::uint32_t level = 0; level < levels_count; level++) {
+        image_data.resize(static_cast<std::size_t>(level_size.x) * level_size.y * 3);
+
+        for (std::uint32_t face = 0; face < faces_count; face++) {
+            glGetTexImage(level_target + face, level, GL_RGB, GL_HALF_FLOAT, image_data.data());
+
+            error = ktxTexture_SetImageFromMemory(
+                ktx_texture.get(), level, 0, face,
+                reinterpret_cast<const ktx_uint8_t*>(image_data.data()),
+                image_data.size() * sizeof(std::uint16_t)
+            );
+            if (error != KTX_SUCCESS) {
+                glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                throw std::runtime_error(fmt::format(
+                    "Failed to fill KTX2 texture. Error code: {}", ktx_error_to_string(error)
+                ));
+            }
+        }
+
+        level_size = glm::max(level_size / 2u, glm::u32vec2(1u));
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    error = ktxTexture_WriteToNamedFile(ktx_texture.get(), file_path.c_str());
+    if (error != KTX_SUCCESS) {
+        throw std::runtime_error(fmt::format(
+            "Failed to write KTX2 texture to file \"{}\". Error code: {}",
+            file_path, ktx_error_to_string(error)
+        ));
+    }
 }
\ No newline at end of file
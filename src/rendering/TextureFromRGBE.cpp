@@ -1,4 +1,7 @@
 #include "rendering/Texture.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
+#include "TextureUploader.hpp"
 
 #include <GL/glew.h>
 #include <fmt/format.h>
@@ -33,77 +36,93 @@ static void rgbe_to_rgb(
     }
 }
 
-static std::vector<float> read_run_length_encoded_data(
+static void read_run_length_encoded_scanline(
     std::uint32_t width,
-    std::uint32_t height,
-    std::ifstream& stream
+    std::ifstream& stream,
+    std::vector<std::uint8_t>& scanline_buffer,
+    float* output
 ) {
-    std::vector<float> result(width * height * 3);
-
-    for (std::uint32_t scanline_i = 0; scanline_i < height; scanline_i++) {
-        std::array<std::uint8_t, 4> first_4_bytes;
-        stream.read(reinterpret_cast<char*>(first_4_bytes.data()), first_4_bytes.size());
-        std::uint16_t scanline_width = first_4_bytes[2] << 8 | first_4_bytes[3];
-        if (scanline_width != width) {
-            throw TextureLoadingError("Failed to load RGBE data: ambiguous texture width.");
-        }
-
-        std::vector<std::uint8_t> scanline_buffer(width * 4);
+    std::array<std::uint8_t, 4> first_4_bytes;
+    stream.read(reinterpret_cast<char*>(first_4_bytes.data()), first_4_bytes.size());
+    std::uint16_t scanline_width = first_4_bytes[2] << 8 | first_4_bytes[3];
+    if (scanline_width != width) {
+        throw TextureLoadingError("Failed to load RGBE data: ambiguous texture width.");
+    }
 
-        for (std::uint32_t cur_column = 0; cur_column < width * 4;) {
-            std::uint8_t run_length;
-            stream.read(reinterpret_cast<char*>(&run_length), 1);
+    for (std::uint32_t cur_column = 0; cur_column < width * 4;) {
+        std::uint8_t run_length;
+        stream.read(reinterpret_cast<char*>(&run_length), 1);
 
-            if (run_length > 128) {
-                // A run of the same value.
-                run_length -= 128;
+        if (run_length > 128) {
+            // A run of the same value.
+            run_length -= 128;
 
-                if (run_length == 0 || scanline_buffer.size() < cur_column + run_length) {
-                    throw TextureLoadingError("Failed to load RGBE data: invalid run length in run-length encoded data.");
-                }
+            if (run_length == 0 || scanline_buffer.size() < cur_column + run_length) {
+                throw TextureLoadingError("Failed to load RGBE data: invalid run length in run-length encoded data.");
+            }
 
-                std::uint8_t value;
-                stream.read(reinterpret_cast<char*>(&value), 1);
-                std::fill(
-                    scanline_buffer.begin() + cur_column,
-                    scanline_buffer.begin() + cur_column + run_length,
-                    value
-                );
+            std::uint8_t value;
+            stream.read(reinterpret_cast<char*>(&value), 1);
+            std::fill(
+                scanline_buffer.begin() + cur_column,
+                scanline_buffer.begin() + cur_column + run_length,
+                value
+            );
 
-                cur_column += run_length;
+            cur_column += run_length;
+        }
+        else {
+            // A run of different values.
+            if (run_length == 0 || scanline_buffer.size() < cur_column + run_length) {
+                throw TextureLoadingError("Failed to load RGBE data: invalid run length in run-length encoded data.");
             }
-            else {
-                // A run of different values.
-                if (run_length == 0 || scanline_buffer.size() < cur_column + run_length) {
-                    throw TextureLoadingError("Failed to load RGBE data: invalid run length in run-length encoded data.");
-                }
 
-                stream.read(
-                    reinterpret_cast<char*>(scanline_buffer.data() + cur_column),
-                    run_length
-                );
+            stream.read(
+                reinterpret_cast<char*>(scanline_buffer.data() + cur_column),
+                run_length
+            );
 
-                cur_column += run_length;
-            }
+            cur_column += run_length;
         }
+    }
 
-        if (!stream) {
-            throw TextureLoadingError("Failed to read a scanline in the RGBE texture.");
-        }
+    if (!stream) {
+        throw TextureLoadingError("Failed to read a scanline in the RGBE texture.");
+    }
+
+    rgbe_to_rgb(scanline_buffer.begin(), scanline_buffer.end(), output);
+}
 
-        rgbe_to_rgb(
-            scanline_buffer.begin(), scanline_buffer.end(),
-            result.begin() + width * 3 * scanline_i
-        );
+static void read_flat_scanline(
+    std::uint32_t width,
+    std::ifstream& stream,
+    std::vector<std::uint8_t>& scanline_buffer,
+    float* output
+) {
+    stream.read(reinterpret_cast<char*>(scanline_buffer.data()), scanline_buffer.size());
+
+    if (!stream) {
+        throw TextureLoadingError("Failed to read flat data in the RGBE texture.");
     }
 
-    return result;
+    // Unlike run-length encoded scanlines, flat ones store RGBE components interleaved.
+    for (std::uint32_t i = 0; i < width; i++) {
+        const float exponent = std::ldexp(1.0f, scanline_buffer[i * 4 + 3] - 128);
+        *output++ = scanline_buffer[i * 4 + 0] / 255.0f * exponent;
+        *output++ = scanline_buffer[i * 4 + 1] / 255.0f * exponent;
+        *output++ = scanline_buffer[i * 4 + 2] / 255.0f * exponent;
+    }
 }
 
-static std::vector<float> get_rgb_data(
+/**
+ * @brief Decodes RGBE pixels straight into the staging memory of the texture uploader.
+ */
+static void upload_rgb_data(
     std::uint32_t width,
     std::uint32_t height,
-    std::ifstream& stream
+    std::ifstream& stream,
+    TextureUploader& uploader,
+    const TextureUploader::Destination& destination
 ) {
     std::array<std::uint8_t, 4> first_4_bytes;
     stream.read(reinterpret_cast<char*>(first_4_bytes.data()), first_4_bytes.size());
@@ -112,42 +131,46 @@ static std::vector<float> get_rgb_data(
     // Get back for 4 bytes we just read.
     stream.seekg(static_cast<std::size_t>(stream.tellg()) - 4);
 
-    if (first_4_bytes[0] == 2 && first_4_bytes[1] == 2 && scanline_width < 32768) {
-        // Data is run-length encoded.
-        return read_run_length_encoded_data(width, height, stream);
-    }
-    else {
-        std::vector<std::uint8_t> rgbe_data(width * height * 4);
-        stream.read(reinterpret_cast<char*>(rgbe_data.data()), rgbe_data.size());
+    const bool run_length_encoded = first_4_bytes[0] == 2 && first_4_bytes[1] == 2 && scanline_width < 32768;
+    std::vector<std::uint8_t> scanline_buffer(width * 4);
+
+    for (std::uint32_t row = 0; row < height;) {
+        auto block = uploader.acquire(destination, row, height - row);
+        float* block_data = reinterpret_cast<float*>(block.data);
 
-        if (!stream) {
-            throw TextureLoadingError("Failed to read flat data in the RGBE texture.");
+        try {
+            for (std::uint32_t i = 0; i < block.rows_count; i++) {
+                if (run_length_encoded) {
+                    read_run_length_encoded_scanline(width, stream, scanline_buffer, block_data + width * 3 * i);
+                }
+                else {
+                    read_flat_scanline(width, stream, scanline_buffer, block_data + width * 3 * i);
+                }
+            }
+        }
+        catch (...) {
+            uploader.discard(std::move(block));
+            throw;
         }
 
-        std::vector<float> result(width * height * 3);
-        rgbe_to_rgb(rgbe_data.begin(), rgbe_data.end(), result.begin());
-        return result;
+        row += block.rows_count;
+        uploader.submit(std::move(block));
     }
 }
 
-static GLuint initialize_opengl_texture(
+static ManagedTextureID initialize_opengl_texture(
     std::uint32_t width,
     std::uint32_t height,
-    const TexLoadingParams& params,
-    const std::vector<float>& rgb_data
+    const TexLoadingParams& params
 ) {
-    GLuint texture_id = 0;
-    glGenTextures(1, &texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    ManagedTextureID texture_id;
+    glGenTextures(1, &texture_id.get_ref());
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
 
     glTexStorage2D(
         GL_TEXTURE_2D, 1, GL_RGB32F,
         width, height
     );
-    glTexSubImage2D(
-        GL_TEXTURE_2D, 0, 0, 0, width, height,
-        GL_RGB, GL_FLOAT, rgb_data.data()
-    );
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magnification_filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minification_filter);
@@ -230,12 +253,28 @@ Texture Texture::from_rgbe(const TexLoadingParams& params) {
         throw TextureLoadingError("Invalid resolution string in the RGBE texture. Only +X -Y resolution is supported.");
     }
 
-    GLuint texture_id;
-    glm::u32vec2 tex_size;
-    std::vector<float> rgb_data {get_rgb_data(x_resolution, y_resolution, stream)};
-    texture_id = initialize_opengl_texture(x_resolution, y_resolution, params, rgb_data);
-    tex_size = {x_resolution, y_resolution};
+    const glm::u32vec2 tex_size {x_resolution, y_resolution};
+    ManagedTextureID texture_id {initialize_opengl_texture(x_resolution, y_resolution, params)};
+
+    TextureUploader::Destination destination;
+    destination.texture_id = texture_id;
+    destination.target = GL_TEXTURE_2D;
+    destination.image_target = GL_TEXTURE_2D;
+    destination.size = tex_size;
+    destination.format = GL_RGB;
+    destination.type = GL_FLOAT;
+    destination.pixel_size = 3 * sizeof(float);
+
+    auto& uploader = rs()._get_texture_uploader();
+    try {
+        upload_rgb_data(x_resolution, y_resolution, stream, uploader, destination);
+    }
+    catch (...) {
+        // Don't leave copies to the texture that is going to be deleted.
+        uploader.flush();
+        throw;
+    }
 
-    return Texture(texture_id, tex_size, Type::TEX_2D);
+    return Texture(std::move(texture_id), tex_size, Type::TEX_2D);
 }
 }
\ No newline at end of file
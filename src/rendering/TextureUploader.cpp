@@ -0,0 +1,236 @@
+#include "TextureUploader.hpp"
+#include "rendering/RenderingServer.hpp"
+#include "GLStateTracker.hpp"
+
+#include <GL/glew.h>
+#include <fmt/format.h>
+
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+using namespace llengine;
+
+TextureUploader::TextureUploader() :
+    persistent_mapping(GLEW_ARB_buffer_storage), graphics_api_thread_id(std::this_thread::get_id()) {
+    constexpr GLbitfield MAPPING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    for (Slot& slot : slots) {
+        if (persistent_mapping) {
+            glGenBuffers(1, &slot.buffer_id);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer_id);
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, SLOT_SIZE, nullptr, MAPPING_FLAGS);
+            slot.data = static_cast<std::byte*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, SLOT_SIZE, MAPPING_FLAGS));
+        }
+        else {
+            slot.client_memory = std::make_unique<std::byte[]>(SLOT_SIZE);
+            slot.data = slot.client_memory.get();
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureUploader::~TextureUploader() {
+    for (Slot& slot : slots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(static_cast<GLsync>(slot.fence));
+        }
+        if (slot.buffer_id != 0) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer_id);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glDeleteBuffers(1, &slot.buffer_id);
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+[[nodiscard]] TextureUploader::StagingBlock TextureUploader::acquire(
+    const Destination& destination, std::uint32_t first_row, std::uint32_t rows_count
+) {
+    const std::size_t row_size = destination.row_size();
+    if (row_size == 0 || row_size > SLOT_SIZE) {
+        throw std::runtime_error(fmt::format(
+            "Failed to stage texture data: invalid row size of {} bytes.", row_size
+        ));
+    }
+
+    std::unique_lock lock(mutex);
+    std::size_t slot_index = find_free_slot();
+    while (slot_index == SLOTS_COUNT) {
+        if (is_graphics_api_thread()) {
+            // Nobody else will free the staging buffers, so do it right here.
+            if (!pending_blocks.empty()) {
+                lock.unlock();
+                process_pending_uploads(std::numeric_limits<std::size_t>::max());
+                lock.lock();
+            }
+            else if (slots_writing == SLOTS_COUNT) {
+                slot_state_changed.wait(lock);
+            }
+            else {
+                retire_slots(true);
+            }
+        }
+        else {
+            slot_state_changed.wait(lock);
+        }
+        slot_index = find_free_slot();
+    }
+
+    slots[slot_index].state = SlotState::WRITING;
+    slots_writing++;
+
+    StagingBlock block;
+    block.data = slots[slot_index].data;
+    block.destination = destination;
+    block.first_row = first_row;
+    block.rows_count = std::min<std::uint32_t>(rows_count, static_cast<std::uint32_t>(SLOT_SIZE / row_size));
+    block.slot_index = slot_index;
+    return block;
+}
+
+void TextureUploader::submit(StagingBlock&& block) {
+    {
+        std::lock_guard lock(mutex);
+        slots[block.slot_index].state = SlotState::PENDING;
+        slots_writing--;
+        pending_bytes += block.destination.row_size() * block.rows_count;
+        pending_blocks.push_back(std::move(block));
+    }
+    slot_state_changed.notify_all();
+}
+
+void TextureUploader::discard(StagingBlock&& block) {
+    {
+        std::lock_guard lock(mutex);
+        slots[block.slot_index].state = SlotState::FREE;
+        slots_writing--;
+    }
+    slot_state_changed.notify_all();
+}
+
+void TextureUploader::upload(const Destination& destination, const void* pixel_data) {
+    const auto* source = static_cast<const std::byte*>(pixel_data);
+    const std::size_t row_size = destination.row_size();
+
+    for (std::uint32_t row = 0; row < destination.size.y;) {
+        StagingBlock block = acquire(destination, row, destination.size.y - row);
+        std::memcpy(block.data, source + row * row_size, block.rows_count * row_size);
+        row += block.rows_count;
+        submit(std::move(block));
+    }
+}
+
+void TextureUploader::process_pending_uploads(std::size_t byte_budget) {
+    std::unique_lock lock(mutex);
+    retire_slots(false);
+
+    std::size_t transferred_bytes = 0;
+    while (!pending_blocks.empty() && transferred_bytes < byte_budget) {
+        const StagingBlock block = pending_blocks.front();
+        pending_blocks.pop_front();
+        const std::size_t block_size = block.destination.row_size() * block.rows_count;
+        pending_bytes -= block_size;
+
+        lock.unlock();
+        copy_block(block);
+        lock.lock();
+
+        Slot& slot = slots[block.slot_index];
+        if (persistent_mapping) {
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            slot.state = SlotState::IN_FLIGHT;
+        }
+        else {
+            // Client memory was already consumed by the driver.
+            slot.state = SlotState::FREE;
+        }
+        transferred_bytes += block_size;
+    }
+
+    lock.unlock();
+    slot_state_changed.notify_all();
+}
+
+void TextureUploader::flush() {
+    std::unique_lock lock(mutex);
+    while (slots_writing != 0 || !pending_blocks.empty()) {
+        slot_state_changed.wait(lock, [this] () {
+            return slots_writing == 0 || !pending_blocks.empty();
+        });
+
+        lock.unlock();
+        process_pending_uploads(std::numeric_limits<std::size_t>::max());
+        lock.lock();
+    }
+}
+
+[[nodiscard]] std::size_t TextureUploader::get_pending_bytes() const {
+    std::lock_guard lock(mutex);
+    return pending_bytes;
+}
+
+[[nodiscard]] bool TextureUploader::is_graphics_api_thread() const {
+    return std::this_thread::get_id() == graphics_api_thread_id;
+}
+
+[[nodiscard]] std::size_t TextureUploader::find_free_slot() const {
+    for (std::size_t i = 0; i < SLOTS_COUNT; i++) {
+        if (slots[i].state == SlotState::FREE) {
+            return i;
+        }
+    }
+
+    return SLOTS_COUNT;
+}
+
+void TextureUploader::copy_block(const StagingBlock& block) {
+    const Destination& dest = block.destination;
+
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, dest.target, dest.texture_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // With a bound pixel unpack buffer the pointer is an offset in this buffer.
+    const void* source = nullptr;
+    if (persistent_mapping) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slots[block.slot_index].buffer_id);
+    }
+    else {
+        source = block.data;
+    }
+
+    if (dest.target == GL_TEXTURE_1D) {
+        glTexSubImage1D(dest.image_target, dest.level, 0, dest.size.x, dest.format, dest.type, source);
+    }
+    else {
+        glTexSubImage2D(
+            dest.image_target, dest.level, 0, block.first_row, dest.size.x, block.rows_count,
+            dest.format, dest.type, source
+        );
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void TextureUploader::retire_slots(bool wait) {
+    // When waiting, block only until the first staging buffer becomes free.
+    bool waited = !wait;
+
+    for (Slot& slot : slots) {
+        if (slot.state != SlotState::IN_FLIGHT) {
+            continue;
+        }
+
+        const GLsync fence = static_cast<GLsync>(slot.fence);
+        const GLuint64 timeout = waited ? 0 : std::numeric_limits<GLuint64>::max();
+        const GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            glDeleteSync(fence);
+            slot.fence = nullptr;
+            slot.state = SlotState::FREE;
+            waited = true;
+        }
+    }
+}
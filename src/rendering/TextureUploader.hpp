@@ -0,0 +1,148 @@
+#pragma once
+
+#include "datatypes.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <cstddef>
+#include <condition_variable>
+
+namespace llengine {
+/**
+ * @brief Streams pixel data to textures through a ring of staging buffers.
+ *
+ * Staging memory is persistently mapped when ARB_buffer_storage is
+ * available, so any thread can write decoded pixels straight into it.
+ * Copies from the staging memory to textures are issued only on the
+ * graphics API thread in process_pending_uploads, which can be limited
+ * to some amount of bytes to spread big uploads over several frames.
+ * Staging buffers are reused only after fences confirm that the GPU
+ * has consumed their contents.
+ */
+class TextureUploader {
+public:
+    /**
+     * @brief Describes a texture image the pixel data is addressed to.
+     */
+    struct Destination {
+        TextureID texture_id = 0;
+        GraphicsAPIEnum target = 0; // Texture binding target, like GL_TEXTURE_CUBE_MAP.
+        GraphicsAPIEnum image_target = 0; // Image target, like GL_TEXTURE_CUBE_MAP_POSITIVE_X.
+        std::int32_t level = 0;
+        glm::u32vec2 size {0, 0}; // Height must be 1 for 1D textures.
+        GraphicsAPIEnum format = 0;
+        GraphicsAPIEnum type = 0;
+        std::size_t pixel_size = 0; // In bytes.
+
+        [[nodiscard]] std::size_t row_size() const {
+            return pixel_size * size.x;
+        }
+    };
+
+    /**
+     * @brief A range of texture rows in staging memory.
+     *
+     * Must be filled and then given back with TextureUploader::submit.
+     */
+    struct StagingBlock {
+        std::byte* data = nullptr;
+        Destination destination;
+        std::uint32_t first_row = 0;
+        std::uint32_t rows_count = 0;
+        std::size_t slot_index = 0;
+    };
+
+    TextureUploader();
+    TextureUploader(const TextureUploader& other) = delete;
+    TextureUploader(TextureUploader&& other) = delete;
+    ~TextureUploader();
+
+    TextureUploader& operator=(const TextureUploader& other) = delete;
+    TextureUploader& operator=(TextureUploader&& other) = delete;
+
+    /**
+     * @brief Reserves staging memory for some rows of the destination image,
+     * starting from first_row.
+     *
+     * Can be called from any thread. Blocks if all staging buffers are
+     * in use. The returned block may contain fewer rows than requested
+     * if they don't fit in one staging buffer.
+     */
+    [[nodiscard]] StagingBlock acquire(const Destination& destination, std::uint32_t first_row, std::uint32_t rows_count);
+    /**
+     * @brief Queues copy of the filled staging block to its destination.
+     *
+     * Can be called from any thread.
+     */
+    void submit(StagingBlock&& block);
+    /**
+     * @brief Gives the staging block back without uploading it.
+     *
+     * Can be called from any thread.
+     */
+    void discard(StagingBlock&& block);
+    /**
+     * @brief Copies the whole image from client memory to the staging
+     * memory and queues it for upload.
+     *
+     * Rows in pixel_data must be tightly packed.
+     */
+    void upload(const Destination& destination, const void* pixel_data);
+
+    /**
+     * @brief Issues queued copies until at least byte_budget bytes
+     * are transferred or the queue is empty. Also retires staging
+     * buffers the GPU has finished reading from.
+     *
+     * Must be called from the graphics API thread.
+     */
+    void process_pending_uploads(std::size_t byte_budget);
+    /**
+     * @brief Issues all queued copies, including the ones still
+     * being written by other threads.
+     *
+     * Must be called from the graphics API thread before textures
+     * are used outside of the main loop.
+     */
+    void flush();
+
+    [[nodiscard]] std::size_t get_pending_bytes() const;
+
+private:
+    enum class SlotState : std::uint8_t {
+        FREE, WRITING, PENDING, IN_FLIGHT
+    };
+
+    struct Slot {
+        BufferID buffer_id = 0;
+        std::byte* data = nullptr;
+        // Used only when persistent mapping is unavailable.
+        std::unique_ptr<std::byte[]> client_memory = nullptr;
+        void* fence = nullptr;
+        SlotState state = SlotState::FREE;
+    };
+
+    static constexpr std::size_t SLOTS_COUNT = 4;
+    static constexpr std::size_t SLOT_SIZE = 8 * 1024 * 1024;
+
+    std::array<Slot, SLOTS_COUNT> slots;
+    std::deque<StagingBlock> pending_blocks;
+    std::size_t pending_bytes = 0;
+    std::size_t slots_writing = 0;
+    bool persistent_mapping = false;
+    std::thread::id graphics_api_thread_id;
+
+    mutable std::mutex mutex;
+    std::condition_variable slot_state_changed;
+
+    [[nodiscard]] bool is_graphics_api_thread() const;
+    [[nodiscard]] std::size_t find_free_slot() const;
+    void copy_block(const StagingBlock& block);
+    void retire_slots(bool wait);
+};
+}
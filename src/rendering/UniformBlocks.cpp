@@ -0,0 +1,37 @@
+#include "UniformBlocks.hpp"
+
+using namespace llengine;
+using namespace llengine::uniform_blocks;
+
+template<typename TextureInfo>
+[[nodiscard]] static glm::vec4 get_uv_transform(const std::optional<TextureInfo>& texture_info) {
+    if (!texture_info.has_value()) {
+        return {0.0f, 0.0f, 1.0f, 1.0f};
+    }
+    return {texture_info->uv_offset, texture_info->uv_scale};
+}
+
+[[nodiscard]] MaterialBlock uniform_blocks::make_material_block(const Material& material) {
+    MaterialBlock result {};
+    result.base_color_factor = material.base_color_factor;
+    result.emissive_factor = material.emissive_factor;
+    result.normal_map_scale = material.normal_map.has_value() ? material.normal_map->scale : 1.0f;
+    result.metallic_factor = material.metallic_factor;
+    result.roughness_factor = material.roughness_factor;
+    result.ao_factor = material.ambient_occlusion_factor;
+
+    result.uv_transform = {0.0f, 0.0f, 1.0f, 1.0f};
+    if (material.has_identical_offsets_and_scales()) {
+        const auto [offset, scale] = material.get_general_uv_offset_and_scale();
+        result.uv_transform = {offset, scale};
+    }
+    result.base_uv_transform = get_uv_transform(material.base_color_texture);
+    result.normal_uv_transform = material.normal_map.has_value() ?
+        glm::vec4(material.normal_map->texture.uv_offset, material.normal_map->texture.uv_scale) :
+        glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    result.metallic_uv_transform = get_uv_transform(material.metallic_texture);
+    result.roughness_uv_transform = get_uv_transform(material.roughness_texture);
+    result.ao_uv_transform = get_uv_transform(material.ambient_occlusion_texture);
+
+    return result;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "rendering/Material.hpp"
+#include "math/SphericalHarmonics.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * std140 uniform blocks of the PBR shader. Members are ordered so that
+ * the C++ layout matches std140 without any packing work.
+ */
+namespace llengine::uniform_blocks {
+constexpr std::uint32_t FRAME_BINDING = 0;
+constexpr std::uint32_t MATERIAL_BINDING = 1;
+constexpr std::uint32_t DRAW_BINDING = 2;
+
+constexpr std::size_t MAX_POINT_LIGHTS = 256;
+
+struct PointLightData {
+    glm::vec3 position;
+    float range;
+    glm::vec3 color;
+    float padding_2;
+};
+
+struct FrameBlock {
+    glm::mat4 view_proj_matrix;
+    glm::mat4 shadow_view_proj_matrix;
+    glm::vec3 camera_position;
+    float pcf_sparsity;
+    glm::vec3 shadow_light_direction;
+    float shadow_map_bias_at_45_deg;
+    glm::vec3 ambient;
+    // Amount of used elements of point_lights.
+    std::int32_t point_lights_count;
+    glm::vec3 camera_forward;
+    // Cluster of a fragment, see LightClusterGrid.
+    float cluster_z_scale;
+    glm::vec2 cluster_xy_scale;
+    float cluster_z_bias;
+    // Value of QualitySettings::light_assignment.
+    std::int32_t light_assignment;
+    // Array elements of vec3 are aligned as vec4 in std140.
+    std::array<glm::vec4, SphericalHarmonics::COEFFICIENTS_COUNT> sh_coefficients;
+    std::array<PointLightData, MAX_POINT_LIGHTS> point_lights;
+};
+static_assert(offsetof(FrameBlock, cluster_xy_scale) == 192);
+static_assert(offsetof(FrameBlock, sh_coefficients) == 208);
+static_assert(offsetof(FrameBlock, point_lights) == 352);
+
+struct MaterialBlock {
+    glm::vec4 base_color_factor;
+    glm::vec3 emissive_factor;
+    float normal_map_scale;
+    float metallic_factor;
+    float roughness_factor;
+    float ao_factor;
+    float padding;
+    // Offsets in xy, scales in zw.
+    glm::vec4 uv_transform;
+    glm::vec4 base_uv_transform;
+    glm::vec4 normal_uv_transform;
+    glm::vec4 metallic_uv_transform;
+    glm::vec4 roughness_uv_transform;
+    glm::vec4 ao_uv_transform;
+};
+static_assert(sizeof(MaterialBlock) == 144);
+
+struct DrawBlock {
+    glm::mat4 model_matrix;
+    glm::mat4 normal_matrix;
+    // Indices of ObjectLights, -1 for unused. ivec4[2] in the shader.
+    std::array<std::int32_t, 8> object_lights;
+};
+
+[[nodiscard]] MaterialBlock make_material_block(const Material& material);
+}
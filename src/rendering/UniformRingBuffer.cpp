@@ -0,0 +1,39 @@
+#include "UniformRingBuffer.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace llengine;
+
+UniformRingBuffer::UniformRingBuffer(std::size_t size) : size(size) {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    offset_alignment = static_cast<std::size_t>(std::max(alignment, 1));
+
+    glGenBuffers(1, &buffer_id);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+    glDeleteBuffers(1, &buffer_id);
+}
+
+void UniformRingBuffer::bind_data(std::uint32_t binding, const void* data, std::size_t data_size) {
+    if (data_size > size) {
+        throw std::runtime_error("Uniform block is bigger than the uniform ring buffer.");
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+    offset = (offset + offset_alignment - 1) / offset_alignment * offset_alignment;
+    if (offset + data_size > size) {
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        offset = 0;
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, data_size, data);
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer_id, offset, data_size);
+    offset += data_size;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "datatypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace llengine {
+/**
+ * @brief Uniform buffer that short-lived blocks are suballocated from
+ * one after another. When the end is reached, the buffer is orphaned
+ * and filled from the beginning, so pending draws keep their data.
+ */
+class UniformRingBuffer {
+public:
+    explicit UniformRingBuffer(std::size_t size = 4 * 1024 * 1024);
+    UniformRingBuffer(const UniformRingBuffer& other) = delete;
+    UniformRingBuffer(UniformRingBuffer&& other) = delete;
+    ~UniformRingBuffer();
+
+    UniformRingBuffer& operator=(const UniformRingBuffer& other) = delete;
+    UniformRingBuffer& operator=(UniformRingBuffer&& other) = delete;
+
+    /**
+     * @brief Copies the data to a new range and binds it to the uniform block binding point.
+     */
+    void bind_data(std::uint32_t binding, const void* data, std::size_t data_size);
+
+    template<typename T>
+    void bind_block(std::uint32_t binding, const T& block) {
+        bind_data(binding, &block, sizeof(T));
+    }
+
+private:
+    BufferID buffer_id = 0;
+    std::size_t size;
+    std::size_t offset = 0;
+    std::size_t offset_alignment = 256;
+};
+}
@@ -2,10 +2,13 @@
 
 #include <glm/gtc/type_ptr.hpp> // glm::value_ptr
 
-#include "nodes/rendering/PointLightNode.hpp" // PointLightNode
 #include "rendering/Material.hpp"
 #include "utils/shader_loader.hpp" // load_shaders
 #include "rendering/RenderingServer.hpp" // RenderingServer
+#include "rendering/InstanceBuffer.hpp"
+#include "rendering/UniformRingBuffer.hpp"
+#include "rendering/MaterialBlockCache.hpp"
+#include "rendering/LightClusterBuffer.hpp"
 #include "utils/texture_utils.hpp"
 #include "PBRShader.hpp" // TexturedShared
 
@@ -22,7 +25,7 @@ static std::optional<Texture> brdf_integration_map = std::nullopt;
 
 static Texture& get_brdf_integration_map() {
     if (!brdf_integration_map.has_value()) {
-        brdf_integration_map = tex_utils::compute_brdf_integration_map();
+        brdf_integration_map = tex_utils::load_brdf_integration_map();
     }
 
     return *brdf_integration_map;
@@ -70,9 +73,9 @@ static PBRShader::Flags compute_flags(const Material& material) {
     }
     if (rs().get_global_lighting_environment().get_base_cubemap() != nullptr) {
         flags |= PBRShader::USING_IBL;
-    }
-    if (!rs().get_point_lights().empty() || flags & PBRShader::USING_IBL) {
-        flags |= PBRShader::USING_FRAGMENT_POSITION;
+        if (rs().get_quality_settings().sh_irradiance_enabled) {
+            flags |= PBRShader::USING_SH_IRRADIANCE;
+        }
     }
     if ((flags & PBRShader::USING_BASE_COLOR_TEXTURE) ||
         (flags & PBRShader::USING_NORMAL_TEXTURE) ||
@@ -104,10 +107,7 @@ static PBRShader::Flags compute_flags(const Material& material) {
 
 PBRShader::Parameters
 PBRShader::to_parameters(const Material& material) noexcept {
-    Parameters result {
-        static_cast<uint32_t>(rs().get_point_lights().size()),
-        compute_flags(material)
-    };
+    Parameters result {compute_flags(material)};
 
     result.metallic_channel = material.metallic_texture.has_value() ?
         material.metallic_texture->channel : Channel::NONE;
@@ -131,7 +131,12 @@ PBRShader::~PBRShader() {
     using namespace std::string_literals;
 
     std::vector<std::string> defines {
-        "POINT_LIGHTS_COUNT " + std::to_string(params.point_lights_count)
+        "MAX_POINT_LIGHTS " + std::to_string(uniform_blocks::MAX_POINT_LIGHTS),
+        "CLUSTERS_X " + std::to_string(LightClusterGrid::SIZE_X),
+        "CLUSTERS_Y " + std::to_string(LightClusterGrid::SIZE_Y),
+        "CLUSTERS_Z " + std::to_string(LightClusterGrid::SIZE_Z),
+        "MAX_OBJECT_LIGHTS " + std::to_string(ObjectLights::MAX_LIGHTS),
+        "TEXELS_PER_INSTANCE " + std::to_string(InstanceBuffer::TEXELS_PER_INSTANCE)
     };
 
     const auto& flags = params.flags;
@@ -145,8 +150,6 @@ PBRShader::~PBRShader() {
         defines.emplace_back("USING_NORMAL_TEXTURE");
     if (flags & PBRShader::USING_NORMAL_MAP_SCALE)
         defines.emplace_back("USING_NORMAL_MAP_SCALE");
-    if (flags & PBRShader::USING_FRAGMENT_POSITION)
-        defines.emplace_back("USING_FRAGMENT_POSITION");
     if (flags & PBRShader::USING_UV)
         defines.emplace_back("USING_UV");
     if (flags & PBRShader::USING_GENERAL_UV_TRANSFORM)
@@ -181,6 +184,8 @@ PBRShader::~PBRShader() {
         defines.emplace_back("USING_AO_FACTOR");
     if (flags & PBRShader::USING_IBL)
         defines.emplace_back("USING_IBL");
+    if (flags & PBRShader::USING_SH_IRRADIANCE)
+        defines.emplace_back("USING_SH_IRRADIANCE");
     if (flags & PBRShader::USING_SHADOW_MAP) {
         defines.emplace_back("USING_SHADOW_MAP");
     }
@@ -190,6 +195,9 @@ PBRShader::~PBRShader() {
     if (flags & PBRShader::USING_EMISSIVE_FACTOR) {
         defines.emplace_back("USING_EMISSIVE_FACTOR");
     }
+    if (flags & PBRShader::USING_INSTANCING) {
+        defines.emplace_back("USING_INSTANCING");
+    }
 
     return defines;
 }
@@ -199,99 +207,61 @@ void PBRShader::initialize(const Parameters& params) {
     metallic_channel = params.metallic_channel;
     roughness_channel = params.roughness_channel;
     ao_channel = params.ao_channel;
-    point_lights_count = static_cast<std::int32_t>(params.point_lights_count);
 
     shader = std::make_optional<ShaderType>(
         VERTEX_SHADER_TEXT, FRAGMENT_SHADER_TEXT,
         compute_defines_from_params(params)
     );
+
+    const ShaderID program_id = shader->get_program_id();
+    const auto bind_block = [&] (const char* name, std::uint32_t binding) {
+        const GLuint index = glGetUniformBlockIndex(program_id, name);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program_id, index, binding);
+        }
+    };
+    bind_block("FrameData", uniform_blocks::FRAME_BINDING);
+    bind_block("MaterialData", uniform_blocks::MATERIAL_BINDING);
+    bind_block("DrawData", uniform_blocks::DRAW_BINDING);
 }
 
 void PBRShader::use_shader(
-    const Material& material, const glm::mat4& mvp_matrix,
-    const glm::mat4& model_matrix, const glm::vec3& camera_position
+    const Material& material, const glm::mat4& model_matrix,
+    const ObjectLights::Indices& object_lights, const RenderStateChanges& changes
 ) const {
+    use_program_and_material(material, changes);
+
+    const uniform_blocks::DrawBlock block {
+        model_matrix, glm::transpose(glm::inverse(glm::mat3(model_matrix))), object_lights
+    };
+    RenderingServer::current()._get_uniform_ring_buffer().bind_block(uniform_blocks::DRAW_BINDING, block);
+}
+
+void PBRShader::use_instanced_shader(
+    const Material& material, std::int32_t first_instance, const RenderStateChanges& changes
+) const {
+    assert(flags & USING_INSTANCING);
+
+    use_program_and_material(material, changes);
+    shader->set_int<"first_instance">(first_instance);
+}
+
+void PBRShader::use_program_and_material(const Material& material, const RenderStateChanges& changes) const {
     assert(is_initialized());
     assert(shader.has_value());
 
-    RenderingServer& rs = RenderingServer::current();
-
-    shader->use_shader();
-    shader->set_mat4<"mvp">(mvp_matrix);
-    shader->set_mat4<"model_matrix">(model_matrix);
-    if (shader->is_uniform_initialized<"normal_matrix">()) {
-        glm::mat4 normal_matrix = glm::transpose(glm::inverse(
-            glm::mat3(model_matrix)
-        ));
-        shader->set_mat4<"normal_matrix">(normal_matrix);
-    }
-    shader->set_vec3<"ambient">(glm::vec3(0.01f, 0.01f, 0.01f));
-    shader->set_vec3<"camera_position">(camera_position);
-    shader->set_vec4<"base_color_factor">(material.base_color_factor);
-    if (material.normal_map.has_value()) {
-        shader->set_float<"normal_map_scale">(material.normal_map->scale);
-    }
-    shader->set_float<"metallic_factor">(material.metallic_factor);
-    shader->set_float<"roughness_factor">(material.roughness_factor);
-    shader->set_vec3<"emissive_factor">(material.emissive_factor);
-    shader->set_float<"ao_factor">(material.ambient_occlusion_factor);
-    shader->set_mat4<"shadow_view_proj_matrix">(rs.get_shadow_map().get_view_proj_matrix());
-    if (shader->is_uniform_initialized<"uv_offset">() || shader->is_uniform_initialized<"uv_scale">()) {
-        const std::pair<glm::vec2, glm::vec2> general_offset_scale =
-                material.get_general_uv_offset_and_scale();
-        shader->set_vec2<"uv_offset">(general_offset_scale.first);
-        shader->set_vec2<"uv_scale">(general_offset_scale.second);
-    }
-    if (
-        (shader->is_uniform_initialized<"base_uv_offset">() || shader->is_uniform_initialized<"base_uv_scale">()) &&
-        material.base_color_texture.has_value()
-    ) {
-        shader->set_vec2<"base_uv_offset">(material.base_color_texture->uv_offset);
-        shader->set_vec2<"base_uv_scale">(material.base_color_texture->uv_scale);
-    }
-    if (
-        (shader->is_uniform_initialized<"normal_uv_offset">() || shader->is_uniform_initialized<"normal_uv_scale">()) &&
-        material.normal_map.has_value()
-    ) {
-        shader->set_vec2<"normal_uv_offset">(material.normal_map->texture.uv_offset);
-        shader->set_vec2<"normal_uv_scale">(material.normal_map->texture.uv_scale);
-    }
-    if (
-        (shader->is_uniform_initialized<"metallic_uv_offset">() || shader->is_uniform_initialized<"metallic_uv_scale">()) &&
-        material.metallic_texture.has_value()
-    ) {
-        shader->set_vec2<"metallic_uv_offset">(material.metallic_texture->uv_offset);
-        shader->set_vec2<"metallic_uv_scale">(material.metallic_texture->uv_scale);
-    }
-    if (
-        (shader->is_uniform_initialized<"roughness_uv_offset">() || shader->is_uniform_initialized<"roughness_uv_scale">()) &&
-        material.roughness_texture.has_value()
-    ) {
-        shader->set_vec2<"roughness_uv_offset">(material.roughness_texture->uv_offset);
-        shader->set_vec2<"roughness_uv_scale">(material.roughness_texture->uv_scale);
-    }
-    if (
-        (shader->is_uniform_initialized<"ao_uv_offset">() || shader->is_uniform_initialized<"ao_uv_scale">()) &&
-        material.ambient_occlusion_texture.has_value()
-    ) {
-        shader->set_vec2<"ao_uv_offset">(material.ambient_occlusion_texture->uv_offset);
-        shader->set_vec2<"ao_uv_scale">(material.ambient_occlusion_texture->uv_scale);
-    }
-    if (shader->is_uniform_initialized<"shadow_map_bias_at_45_deg">()) {
-        shader->set_float<"shadow_map_bias_at_45_deg">(rs.get_shadow_map().get_adjusted_bias_at_45_deg());
-    }
-    if (shader->is_uniform_initialized<"pcf_sparsity">()) {
-        assert(rs.get_shadow_map().get_size().x == rs.get_shadow_map().get_size().y);
-        shader->set_float<"pcf_sparsity">(1.0f / rs.get_shadow_map().get_size().x);
-    }
-    if (shader->is_uniform_initialized<"shadow_light_direction">()) {
-        shader->set_vec3<"shadow_light_direction">(rs.get_shadow_map().get_light_direction());
-    }
-    const auto& point_lights = rs.get_point_lights();
-    for (std::size_t i = 0; i < point_lights.size(); i++) {
-        shader->set_vec3<"point_lights[].position">(i, point_lights[i]->get_global_position());
-        shader->set_vec3<"point_lights[].color">(i, point_lights[i]->color);
+    // Camera, lights and shadow map parameters are in the frame block bound by RenderingServer.
+    if (changes.program) {
+        shader->use_shader();
+    }
+    if (changes.material) {
+        RenderingServer::current()._get_material_block_cache().bind(material, uniform_blocks::MATERIAL_BINDING);
+        bind_textures(material);
     }
+}
+
+void PBRShader::bind_textures(const Material& material) const {
+    RenderingServer& rs = RenderingServer::current();
 
     GraphicsAPIEnum texture_unit {0};
     if (shader->is_uniform_initialized<"base_color_texture">()) {
@@ -314,22 +284,25 @@ void PBRShader::use_shader(
     }
     if (shader->is_uniform_initialized<"prefiltered_specular_map">()) {
         auto prefiltered_specular_map_id = rs.get_global_lighting_environment().get_prefiltered_specular_map().value().get_id();
-        shader->use_shader();
         shader->bind_cubemap_texture<"prefiltered_specular_map">(prefiltered_specular_map_id, texture_unit++);
     }
     if (shader->is_uniform_initialized<"irradiance_map">()) {
         auto irradiance_map_id = rs.get_global_lighting_environment().get_irradiance_map().value().get_id();
-        shader->use_shader();
         shader->bind_cubemap_texture<"irradiance_map">(irradiance_map_id, texture_unit++);
     }
     if (shader->is_uniform_initialized<"brdf_integration_map">()) {
         auto brdf_integration_map_id = get_brdf_integration_map().get_id();
-        shader->use_shader();
         shader->bind_2d_texture<"brdf_integration_map">(brdf_integration_map_id, texture_unit++);
     }
     if (shader->is_uniform_initialized<"shadow_map">()) {
         shader->bind_2d_texture<"shadow_map">(rs.get_shadow_map().get_texture_id(), texture_unit++);
     }
+    if (shader->is_uniform_initialized<"instance_data">()) {
+        shader->bind_buffer_texture<"instance_data">(rs._get_instance_buffer().get_texture_id(), texture_unit++);
+    }
+    if (shader->is_uniform_initialized<"light_clusters">()) {
+        shader->bind_buffer_texture<"light_clusters">(rs._get_light_cluster_buffer().get_texture_id(), texture_unit++);
+    }
 }
 
 void PBRShader::delete_shader() {
@@ -338,7 +311,6 @@ void PBRShader::delete_shader() {
 
 PBRShader::Parameters PBRShader::extract_parameters() const noexcept {
     return {
-        static_cast<uint32_t>(point_lights_count),
         flags,
         metallic_channel,
         roughness_channel,
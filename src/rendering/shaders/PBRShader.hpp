@@ -2,6 +2,8 @@
 
 #include "rendering/Material.hpp"
 #include "rendering/Shader.hpp"
+#include "rendering/ObjectLights.hpp"
+#include "nodes/rendering/Drawable.hpp"
 #include "datatypes.hpp"
 
 #include <glm/vec4.hpp> // glm::vec4
@@ -20,7 +22,6 @@ public:
         USING_VERTEX_NORMALS = 0x4,
         USING_NORMAL_TEXTURE = 0x8,
         USING_NORMAL_MAP_SCALE = 0x10,
-        USING_FRAGMENT_POSITION = 0x20,
         USING_UV = 0x40,
         USING_GENERAL_UV_TRANSFORM = 0x80,
         USING_BASE_UV_TRANSFORM = 0x100,
@@ -37,7 +38,9 @@ public:
         USING_IBL = 0x80000,
         USING_SHADOW_MAP = 0x100000,
         USING_EMISSIVE_TEXTURE = 0x200000,
-        USING_EMISSIVE_FACTOR = 0x400000
+        USING_EMISSIVE_FACTOR = 0x400000,
+        USING_SH_IRRADIANCE = 0x800000,
+        USING_INSTANCING = 0x1000000
     };
 
     friend inline constexpr Flags operator|(Flags left, Flags right) noexcept {
@@ -48,7 +51,6 @@ public:
     }
 
     struct Parameters {
-        size_t point_lights_count;
         Flags flags;
         Channel metallic_channel;
         Channel roughness_channel;
@@ -70,9 +72,21 @@ public:
     ~PBRShader();
 
     void initialize(const Parameters& params);
+    /**
+     * @brief Uses the program and binds the draw uniform block of the object.
+     * The material block and textures are bound only if the material changed.
+     * @param object_lights Used if lights are assigned per object.
+     */
     void use_shader(
-        const Material& material, const glm::mat4& mvp_matrix,
-        const glm::mat4& model_matrix, const glm::vec3& camera_position
+        const Material& material, const glm::mat4& model_matrix,
+        const ObjectLights::Indices& object_lights, const RenderStateChanges& changes = {}
+    ) const;
+    /**
+     * @brief Like use_shader, but model matrices are read from the instance buffer
+     * starting from first_instance. The shader must have USING_INSTANCING flag.
+     */
+    void use_instanced_shader(
+        const Material& material, std::int32_t first_instance, const RenderStateChanges& changes = {}
     ) const;
     void delete_shader();
 
@@ -85,17 +99,10 @@ public:
 
 private:
     using ShaderType = Shader<
-        "mvp", "model_matrix", "normal_matrix", "ambient", "camera_position",
-        "base_color_factor", "normal_map_scale", "metallic_factor", "roughness_factor",
-        "ao_factor", "emissive_factor", "uv_offset", "uv_scale",
-        "base_uv_offset", "base_uv_scale", "normal_uv_offset", "normal_uv_scale",
-        "metallic_uv_offset", "metallic_uv_scale", "roughness_uv_offset",
-        "roughness_uv_scale", "ao_uv_offset", "ao_uv_scale", "shadow_view_proj_matrix",
-        "shadow_map_bias_at_45_deg", "shadow_light_direction", "base_color_texture",
-        "normal_texture", "ao_texture", "metallic_texture", "roughness_texture",
-        "emissive_texture", "prefiltered_specular_map", "irradiance_map",
-        "brdf_integration_map", "shadow_map", "pcf_sparsity", "point_lights[].position",
-        "point_lights[].color"
+        "base_color_texture", "normal_texture", "ao_texture", "metallic_texture",
+        "roughness_texture", "emissive_texture", "prefiltered_specular_map",
+        "irradiance_map", "brdf_integration_map", "shadow_map", "instance_data",
+        "light_clusters", "first_instance"
     >;
     std::optional<ShaderType> shader = std::nullopt;
 
@@ -103,6 +110,7 @@ private:
     Channel metallic_channel = Channel::NONE;
     Channel roughness_channel = Channel::NONE;
     Channel ao_channel = Channel::NONE;
-    std::int32_t point_lights_count = 0;
+    void use_program_and_material(const Material& material, const RenderStateChanges& changes) const;
+    void bind_textures(const Material& material) const;
 };
 }
\ No newline at end of file
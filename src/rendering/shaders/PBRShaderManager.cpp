@@ -4,26 +4,49 @@
 using namespace llengine;
 
 void PBRShaderManager::use_shader(
-    const Material& material, const glm::mat4& mvp_matrix,
-    const glm::mat4& model_matrix, const glm::vec3& camera_position
+    const Material& material, const glm::mat4& model_matrix,
+    const ObjectLights::Indices& object_lights, const RenderStateChanges& changes
 ) {
     get_shader(material)
-        .use_shader(material, mvp_matrix, model_matrix, camera_position);
+        .use_shader(material, model_matrix, object_lights, changes);
 }
 
-ShaderID PBRShaderManager::get_program_id(const Material& material) {
-    return get_shader(material).get_program_id();
+void PBRShaderManager::use_instanced_shader(
+    const Material& material, std::int32_t first_instance, const RenderStateChanges& changes
+) {
+    get_shader(material, true)
+        .use_instanced_shader(material, first_instance, changes);
+}
+
+ShaderID PBRShaderManager::get_program_id(const Material& material, bool instanced) {
+    return get_shader(material, instanced).get_program_id();
+}
+
+[[nodiscard]] std::optional<ShaderID> PBRShaderManager::find_program_id(const Material& material, bool instanced) const {
+    const auto iter {pbr_shaders.find(to_parameters(material, instanced))};
+    if (iter == pbr_shaders.end()) {
+        return std::nullopt;
+    }
+
+    return iter->get_program_id();
 }
 
-const PBRShader& PBRShaderManager::get_shader(const Material& material) {
-    const auto params = PBRShader::to_parameters(material);
+const PBRShader& PBRShaderManager::get_shader(const Material& material, bool instanced) {
+    const auto params = to_parameters(material, instanced);
     auto iter {pbr_shaders.find(params)};
 
     if (iter == pbr_shaders.end()) {
-        iter = pbr_shaders.emplace(
-            PBRShader::to_parameters(material)
-        ).first;
+        iter = pbr_shaders.emplace(params).first;
     }
     
     return *iter;
 }
+
+[[nodiscard]] PBRShader::Parameters PBRShaderManager::to_parameters(const Material& material, bool instanced) {
+    auto params = PBRShader::to_parameters(material);
+    if (instanced) {
+        params.flags |= PBRShader::USING_INSTANCING;
+    }
+
+    return params;
+}
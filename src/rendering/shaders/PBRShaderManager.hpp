@@ -1,6 +1,7 @@
 #pragma once
 
 #include <set> // std::set
+#include <optional>
 #include <type_traits> // std::true_type
 
 #include "PBRShader.hpp"
@@ -12,14 +13,25 @@ public:
     PBRShaderManager() = default;
 
     void use_shader(
-        const Material& material, const glm::mat4& mvp_matrix,
-        const glm::mat4& model_matrix, const glm::vec3& camera_position
+        const Material& material, const glm::mat4& model_matrix,
+        const ObjectLights::Indices& object_lights, const RenderStateChanges& changes = {}
     );
 
-    ShaderID get_program_id(const Material& material);
+    void use_instanced_shader(
+        const Material& material, std::int32_t first_instance, const RenderStateChanges& changes = {}
+    );
+
+    ShaderID get_program_id(const Material& material, bool instanced = false);
+    /**
+     * @brief Like get_program_id, but never compiles a shader, so it can be called
+     * from several threads at once, unless other methods are being called.
+     * @return Nothing if the shader is not compiled yet.
+     */
+    [[nodiscard]] std::optional<ShaderID> find_program_id(const Material& material, bool instanced = false) const;
 
 private:
-    const PBRShader& get_shader(const Material& material);
+    const PBRShader& get_shader(const Material& material, bool instanced = false);
+    [[nodiscard]] static PBRShader::Parameters to_parameters(const Material& material, bool instanced);
 
     struct PBRShaderComparator {
         using is_transparent = std::true_type;
@@ -0,0 +1,27 @@
+R""(
+#version 330 core
+
+layout(location = 0) in vec3 vertex_pos;
+layout(location = 4) in uint instance_index;
+
+// Only the beginning of the frame block of the PBR shader.
+layout(std140) uniform FrameData {
+    mat4 view_proj_matrix;
+};
+uniform samplerBuffer instance_data;
+uniform int first_instance;
+
+// The position must be computed exactly as in the instanced PBR shader,
+// so its depth passes the GL_LEQUAL test in the main pass.
+invariant gl_Position;
+
+void main() {
+    int texel = (first_instance + int(instance_index)) * TEXELS_PER_INSTANCE;
+    mat4 model_matrix = mat4(
+        texelFetch(instance_data, texel), texelFetch(instance_data, texel + 1),
+        texelFetch(instance_data, texel + 2), texelFetch(instance_data, texel + 3)
+    );
+
+    gl_Position = view_proj_matrix * (model_matrix * vec4(vertex_pos, 1.0));
+}
+)""
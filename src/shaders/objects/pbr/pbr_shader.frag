@@ -24,9 +24,8 @@ out vec4 color_out;
 #ifdef USING_VERTEX_NORMALS
     in vec3 frag_normal;
 #endif
-#ifdef USING_FRAGMENT_POSITION
-    in vec3 frag_pos;
-#endif
+in vec3 frag_pos;
+flat in ivec4 object_lights[2];
 #ifdef USING_IBL
     in vec3 frag_camera_position;
 #endif
@@ -40,6 +39,7 @@ out vec4 color_out;
 
 struct PointLight {
     vec3 position;
+    float range;
     vec3 color;
 };
 struct SpotLight {
@@ -49,6 +49,40 @@ struct SpotLight {
     float inner_cutoff_angle_cos, outer_cutoff_angle_cos;
 };
 
+// Layouts of the blocks must match the structs in UniformBlocks.hpp.
+layout(std140) uniform FrameData {
+    mat4 view_proj_matrix;
+    mat4 shadow_view_proj_matrix;
+    vec3 camera_position;
+    float pcf_sparsity;
+    vec3 shadow_light_direction;
+    float shadow_map_bias_at_45_deg;
+    vec3 ambient;
+    int point_lights_count;
+    vec3 camera_forward;
+    float cluster_z_scale;
+    vec2 cluster_xy_scale;
+    float cluster_z_bias;
+    int light_assignment;
+    vec3 sh_coefficients[9];
+    PointLight point_lights[MAX_POINT_LIGHTS];
+};
+// UV transforms have offsets in xy and scales in zw.
+layout(std140) uniform MaterialData {
+    vec4 base_color_factor;
+    vec3 emissive_factor;
+    float normal_map_scale;
+    float metallic_factor;
+    float roughness_factor;
+    float ao_factor;
+    vec4 uv_transform;
+    vec4 base_uv_transform;
+    vec4 normal_uv_transform;
+    vec4 metallic_uv_transform;
+    vec4 roughness_uv_transform;
+    vec4 ao_uv_transform;
+};
+
 // Not all uniforms are used at the same time.
 // Unused ones will be optimized out.
 uniform sampler2D base_color_texture;
@@ -61,18 +95,8 @@ uniform sampler2DShadow shadow_map;
 uniform samplerCube irradiance_map;
 uniform samplerCube prefiltered_specular_map;
 uniform sampler2D brdf_integration_map;
-uniform vec3 camera_position;
-uniform vec4 base_color_factor;
-uniform vec3 emissive_factor;
-uniform float normal_map_scale;
-uniform float metallic_factor;
-uniform float roughness_factor;
-uniform float ao_factor;
-uniform vec3 ambient;
-uniform float pcf_sparsity;
-#if POINT_LIGHTS_COUNT > 0
-    uniform PointLight point_lights[POINT_LIGHTS_COUNT];
-#endif
+// Offsets and counts of light indices of the clusters, then the indices.
+uniform usamplerBuffer light_clusters;
 #if SPOT_LIGHTS_COUNT > 0
     uniform SpotLight spot_lights[SPOT_LIGHTS_COUNT];
 #endif
@@ -313,7 +337,26 @@ vec3 cook_torrance_brdf(vec3 surf_refl, float ndf, float gsf, vec3 n, vec3 v, ve
     return numerator / denominator;
 }
 
+#ifdef USING_SH_IRRADIANCE
+    // Must match SphericalHarmonics::evaluate.
+    vec3 evaluate_sh_irradiance(vec3 n) {
+        return
+            sh_coefficients[0] * 0.282095 +
+            sh_coefficients[1] * (0.488603 * n.y) +
+            sh_coefficients[2] * (0.488603 * n.z) +
+            sh_coefficients[3] * (0.488603 * n.x) +
+            sh_coefficients[4] * (1.092548 * n.x * n.y) +
+            sh_coefficients[5] * (1.092548 * n.y * n.z) +
+            sh_coefficients[6] * (0.315392 * (3.0 * n.z * n.z - 1.0)) +
+            sh_coefficients[7] * (1.092548 * n.x * n.z) +
+            sh_coefficients[8] * (0.546274 * (n.x * n.x - n.y * n.y));
+    }
+#endif
+
 const float LAST_PREFILTERED_MIPMAP_LEVEL = 8.0;
+// Values of light_assignment other than all lights, see QualitySettings.
+const int CLUSTERED_LIGHTS = 1;
+const int OBJECT_LIGHTS = 2;
 void main() {
     // Compute surface reflection ratio at zero incedence.
     vec3 refl_ratio_at_zero_inc = vec3(0.04);
@@ -338,7 +381,11 @@ void main() {
             get_roughness()
         );
         vec3 refraction_ratio = (vec3(1.0) - reflection_ratio) * (1.0 - get_metallic());
-        vec3 ambient_irradiance = texture(irradiance_map, get_normal()).rgb;
+        #ifdef USING_SH_IRRADIANCE
+            vec3 ambient_irradiance = max(evaluate_sh_irradiance(get_normal()), 0.0);
+        #else
+            vec3 ambient_irradiance = texture(irradiance_map, get_normal()).rgb;
+        #endif
         vec3 diffuse = ambient_irradiance * get_base_color().rgb;
 
         // Specular part.
@@ -359,33 +406,61 @@ void main() {
         lightning_result = ambient * get_ao();
     #endif
 
-    #if POINT_LIGHTS_COUNT > 0
-        for (int i = 0; i < POINT_LIGHTS_COUNT; i++) {
-            // Calculate vectors that we will need later.
-            float dist_to_frag = length(point_lights[i].position - frag_pos);
-            vec3 light_direction = (point_lights[i].position - frag_pos) / dist_to_frag;
-            vec3 halfway = normalize(view_direction + light_direction);
-            float attenuation = 1.0 / (dist_to_frag * dist_to_frag);
+    int first_light_index = 0;
+    int lights_count = point_lights_count;
+    if (light_assignment == CLUSTERED_LIGHTS) {
+        float view_depth = max(dot(frag_pos - camera_position, camera_forward), 1e-4);
+        ivec3 cluster_coords = clamp(
+            ivec3(ivec2(gl_FragCoord.xy * cluster_xy_scale), int(floor(log(view_depth) * cluster_z_scale + cluster_z_bias))),
+            ivec3(0), ivec3(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z) - 1
+        );
+        int cluster = (cluster_coords.z * CLUSTERS_Y + cluster_coords.y) * CLUSTERS_X + cluster_coords.x;
+        first_light_index = int(texelFetch(light_clusters, cluster * 2).r);
+        lights_count = int(texelFetch(light_clusters, cluster * 2 + 1).r);
+    }
+    else if (light_assignment == OBJECT_LIGHTS) {
+        lights_count = MAX_OBJECT_LIGHTS;
+    }
+
+    for (int light = 0; light < lights_count; light++) {
+        int i = light;
+        if (light_assignment == CLUSTERED_LIGHTS) {
+            i = int(texelFetch(light_clusters, first_light_index + light).r);
+        }
+        else if (light_assignment == OBJECT_LIGHTS) {
+            // Object lights are sorted, unused ones are at the end.
+            i = object_lights[light / 4][light % 4];
+            if (i < 0) {
+                break;
+            }
+        }
 
-            // Compute radiance.
-            vec3 radiance = point_lights[i].color * attenuation;
+        // Calculate vectors that we will need later.
+        float dist_to_frag = length(point_lights[i].position - frag_pos);
+        vec3 light_direction = (point_lights[i].position - frag_pos) / dist_to_frag;
+        vec3 halfway = normalize(view_direction + light_direction);
+        // Inverse square, smoothly windowed to zero at the range.
+        float window = clamp(1.0 - pow(dist_to_frag / point_lights[i].range, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (dist_to_frag * dist_to_frag);
 
-            // Compute surface reflection ratio.
-            vec3 reflection_ratio = fresnel_schlick(max(dot(halfway, view_direction), 0.0), refl_ratio_at_zero_inc);
-            // Compute results of the normal distribution function and the geometric shadowing function.
-            float ndf = normal_distribution_ggx(get_roughness(), get_normal(), halfway, view_direction);
-            float gsf = geometric_shadowing_smith(get_normal(), view_direction, light_direction, get_roughness());
+        // Compute radiance.
+        vec3 radiance = point_lights[i].color * attenuation;
 
-            // Compute specular using Cook-Torrance BRDF.
-            vec3 specular = cook_torrance_brdf(reflection_ratio, ndf, gsf, get_normal(), view_direction, light_direction);
+        // Compute surface reflection ratio.
+        vec3 reflection_ratio = fresnel_schlick(max(dot(halfway, view_direction), 0.0), refl_ratio_at_zero_inc);
+        // Compute results of the normal distribution function and the geometric shadowing function.
+        float ndf = normal_distribution_ggx(get_roughness(), get_normal(), halfway, view_direction);
+        float gsf = geometric_shadowing_smith(get_normal(), view_direction, light_direction, get_roughness());
 
-            vec3 refraction_ratio = (vec3(1.0) - reflection_ratio) * (1.0 - get_metallic());
+        // Compute specular using Cook-Torrance BRDF.
+        vec3 specular = cook_torrance_brdf(reflection_ratio, ndf, gsf, get_normal(), view_direction, light_direction);
 
-            // Calculate the outgoing radiance (result contribution).
-            float n_dot_l = dot(get_normal(), light_direction);
-            lightning_result += max((refraction_ratio * vec3(get_base_color()) / PI + specular) * radiance * n_dot_l, 0.0);
-        }
-    #endif
+        vec3 refraction_ratio = (vec3(1.0) - reflection_ratio) * (1.0 - get_metallic());
+
+        // Calculate the outgoing radiance (result contribution).
+        float n_dot_l = dot(get_normal(), light_direction);
+        lightning_result += max((refraction_ratio * vec3(get_base_color()) / PI + specular) * radiance * n_dot_l, 0.0);
+    }
     color_out = vec4(lightning_result + get_emissive() * 10.0, 1.0);
 }
 )""
\ No newline at end of file
@@ -6,14 +6,19 @@ layout(location = 0) in vec3 vertex_pos;
     layout(location = 1) in vec2 vertex_uv;
 #endif
 #ifdef USING_VERTEX_NORMALS
-    layout(location = 2) in vec3 vertex_normal;
+    layout(location = 2) in vec2 vertex_normal_octahedral;
 #endif
 #ifdef USING_NORMAL_TEXTURE
     layout(location = 3) in vec4 vertex_tangent;
 #endif
+#ifdef USING_INSTANCING
+    // Includes the base instance of indirect draws, unlike gl_InstanceID.
+    layout(location = 4) in uint instance_index;
+#endif
 
 struct PointLight {
     vec3 position;
+    float range;
     vec3 color;
 };
 struct SpotLight {
@@ -23,28 +28,49 @@ struct SpotLight {
     float inner_cutoff_angle_cos, outer_cutoff_angle_cos;
 };
 
-// Not all uniforms are used at the same time.
-// Unused ones will be optimized out.
-uniform mat4 mvp;
-uniform mat4 model_matrix;
-uniform mat4 normal_matrix;
-uniform vec2 uv_offset;
-uniform vec2 uv_scale;
-uniform vec2 base_uv_offset;
-uniform vec2 base_uv_scale;
-uniform vec2 normal_uv_offset;
-uniform vec2 normal_uv_scale;
-uniform vec2 metallic_uv_offset;
-uniform vec2 metallic_uv_scale;
-uniform vec2 roughness_uv_offset;
-uniform vec2 roughness_uv_scale;
-uniform vec2 ao_uv_offset;
-uniform vec2 ao_uv_scale;
-uniform mat4 shadow_view_proj_matrix;
-uniform float shadow_map_bias_at_45_deg;
-uniform vec3 shadow_light_direction;
-#if POINT_LIGHTS_COUNT > 0
-    uniform PointLight point_lights[POINT_LIGHTS_COUNT];
+// Layouts of the blocks must match the structs in UniformBlocks.hpp.
+layout(std140) uniform FrameData {
+    mat4 view_proj_matrix;
+    mat4 shadow_view_proj_matrix;
+    vec3 camera_position;
+    float pcf_sparsity;
+    vec3 shadow_light_direction;
+    float shadow_map_bias_at_45_deg;
+    vec3 ambient;
+    int point_lights_count;
+    vec3 camera_forward;
+    float cluster_z_scale;
+    vec2 cluster_xy_scale;
+    float cluster_z_bias;
+    int light_assignment;
+    vec3 sh_coefficients[9];
+    PointLight point_lights[MAX_POINT_LIGHTS];
+};
+// UV transforms have offsets in xy and scales in zw.
+layout(std140) uniform MaterialData {
+    vec4 base_color_factor;
+    vec3 emissive_factor;
+    float normal_map_scale;
+    float metallic_factor;
+    float roughness_factor;
+    float ao_factor;
+    vec4 uv_transform;
+    vec4 base_uv_transform;
+    vec4 normal_uv_transform;
+    vec4 metallic_uv_transform;
+    vec4 roughness_uv_transform;
+    vec4 ao_uv_transform;
+};
+#ifdef USING_INSTANCING
+    // Model matrix and normal matrix columns and object lights of every instance, see InstanceBuffer.
+    uniform samplerBuffer instance_data;
+    uniform int first_instance;
+#else
+    layout(std140) uniform DrawData {
+        mat4 model_matrix;
+        mat4 normal_matrix;
+        ivec4 draw_object_lights[2];
+    };
 #endif
 #if SPOT_LIGHTS_COUNT > 0
     uniform SpotLight spot_lights[SPOT_LIGHTS_COUNT];
@@ -71,9 +97,9 @@ uniform vec3 shadow_light_direction;
 #ifdef USING_VERTEX_NORMALS
     out vec3 frag_normal;
 #endif
-#ifdef USING_FRAGMENT_POSITION
-    out vec3 frag_pos;
-#endif
+out vec3 frag_pos;
+// Lights used if they are assigned per object, -1 for unused.
+flat out ivec4 object_lights[2];
 #ifdef USING_NORMAL_TEXTURE
     out mat3 tbn;
 #endif
@@ -82,51 +108,81 @@ uniform vec3 shadow_light_direction;
     out float shadow_map_bias;
 #endif
 
+// Depth must be equal to the one of the depth pre-pass.
+invariant gl_Position;
+
 const float COS_45_DEG = 0.7071067812;
 
+vec3 decode_octahedral(vec2 encoded) {
+    vec3 result = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (result.z < 0.0) {
+        vec2 signs = vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+        result.xy = (1.0 - abs(result.yx)) * signs;
+    }
+    return normalize(result);
+}
+
 void main() {
-    gl_Position = mvp * vec4(vertex_pos, 1.0);
+    #ifdef USING_INSTANCING
+        int texel = (first_instance + int(instance_index)) * TEXELS_PER_INSTANCE;
+        mat4 model_matrix = mat4(
+            texelFetch(instance_data, texel), texelFetch(instance_data, texel + 1),
+            texelFetch(instance_data, texel + 2), texelFetch(instance_data, texel + 3)
+        );
+        mat4 normal_matrix = mat4(
+            texelFetch(instance_data, texel + 4), texelFetch(instance_data, texel + 5),
+            texelFetch(instance_data, texel + 6), vec4(0.0, 0.0, 0.0, 1.0)
+        );
+    #endif
+
+    gl_Position = view_proj_matrix * (model_matrix * vec4(vertex_pos, 1.0));
 
     #ifdef USING_VERTEX_NORMALS
+        vec3 vertex_normal = decode_octahedral(vertex_normal_octahedral);
         vec3 normal = normalize((normal_matrix * vec4(vertex_normal, 0.0)).xyz);
         frag_normal = normal;
 
         #ifdef USING_NORMAL_TEXTURE
-            vec3 tangent = (normal_matrix * vec4(vertex_tangent.xyz, 0.0)).xyz;
-            vec3 bitangent = cross(normal, tangent) * vertex_tangent.w;
+            vec3 tangent = normalize((normal_matrix * vec4(vertex_tangent.xyz, 0.0)).xyz);
+            // The 2-bit handedness may be normalized to +-1/3 by some implementations.
+            vec3 bitangent = cross(normal, tangent) * sign(vertex_tangent.w);
             tbn = mat3(tangent, bitangent, normal);
         #endif
     #endif
 
-    #ifdef USING_FRAGMENT_POSITION
-        frag_pos = (model_matrix * vec4(vertex_pos, 1.0)).xyz;
+    frag_pos = (model_matrix * vec4(vertex_pos, 1.0)).xyz;
+    #ifdef USING_INSTANCING
+        object_lights[0] = ivec4(texelFetch(instance_data, texel + 7));
+        object_lights[1] = ivec4(texelFetch(instance_data, texel + 8));
+    #else
+        object_lights = draw_object_lights;
     #endif
 
     #ifdef USING_UV
         #ifdef USING_GENERAL_UV_TRANSFORM
-            frag_uv = vertex_uv * uv_scale + uv_offset;
+            frag_uv = vertex_uv * uv_transform.zw + uv_transform.xy;
         #else
             frag_uv = vertex_uv;
         #endif
 
         #ifdef USING_BASE_UV_TRANSFORM
-            frag_base_uv = vertex_uv * base_uv_scale + base_uv_offset;
+            frag_base_uv = vertex_uv * base_uv_transform.zw + base_uv_transform.xy;
         #endif
 
         #ifdef USING_NORMAL_UV_TRANSFORM
-            frag_normal_uv = vertex_uv * normal_uv_scale + normal_uv_offset;
+            frag_normal_uv = vertex_uv * normal_uv_transform.zw + normal_uv_transform.xy;
         #endif
 
         #ifdef USING_METALLIC_UV_TRANSFORM
-            frag_metallic_uv = vertex_uv * metallic_uv_scale + metallic_uv_offset;
+            frag_metallic_uv = vertex_uv * metallic_uv_transform.zw + metallic_uv_transform.xy;
         #endif
 
         #ifdef USING_ROUGHNESS_UV_TRANSFORM
-            frag_roughness_uv = vertex_uv * roughness_uv_scale + roughness_uv_offset;
+            frag_roughness_uv = vertex_uv * roughness_uv_transform.zw + roughness_uv_transform.xy;
         #endif
 
         #ifdef USING_AO_UV_TRANSFORM
-            frag_ao_uv = vertex_uv * ao_uv_scale + ao_uv_offset;
+            frag_ao_uv = vertex_uv * ao_uv_transform.zw + ao_uv_transform.xy;
         #endif
     #endif
 
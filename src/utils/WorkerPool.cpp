@@ -0,0 +1,114 @@
+#include "WorkerPool.hpp"
+
+#include <utility>
+#include <algorithm>
+
+using namespace llengine;
+
+static thread_local bool running_job = false;
+
+namespace {
+// Jobs can't be nested, so the flag is simply reset at the end.
+struct RunningJobScope {
+    RunningJobScope() noexcept { running_job = true; }
+    ~RunningJobScope() { running_job = false; }
+};
+}
+
+WorkerPool::WorkerPool(std::uint32_t workers_count) {
+    if (workers_count == 0) {
+        workers_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    }
+
+    workers.reserve(workers_count);
+    for (std::uint32_t i = 0; i < workers_count; i++) {
+        workers.emplace_back(&WorkerPool::worker_loop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock {mutex};
+        stopping = true;
+    }
+    job_started.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(std::size_t tasks_count, const std::function<void(std::size_t)>& job) {
+    // Waking the workers is not worth it for a single task.
+    if (workers.empty() || tasks_count <= 1) {
+        RunningJobScope scope;
+        for (std::size_t task = 0; task < tasks_count; task++) {
+            job(task);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock {mutex};
+        this->job = &job;
+        this->tasks_count = tasks_count;
+        next_task = 0;
+        busy_workers_count = workers.size();
+        job_generation++;
+    }
+    job_started.notify_all();
+
+    execute_tasks();
+
+    std::unique_lock lock {mutex};
+    job_finished.wait(lock, [this] { return busy_workers_count == 0; });
+    this->job = nullptr;
+
+    if (exception != nullptr) {
+        std::rethrow_exception(std::exchange(exception, nullptr));
+    }
+}
+
+void WorkerPool::worker_loop() {
+    std::uint64_t last_job_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock {mutex};
+            job_started.wait(lock, [&] { return stopping || job_generation != last_job_generation; });
+            if (stopping) {
+                return;
+            }
+            last_job_generation = job_generation;
+        }
+
+        execute_tasks();
+
+        bool last_one = false;
+        {
+            std::lock_guard lock {mutex};
+            last_one = --busy_workers_count == 0;
+        }
+        if (last_one) {
+            job_finished.notify_one();
+        }
+    }
+}
+
+[[nodiscard]] bool WorkerPool::is_running_job() noexcept {
+    return running_job;
+}
+
+void WorkerPool::execute_tasks() {
+    RunningJobScope scope;
+    for (std::size_t task = next_task++; task < tasks_count; task = next_task++) {
+        try {
+            (*job)(task);
+        }
+        catch (...) {
+            std::lock_guard lock {mutex};
+            if (exception == nullptr) {
+                exception = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace llengine {
+/**
+ * @brief Persistent threads for work that is split into tasks every frame,
+ * where spawning threads each time would cost more than the work itself.
+ *
+ * The calling thread takes tasks too, so there is no handoff latency when
+ * the workers are still asleep.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param workers_count Amount of threads besides the calling one. If zero,
+     * one less than the hardware concurrency.
+     */
+    explicit WorkerPool(std::uint32_t workers_count = 0);
+    WorkerPool(const WorkerPool& other) = delete;
+    WorkerPool(WorkerPool&& other) = delete;
+    ~WorkerPool();
+
+    WorkerPool& operator=(const WorkerPool& other) = delete;
+    WorkerPool& operator=(WorkerPool&& other) = delete;
+
+    /**
+     * @brief Calls job(task) for every task in [0, tasks_count) on the workers
+     * and the calling thread, returns when all of them are done.
+     *
+     * Must not be called from several threads at once or from a job. The first
+     * exception thrown by the job is rethrown after all tasks are done.
+     */
+    void run(std::size_t tasks_count, const std::function<void(std::size_t)>& job);
+
+    /**
+     * @brief Whether the current thread is executing a job of some pool. Code
+     * that is not safe to call concurrently can assert that it is not.
+     */
+    [[nodiscard]] static bool is_running_job() noexcept;
+
+    /**
+     * @brief Workers and the calling thread.
+     */
+    [[nodiscard]] std::uint32_t get_threads_count() const noexcept {
+        return static_cast<std::uint32_t>(workers.size()) + 1;
+    }
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable job_started;
+    std::condition_variable job_finished;
+    // Incremented for every job, so workers tell a new job from a spurious wakeup.
+    std::uint64_t job_generation = 0;
+    const std::function<void(std::size_t)>* job = nullptr;
+    std::size_t tasks_count = 0;
+    std::atomic<std::size_t> next_task = 0;
+    std::size_t busy_workers_count = 0;
+    std::exception_ptr exception;
+    bool stopping = false;
+
+    void worker_loop();
+    void execute_tasks();
+};
+}
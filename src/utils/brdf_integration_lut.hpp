@@ -0,0 +1,17 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace llengine::tex_utils {
+constexpr std::uint32_t BRDF_INTEGRATION_LUT_SIZE = 256;
+
+/**
+ * @brief Scale and bias to F0 from the split sum approximation.
+ *
+ * Contains pairs of half floats, row by row. Columns correspond to roughness
+ * and rows to the cosine between normal and view direction. Defined in the
+ * source file generated at build time by tools/generate_brdf_integration_lut.cpp.
+ */
+extern const std::array<std::uint16_t, BRDF_INTEGRATION_LUT_SIZE * BRDF_INTEGRATION_LUT_SIZE * 2> BRDF_INTEGRATION_LUT;
+}
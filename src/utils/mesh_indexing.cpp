@@ -0,0 +1,249 @@
+#include "mesh_indexing.hpp"
+
+#include <bit>
+#include <array>
+#include <thread>
+#include <cstring>
+#include <functional>
+#include <algorithm>
+
+using namespace llengine;
+using namespace llengine::mesh_indexing;
+
+namespace {
+/**
+ * @brief Hashes and compares vertices by the bits of their attributes, so
+ * -0.0 and 0.0 are different and equal NaNs are merged.
+ */
+class VertexKeys {
+public:
+    VertexKeys(const VertexStreams& streams, bool compare_tangents) :
+        streams(streams), compare_tangents(compare_tangents && !streams.tangents.empty()) {}
+
+    [[nodiscard]] std::uint64_t hash(std::uint32_t vertex) const {
+        std::uint64_t result = 0x9E3779B97F4A7C15u;
+        mix(result, streams.positions, vertex);
+        mix(result, streams.uvs, vertex);
+        mix(result, streams.normals, vertex);
+        if (compare_tangents) {
+            mix(result, streams.tangents, vertex);
+        }
+
+        // Final avalanche, from MurmurHash3.
+        result ^= result >> 33;
+        result *= 0xFF51AFD7ED558CCDu;
+        result ^= result >> 33;
+        return result;
+    }
+
+    /**
+     * @return Negative, zero or positive value like std::memcmp.
+     */
+    [[nodiscard]] int compare(std::uint32_t vertex_1, std::uint32_t vertex_2) const {
+        int result = compare_stream(streams.positions, vertex_1, vertex_2);
+        if (result == 0) {
+            result = compare_stream(streams.uvs, vertex_1, vertex_2);
+        }
+        if (result == 0) {
+            result = compare_stream(streams.normals, vertex_1, vertex_2);
+        }
+        if (result == 0 && compare_tangents) {
+            result = compare_stream(streams.tangents, vertex_1, vertex_2);
+        }
+        return result;
+    }
+
+private:
+    const VertexStreams& streams;
+    bool compare_tangents;
+
+    template<typename T>
+    static void mix(std::uint64_t& hash, std::span<const T> stream, std::uint32_t vertex) {
+        if (stream.empty()) {
+            return;
+        }
+
+        std::array<std::uint32_t, sizeof(T) / sizeof(std::uint32_t)> bits;
+        std::memcpy(bits.data(), &stream[vertex], sizeof(T));
+        for (const std::uint32_t component : bits) {
+            hash = (hash ^ component) * 0x100000001B3u;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] static int compare_stream(std::span<const T> stream, std::uint32_t vertex_1, std::uint32_t vertex_2) {
+        return stream.empty() ? 0 : std::memcmp(&stream[vertex_1], &stream[vertex_2], sizeof(T));
+    }
+};
+
+[[nodiscard]] std::uint32_t resolve_threads_count(std::uint32_t threads_count, std::size_t jobs_count) {
+    if (threads_count == 0) {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return static_cast<std::uint32_t>(std::clamp<std::size_t>(threads_count, 1, std::max<std::size_t>(jobs_count, 1)));
+}
+
+/**
+ * @brief Calls job(first, last) for threads_count equal parts of [0, size) in parallel.
+ */
+template<typename Job>
+void run_in_parallel(std::size_t size, std::uint32_t threads_count, const Job& job) {
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+    for (std::uint32_t i = 0; i < threads_count; i++) {
+        const std::size_t first = size * i / threads_count;
+        const std::size_t last = size * (i + 1) / threads_count;
+
+        // The current thread takes the last part itself.
+        if (i + 1 == threads_count) {
+            job(first, last);
+        }
+        else {
+            threads.emplace_back(job, first, last);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Sorts equal parts on separate threads, then merges neighbour parts
+ * pairwise, also in parallel.
+ */
+template<typename T, typename Compare>
+void parallel_sort(std::vector<T>& values, const Compare& compare, std::uint32_t threads_count) {
+    std::vector<std::size_t> bounds(threads_count + 1);
+    for (std::uint32_t i = 0; i <= threads_count; i++) {
+        bounds[i] = values.size() * i / threads_count;
+    }
+
+    run_in_parallel(threads_count, threads_count, [&] (std::size_t first, std::size_t last) {
+        for (std::size_t part = first; part < last; part++) {
+            std::sort(values.begin() + bounds[part], values.begin() + bounds[part + 1], compare);
+        }
+    });
+
+    for (std::size_t width = 1; width < threads_count; width *= 2) {
+        const std::size_t merges_count = (threads_count + 2 * width - 1) / (2 * width);
+        run_in_parallel(merges_count, resolve_threads_count(threads_count, merges_count), [&] (std::size_t first, std::size_t last) {
+            for (std::size_t merge = first; merge < last; merge++) {
+                const std::size_t left = merge * 2 * width;
+                const std::size_t middle = std::min<std::size_t>(left + width, threads_count);
+                const std::size_t right = std::min<std::size_t>(left + 2 * width, threads_count);
+                std::inplace_merge(
+                    values.begin() + bounds[left], values.begin() + bounds[middle],
+                    values.begin() + bounds[right], compare
+                );
+            }
+        });
+    }
+}
+}
+
+[[nodiscard]] IndexingResult mesh_indexing::index_with_hash_table(const VertexStreams& streams, bool compare_tangents) {
+    const VertexKeys keys(streams, compare_tangents);
+    const std::size_t vertices_count = streams.positions.size();
+
+    IndexingResult result;
+    result.indices.resize(vertices_count);
+
+    // Linear probing with the load factor not above 0.5.
+    constexpr std::uint32_t EMPTY_SLOT = UINT32_MAX;
+    struct Slot {
+        std::uint32_t hash = 0;
+        std::uint32_t unique_vertex = EMPTY_SLOT;
+    };
+    const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(vertices_count * 2, 16));
+    const std::size_t mask = capacity - 1;
+    std::vector<Slot> slots(capacity);
+
+    for (std::uint32_t vertex = 0; vertex < vertices_count; vertex++) {
+        const std::uint64_t hash = keys.hash(vertex);
+        const std::uint32_t short_hash = static_cast<std::uint32_t>(hash >> 32);
+
+        for (std::size_t slot_index = hash & mask;; slot_index = (slot_index + 1) & mask) {
+            Slot& slot = slots[slot_index];
+            if (slot.unique_vertex == EMPTY_SLOT) {
+                slot.hash = short_hash;
+                slot.unique_vertex = static_cast<std::uint32_t>(result.unique_vertices.size());
+                result.indices[vertex] = slot.unique_vertex;
+                result.unique_vertices.push_back(vertex);
+                break;
+            }
+            if (slot.hash == short_hash && keys.compare(result.unique_vertices[slot.unique_vertex], vertex) == 0) {
+                result.indices[vertex] = slot.unique_vertex;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]] IndexingResult mesh_indexing::index_with_parallel_sort(
+    const VertexStreams& streams, bool compare_tangents, std::uint32_t threads_count
+) {
+    const VertexKeys keys(streams, compare_tangents);
+    const std::size_t vertices_count = streams.positions.size();
+    threads_count = resolve_threads_count(threads_count, vertices_count);
+
+    // Sorting the hashes together with the vertices keeps the comparisons
+    // away from the attribute streams.
+    struct HashedVertex {
+        std::uint64_t hash;
+        std::uint32_t vertex;
+
+        [[nodiscard]] bool operator<(const HashedVertex& other) const {
+            return hash != other.hash ? hash < other.hash : vertex < other.vertex;
+        }
+    };
+    std::vector<HashedVertex> order(vertices_count);
+    run_in_parallel(vertices_count, threads_count, [&] (std::size_t first, std::size_t last) {
+        for (std::size_t vertex = first; vertex < last; vertex++) {
+            order[vertex] = {keys.hash(static_cast<std::uint32_t>(vertex)), static_cast<std::uint32_t>(vertex)};
+        }
+    });
+    parallel_sort(order, std::less<HashedVertex>(), threads_count);
+
+    // Equal vertices now are in runs of equal hashes, ordered by their positions
+    // in the mesh. Runs are short, unless there are collisions.
+    std::vector<std::uint32_t> first_occurrences(vertices_count);
+    run_in_parallel(vertices_count, threads_count, [&] (std::size_t first, std::size_t last) {
+        // Start from a run beginning.
+        while (first != 0 && first < last && order[first - 1].hash == order[first].hash) {
+            first++;
+        }
+        for (std::size_t run_begin = first, run_end = first; run_begin < last; run_begin = run_end) {
+            while (run_end < vertices_count && order[run_end].hash == order[run_begin].hash) {
+                run_end++;
+            }
+            for (std::size_t i = run_begin; i < run_end; i++) {
+                std::size_t match = run_begin;
+                while (keys.compare(order[match].vertex, order[i].vertex) != 0) {
+                    match++;
+                }
+                first_occurrences[order[i].vertex] = order[match].vertex;
+            }
+        }
+    });
+
+    IndexingResult result;
+    result.indices.resize(vertices_count);
+    for (std::uint32_t vertex = 0; vertex < vertices_count; vertex++) {
+        if (first_occurrences[vertex] == vertex) {
+            result.indices[vertex] = static_cast<std::uint32_t>(result.unique_vertices.size());
+            result.unique_vertices.push_back(vertex);
+        }
+    }
+
+    run_in_parallel(vertices_count, threads_count, [&] (std::size_t first, std::size_t last) {
+        for (std::size_t vertex = first; vertex < last; vertex++) {
+            if (first_occurrences[vertex] != vertex) {
+                result.indices[vertex] = result.indices[first_occurrences[vertex]];
+            }
+        }
+    });
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Merging of bit-exact duplicate vertices. Both algorithms produce the same
+ * result: unique vertices are ordered by their first occurrence.
+ */
+namespace llengine::mesh_indexing {
+/**
+ * @brief Non-interleaved vertex attributes. Absent attributes are empty,
+ * others must have as many elements as positions.
+ */
+struct VertexStreams {
+    std::span<const glm::vec3> positions;
+    std::span<const glm::vec2> uvs;
+    std::span<const glm::vec3> normals;
+    std::span<const glm::vec4> tangents;
+};
+
+struct IndexingResult {
+    std::vector<std::uint32_t> indices;
+    // Index of the source vertex for every unique vertex.
+    std::vector<std::uint32_t> unique_vertices;
+};
+
+/**
+ * @brief Deduplicates vertices with an open-addressing hash table.
+ *
+ * @param compare_tangents If false, vertices differing only in tangents
+ * are merged and the tangent of the first one is kept.
+ */
+[[nodiscard]] IndexingResult index_with_hash_table(const VertexStreams& streams, bool compare_tangents);
+/**
+ * @brief Deduplicates vertices by sorting them on several threads.
+ * Faster than the hash table for meshes with millions of vertices on several cores.
+ *
+ * @param threads_count 0 to use std::thread::hardware_concurrency.
+ */
+[[nodiscard]] IndexingResult index_with_parallel_sort(
+    const VertexStreams& streams, bool compare_tangents, std::uint32_t threads_count = 0
+);
+}
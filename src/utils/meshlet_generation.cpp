@@ -0,0 +1,175 @@
+#include "meshlet_generation.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <numeric>
+#include <algorithm>
+
+using namespace llengine;
+
+namespace {
+/**
+ * @brief Triangles adjacent to every vertex in the compressed sparse row form.
+ */
+struct VertexTriangles {
+    // Triangles of the vertex i are in [offsets[i], offsets[i + 1]).
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> triangles;
+};
+
+[[nodiscard]] VertexTriangles find_vertex_triangles(
+    std::size_t vertices_count, std::span<const std::uint32_t> indices
+) {
+    VertexTriangles result;
+    result.offsets.assign(vertices_count + 1, 0);
+    for (const std::uint32_t index : indices) {
+        result.offsets[index + 1]++;
+    }
+    std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+
+    result.triangles.resize(indices.size());
+    std::vector<std::uint32_t> write_positions(result.offsets.begin(), result.offsets.end() - 1);
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        result.triangles[write_positions[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+    return result;
+}
+
+[[nodiscard]] Meshlet compute_bounds(std::span<const glm::vec3> positions, std::span<const std::uint32_t> indices) {
+    glm::vec3 min {std::numeric_limits<float>::max()};
+    glm::vec3 max {std::numeric_limits<float>::lowest()};
+    for (const std::uint32_t index : indices) {
+        min = glm::min(min, positions[index]);
+        max = glm::max(max, positions[index]);
+    }
+
+    Meshlet result;
+    result.bounding_sphere_center = (min + max) * 0.5f;
+    for (const std::uint32_t index : indices) {
+        result.bounding_sphere_radius = std::max(
+            result.bounding_sphere_radius, glm::distance(result.bounding_sphere_center, positions[index])
+        );
+    }
+
+    const auto get_normal = [&] (std::size_t triangle) -> std::optional<glm::vec3> {
+        const glm::vec3& a = positions[indices[triangle * 3]];
+        const glm::vec3 normal = glm::cross(
+            positions[indices[triangle * 3 + 1]] - a, positions[indices[triangle * 3 + 2]] - a
+        );
+        const float length = glm::length(normal);
+        return length == 0.0f ? std::nullopt : std::optional(normal / length);
+    };
+
+    glm::vec3 normals_sum {0.0f};
+    for (std::size_t triangle = 0; triangle < indices.size() / 3; triangle++) {
+        normals_sum += get_normal(triangle).value_or(glm::vec3(0.0f));
+    }
+    const float normals_sum_length = glm::length(normals_sum);
+    if (normals_sum_length == 0.0f) {
+        return result;
+    }
+
+    const glm::vec3 axis = normals_sum / normals_sum_length;
+    float min_dot = 1.0f;
+    for (std::size_t triangle = 0; triangle < indices.size() / 3; triangle++) {
+        const auto normal = get_normal(triangle);
+        if (normal.has_value()) {
+            min_dot = std::min(min_dot, glm::dot(axis, *normal));
+        }
+    }
+
+    // Cones this wide are almost never culled.
+    if (min_dot <= 0.1f) {
+        return result;
+    }
+
+    // Triangles face away if the angle between the view direction and
+    // the axis is at most 90 degrees minus the cone angle.
+    result.cone_axis = axis;
+    result.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+    return result;
+}
+}
+
+[[nodiscard]] std::vector<Meshlet> meshlet_generation::build_meshlets(
+    std::span<const glm::vec3> positions, std::vector<std::uint32_t>& indices,
+    std::size_t max_triangles, std::size_t max_vertices
+) {
+    max_triangles = std::max<std::size_t>(max_triangles, 1);
+    max_vertices = std::max<std::size_t>(max_vertices, 3);
+
+    const std::size_t triangles_count = indices.size() / 3;
+    const VertexTriangles vertex_triangles = find_vertex_triangles(
+        positions.size(), std::span(indices).first(triangles_count * 3)
+    );
+
+    std::vector<bool> assigned(triangles_count, false);
+    // The last meshlet that got the vertex, to count unique vertices.
+    std::vector<std::uint32_t> vertex_meshlets(positions.size(), std::numeric_limits<std::uint32_t>::max());
+    std::vector<std::uint32_t> result_indices;
+    result_indices.reserve(indices.size());
+    std::vector<Meshlet> result;
+    std::vector<std::uint32_t> candidates;
+
+    std::size_t next_seed = 0;
+    while (true) {
+        while (next_seed < triangles_count && assigned[next_seed]) {
+            next_seed++;
+        }
+        if (next_seed == triangles_count) {
+            break;
+        }
+
+        const auto meshlet_id = static_cast<std::uint32_t>(result.size());
+        const std::size_t first_index = result_indices.size();
+        std::size_t meshlet_vertices = 0;
+        std::size_t meshlet_triangles = 0;
+
+        // Breadth-first growth over triangles sharing vertices keeps meshlets compact.
+        candidates.assign(1, static_cast<std::uint32_t>(next_seed));
+        for (std::size_t i = 0; i < candidates.size() && meshlet_triangles < max_triangles; i++) {
+            const std::uint32_t triangle = candidates[i];
+            if (assigned[triangle]) {
+                continue;
+            }
+
+            std::size_t new_vertices = 0;
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                if (vertex_meshlets[indices[triangle * 3 + corner]] != meshlet_id) {
+                    new_vertices++;
+                }
+            }
+            if (meshlet_vertices + new_vertices > max_vertices) {
+                continue;
+            }
+
+            assigned[triangle] = true;
+            meshlet_triangles++;
+            meshlet_vertices += new_vertices;
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                const std::uint32_t vertex = indices[triangle * 3 + corner];
+                vertex_meshlets[vertex] = meshlet_id;
+                result_indices.push_back(vertex);
+
+                for (std::uint32_t j = vertex_triangles.offsets[vertex]; j < vertex_triangles.offsets[vertex + 1]; j++) {
+                    if (!assigned[vertex_triangles.triangles[j]]) {
+                        candidates.push_back(vertex_triangles.triangles[j]);
+                    }
+                }
+            }
+        }
+
+        Meshlet meshlet = compute_bounds(positions, std::span(result_indices).subspan(first_index));
+        meshlet.first_index = static_cast<std::uint32_t>(first_index);
+        meshlet.indices_count = static_cast<std::uint32_t>(result_indices.size() - first_index);
+        result.push_back(meshlet);
+    }
+
+    // Keep the incomplete triangle at the end, if there is one.
+    result_indices.insert(result_indices.end(), indices.begin() + triangles_count * 3, indices.end());
+    indices = std::move(result_indices);
+    return result;
+}
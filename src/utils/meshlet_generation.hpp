@@ -0,0 +1,25 @@
+#pragma once
+
+#include "rendering/Meshlet.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace llengine::meshlet_generation {
+constexpr std::size_t DEFAULT_MAX_TRIANGLES = 124;
+constexpr std::size_t DEFAULT_MAX_VERTICES = 64;
+
+/**
+ * @brief Greedily grows clusters of connected triangles and reorders the
+ * indices so that triangles of every cluster are adjacent.
+ *
+ * @param indices Triangle list, reordered in place.
+ */
+[[nodiscard]] std::vector<Meshlet> build_meshlets(
+    std::span<const glm::vec3> positions, std::vector<std::uint32_t>& indices,
+    std::size_t max_triangles = DEFAULT_MAX_TRIANGLES, std::size_t max_vertices = DEFAULT_MAX_VERTICES
+);
+}
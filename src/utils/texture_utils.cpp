@@ -1,9 +1,12 @@
 #include "texture_utils.hpp"
+#include "brdf_integration_lut.hpp"
 #include "rendering/Mesh.hpp"
 #include "rendering/Shader.hpp"
 #include "rendering/LazyShader.hpp"
 #include "rendering/ManagedFramebufferID.hpp"
 #include "rendering/RenderingServer.hpp"
+#include "rendering/GLStateTracker.hpp"
+#include "rendering/TextureUploader.hpp"
 
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/mat4x4.hpp>
@@ -25,9 +28,9 @@ auto draw_to_cubemap(
 
     // Allocate the cube map.
     GLuint cubemap_id;
-    glActiveTexture(GL_TEXTURE1); // GL_TEXTURE0 will be used for the shader.
     glGenTextures(1, &cubemap_id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_id);
+    // Texture unit 0 will be used for the shader.
+    rs()._get_gl_state().bind_texture(1, GL_TEXTURE_CUBE_MAP, cubemap_id);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -98,18 +101,16 @@ static LazyShader<Shader<"mvp">> equirectangular_mapper_shader {EQUIRECTANGULAR_
     const glm::u32vec2 cubemap_size {panorama.get_size().x / 2u};
     const auto& cube_mesh = Mesh::get_skybox_cube(); // Alias the cube.
 
+    // The panorama is sampled right away, so it must be uploaded completely.
+    rs()._get_texture_uploader().flush();
+
     equirectangular_mapper_shader->use_shader();
     return draw_to_cubemap(cubemap_size, 1, [&] (const glm::mat4& mvp, std::int32_t level) {
         equirectangular_mapper_shader->set_mat4<"mvp">(mvp);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, panorama.get_id());
+        rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, panorama.get_id());
 
         cube_mesh->bind_vao(false, false, false);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_mesh->get_indices_id());
-        glDrawElements(GL_TRIANGLES, cube_mesh->get_amount_of_vertices(), cube_mesh->get_indices_type(), nullptr);
-
-        cube_mesh->unbind_vao(false, false, false);
+        cube_mesh->draw();
     });
 }
 
@@ -121,8 +122,6 @@ constexpr std::string_view IRRADIANCE_PRECOMPUTER_FRAGMENT_SHADER_TEXT =
 ;
 static LazyShader<Shader<"mvp">> irradiance_precomputer_shader {IRRADIANCE_PRECOMPUTER_VERTEX_SHADER_TEXT, IRRADIANCE_PRECOMPUTER_FRAGMENT_SHADER_TEXT};
 
-constexpr glm::u32vec2 IRRADIANCE_MAP_SIZE {16u, 16u};
-
 [[nodiscard]] Texture compute_irradiance_map(const Texture& cubemap) {
     if (cubemap.get_type() != Texture::Type::TEX_CUBEMAP) {
         throw std::runtime_error("Unable to compute irradiance map because the given environment map is not cubemap.");
@@ -133,15 +132,10 @@ constexpr glm::u32vec2 IRRADIANCE_MAP_SIZE {16u, 16u};
     irradiance_precomputer_shader->use_shader();
     return draw_to_cubemap(IRRADIANCE_MAP_SIZE, 1, [&] (const glm::mat4& mvp, std::int32_t level) {
         irradiance_precomputer_shader->set_mat4<"mvp">(mvp);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap.get_id());
+        rs()._get_gl_state().bind_texture(0, GL_TEXTURE_CUBE_MAP, cubemap.get_id());
 
         cube_mesh->bind_vao(false, false, false);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_mesh->get_indices_id());
-        glDrawElements(GL_TRIANGLES, cube_mesh->get_amount_of_vertices(), cube_mesh->get_indices_type(), nullptr);
-
-        cube_mesh->unbind_vao(false, false, false);
+        cube_mesh->draw();
     });
 }
 
@@ -153,9 +147,6 @@ constexpr std::string_view SPECULAR_PREFILTER_FRAGMENT_SHADER_TEXT =
 ;
 static LazyShader<Shader<"mvp", "roughness">> specular_prefilter_shader {SPECULAR_PREFILTER_VERTEX_SHADER_TEXT, SPECULAR_PREFILTER_FRAGMENT_SHADER_TEXT};
 
-constexpr glm::u32vec2 SPECULAR_MAP_SIZE {256u, 256u};
-constexpr std::int32_t SPECULAR_MAP_MIPMAP_LEVELS = 9; // log2(256) + 1. Also change LAST_PREFILTERED_MIPMAP_LEVEL in pbr_shader.frag.
-
 [[nodiscard]] Texture compute_prefiltered_specular_map(const Texture& cubemap) {
     if (cubemap.get_type() != Texture::Type::TEX_CUBEMAP) {
         throw std::runtime_error("Unable to compute specular map because the given environment map is not cubemap.");
@@ -168,78 +159,77 @@ constexpr std::int32_t SPECULAR_MAP_MIPMAP_LEVELS = 9; // log2(256) + 1. Also ch
         float roughness = static_cast<float>(level) / (SPECULAR_MAP_MIPMAP_LEVELS - 1);
         specular_prefilter_shader->set_mat4<"mvp">(mvp);
         specular_prefilter_shader->set_float<"roughness">(roughness);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap.get_id());
+        rs()._get_gl_state().bind_texture(0, GL_TEXTURE_CUBE_MAP, cubemap.get_id());
 
         cube_mesh->bind_vao(false, false, false);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_mesh->get_indices_id());
-        glDrawElements(GL_TRIANGLES, cube_mesh->get_amount_of_vertices(), cube_mesh->get_indices_type(), nullptr);
-
-        cube_mesh->unbind_vao(false, false, false);
+        cube_mesh->draw();
     });
 }
 
-constexpr std::string_view BRDF_INTEGRATION_MAPPER_VERTEX_SHADER_TEXT =
-    #include "shaders/objects/pbr/brdf_integration_mapper.vert"
-;
-constexpr std::string_view BRDF_INTEGRATION_MAPPER_FRAGMENT_SHADER_TEXT =
-    #include "shaders/objects/pbr/brdf_integration_mapper.frag"
-;
-static LazyShader<Shader<>> brdf_integration_mapper_shader {BRDF_INTEGRATION_MAPPER_VERTEX_SHADER_TEXT, BRDF_INTEGRATION_MAPPER_FRAGMENT_SHADER_TEXT};
-
-constexpr glm::u32vec2 BRDF_INTEGRATION_MAP_SIZE = SPECULAR_MAP_SIZE;
-
-[[nodiscard]] Texture compute_brdf_integration_map() {
-    const auto& quad_mesh = Mesh::get_quad(); // Alias the cube.
-
-    // Create and allocate the texture.
+[[nodiscard]] Texture load_brdf_integration_map() {
     GLuint texture_id {};
     glGenTextures(1, &texture_id);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_2D, texture_id);
     glTexImage2D(
-        GL_TEXTURE_2D, 0, GL_RG16F, BRDF_INTEGRATION_MAP_SIZE.x, BRDF_INTEGRATION_MAP_SIZE.y,
-        0, GL_RG, GL_FLOAT, nullptr
+        GL_TEXTURE_2D, 0, GL_RG16F, BRDF_INTEGRATION_LUT_SIZE, BRDF_INTEGRATION_LUT_SIZE,
+        0, GL_RG, GL_HALF_FLOAT, BRDF_INTEGRATION_LUT.data()
     );
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    // Initialize the framebuffer.
-    ManagedFramebufferID framebuffer_id;
-    glGenFramebuffers(1, &framebuffer_id.get_ref());
-    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_id);
-
-    // Save the state of the viewport to restore it later.
-    std::array<GLint, 4> original_viewport_params;
-    glGetIntegerv(GL_VIEWPORT, original_viewport_params.data());
-    // Change the viewport.
-    glViewport(0, 0, BRDF_INTEGRATION_MAP_SIZE.x, BRDF_INTEGRATION_MAP_SIZE.y);
-
-    // Draw!
-    glFramebufferTexture2D(
-        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-        texture_id, 0
+    return Texture::from_texture_id(
+        texture_id, glm::u32vec2(BRDF_INTEGRATION_LUT_SIZE), Texture::Type::TEX_2D
     );
+}
 
-    brdf_integration_mapper_shader->use_shader();
+// Averages 2x2 blocks of RGB pixels. Odd sizes drop the last row and column.
+[[nodiscard]] static std::vector<float> halve_face(const std::vector<float>& face, std::uint32_t face_size) {
+    const std::uint32_t half_size = face_size / 2;
+    std::vector<float> result(static_cast<std::size_t>(half_size) * half_size * 3);
+    for (std::uint32_t y = 0; y < half_size; y++) {
+        for (std::uint32_t x = 0; x < half_size; x++) {
+            for (std::size_t channel = 0; channel < 3; channel++) {
+                const auto source = [&](std::uint32_t source_x, std::uint32_t source_y) {
+                    return face[(static_cast<std::size_t>(source_y) * face_size + source_x) * 3 + channel];
+                };
+                result[(static_cast<std::size_t>(y) * half_size + x) * 3 + channel] = 0.25f * (
+                    source(2 * x, 2 * y) + source(2 * x + 1, 2 * y) +
+                    source(2 * x, 2 * y + 1) + source(2 * x + 1, 2 * y + 1)
+                );
+            }
+        }
+    }
+    return result;
+}
 
-    glClear(GL_COLOR_BUFFER_BIT);
-    quad_mesh->bind_vao(true, false, false);
-    glDrawArrays(GL_TRIANGLES, 0, quad_mesh->get_amount_of_vertices());
-    quad_mesh->unbind_vao(true, false, false);
+[[nodiscard]] CubemapPixels read_cubemap_pixels(const Texture& cubemap, std::uint32_t max_face_size) {
+    if (cubemap.get_type() != Texture::Type::TEX_CUBEMAP) {
+        throw std::runtime_error("Unable to read cubemap pixels because the given texture is not cubemap.");
+    }
 
-    // Clean up.
-    glBindFramebuffer(GL_FRAMEBUFFER, rs()._get_main_framebuffer_id());
+    CubemapPixels result;
+    result.face_size = cubemap.get_size().x;
+
+    // Also makes unit 0 active, the calls below reach the texture through it.
+    rs()._get_gl_state().bind_texture(0, GL_TEXTURE_CUBE_MAP, cubemap.get_id());
+    for (std::size_t i = 0; i < 6; i++) {
+        result.faces[i].resize(static_cast<std::size_t>(result.face_size) * result.face_size * 3);
+        glGetTexImage(
+            GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GraphicsAPIEnum>(i), 0,
+            GL_RGB, GL_FLOAT, result.faces[i].data()
+        );
+    }
 
-    // Return viewport to the original state.
-    glViewport(
-        original_viewport_params[0], original_viewport_params[1],
-        original_viewport_params[2], original_viewport_params[3]
-    );
+    // The cubemap may be shared, so it's downsampled here instead of generating its mipmaps.
+    while (result.face_size > max_face_size && result.face_size > 1) {
+        for (std::vector<float>& face : result.faces) {
+            face = halve_face(face, result.face_size);
+        }
+        result.face_size /= 2;
+    }
 
-    return Texture::from_texture_id(texture_id, BRDF_INTEGRATION_MAP_SIZE, Texture::Type::TEX_2D);
+    return result;
 }
 }
@@ -2,9 +2,33 @@
 
 #include "rendering/Texture.hpp"
 
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <vector>
+
 namespace llengine::tex_utils {
+constexpr glm::u32vec2 IRRADIANCE_MAP_SIZE {16u, 16u};
+constexpr glm::u32vec2 SPECULAR_MAP_SIZE {256u, 256u};
+constexpr std::int32_t SPECULAR_MAP_MIPMAP_LEVELS = 9; // log2(256) + 1. Also change LAST_PREFILTERED_MIPMAP_LEVEL in pbr_shader.frag.
+
 [[nodiscard]] Texture panorama_to_cubemap(const Texture& panorama);
 [[nodiscard]] Texture compute_irradiance_map(const Texture& cubemap);
 [[nodiscard]] Texture compute_prefiltered_specular_map(const Texture& cubemap);
-[[nodiscard]] Texture compute_brdf_integration_map();
+/**
+ * @brief Uploads the BRDF integration map that was precomputed at build time.
+ */
+[[nodiscard]] Texture load_brdf_integration_map();
+
+struct CubemapPixels {
+    std::array<std::vector<float>, 6> faces; // RGB pixels, in the order of cubemap targets.
+    std::uint32_t face_size;
+};
+/**
+ * @brief Reads RGB pixels of all faces of the cubemap back from the GPU.
+ *
+ * If the cubemap is bigger than max_face_size, the base level is read and
+ * halved until it fits. The cubemap itself is left unchanged.
+ */
+[[nodiscard]] CubemapPixels read_cubemap_pixels(const Texture& cubemap, std::uint32_t max_face_size);
 }
\ No newline at end of file
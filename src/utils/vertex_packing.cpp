@@ -0,0 +1,134 @@
+#include "vertex_packing.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace llengine;
+
+[[nodiscard]] static float sign_not_zero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+[[nodiscard]] static std::uint32_t float_to_snorm(float value, float max_value, std::uint32_t mask) {
+    // Zero vectors produce NaNs, store them as zeros.
+    const float clamped = value > 1.0f ? 1.0f : (value >= -1.0f ? value : (value < -1.0f ? -1.0f : 0.0f));
+    // Round half away from zero, std::round and std::nearbyint are library calls that prevent vectorization.
+    const float scaled = clamped * max_value + (clamped >= 0.0f ? 0.5f : -0.5f);
+    return static_cast<std::uint32_t>(static_cast<std::int32_t>(scaled)) & mask;
+}
+
+// Round to nearest even, based on the "float_to_half_fast3_rtne" by Fabian Giesen.
+[[nodiscard]] static std::uint32_t float_to_half(float value) {
+    std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    // Infinity or NaN.
+    const std::uint32_t special = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+
+    // Subnormal or zero. Let the FPU align the mantissa.
+    constexpr std::uint32_t DENORMAL_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+    const std::uint32_t denormal = std::bit_cast<std::uint32_t>(
+        std::bit_cast<float>(bits) + std::bit_cast<float>(DENORMAL_MAGIC)
+    ) - DENORMAL_MAGIC;
+
+    // Normal. Rebias the exponent and round the mantissa.
+    const std::uint32_t mantissa_odd = (bits >> 13) & 1u;
+    const std::uint32_t normal = (bits + (static_cast<std::uint32_t>(15 - 127) << 23) + 0xFFFu + mantissa_odd) >> 13;
+
+    const std::uint32_t result = bits >= 0x47800000u ? special : (bits < 0x38800000u ? denormal : normal);
+    return (sign >> 16) | result;
+}
+
+[[nodiscard]] static float half_to_float(std::uint32_t half) {
+    const std::uint32_t sign = (half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1Fu;
+    const std::uint32_t mantissa = half & 0x3FFu;
+
+    float magnitude;
+    if (exponent == 0) {
+        magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+    }
+    else if (exponent == 0x1F) {
+        magnitude = mantissa == 0 ? INFINITY : NAN;
+    }
+    else {
+        magnitude = std::bit_cast<float>(((exponent + 127 - 15) << 23) | (mantissa << 13));
+    }
+
+    return std::bit_cast<float>(std::bit_cast<std::uint32_t>(magnitude) | sign);
+}
+
+[[nodiscard]] static float sign_extend_to_float(std::uint32_t value, std::uint32_t bits) {
+    const std::int32_t shift = 32 - static_cast<std::int32_t>(bits);
+    return static_cast<float>(static_cast<std::int32_t>(value << shift) >> shift);
+}
+
+void vertex_packing::pack_normals(std::span<const glm::vec3> normals, std::span<std::uint32_t> result) {
+    assert(normals.size() == result.size());
+
+    for (std::size_t i = 0; i < normals.size(); i++) {
+        const float normal_x = normals[i].x;
+        const float normal_y = normals[i].y;
+        const float normal_z = normals[i].z;
+        const float inverse_l1_norm = 1.0f / (std::abs(normal_x) + std::abs(normal_y) + std::abs(normal_z));
+        const float x = normal_x * inverse_l1_norm;
+        const float y = normal_y * inverse_l1_norm;
+
+        // Fold the lower hemisphere over the diagonals.
+        const bool lower = normal_z < 0.0f;
+        const float folded_x = (1.0f - std::abs(y)) * sign_not_zero(x);
+        const float folded_y = (1.0f - std::abs(x)) * sign_not_zero(y);
+
+        result[i] = float_to_snorm(lower ? folded_x : x, 32767.0f, 0xFFFFu) |
+            (float_to_snorm(lower ? folded_y : y, 32767.0f, 0xFFFFu) << 16);
+    }
+}
+
+void vertex_packing::pack_tangents(std::span<const glm::vec4> tangents, std::span<std::uint32_t> result) {
+    assert(tangents.size() == result.size());
+
+    for (std::size_t i = 0; i < tangents.size(); i++) {
+        result[i] = float_to_snorm(tangents[i].x, 511.0f, 0x3FFu) |
+            (float_to_snorm(tangents[i].y, 511.0f, 0x3FFu) << 10) |
+            (float_to_snorm(tangents[i].z, 511.0f, 0x3FFu) << 20) |
+            (float_to_snorm(sign_not_zero(tangents[i].w), 1.0f, 0x3u) << 30);
+    }
+}
+
+void vertex_packing::pack_uvs(std::span<const glm::vec2> uvs, std::span<std::uint32_t> result) {
+    assert(uvs.size() == result.size());
+
+    for (std::size_t i = 0; i < uvs.size(); i++) {
+        result[i] = float_to_half(uvs[i].x) | (float_to_half(uvs[i].y) << 16);
+    }
+}
+
+[[nodiscard]] glm::vec3 vertex_packing::unpack_normal(std::uint32_t packed) {
+    const float x = std::max(sign_extend_to_float(packed & 0xFFFFu, 16) / 32767.0f, -1.0f);
+    const float y = std::max(sign_extend_to_float(packed >> 16, 16) / 32767.0f, -1.0f);
+
+    glm::vec3 normal {x, y, 1.0f - std::abs(x) - std::abs(y)};
+    if (normal.z < 0.0f) {
+        normal.x = (1.0f - std::abs(y)) * sign_not_zero(x);
+        normal.y = (1.0f - std::abs(x)) * sign_not_zero(y);
+    }
+
+    const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+    return normal / length;
+}
+
+[[nodiscard]] glm::vec4 vertex_packing::unpack_tangent(std::uint32_t packed) {
+    return {
+        std::max(sign_extend_to_float(packed & 0x3FFu, 10) / 511.0f, -1.0f),
+        std::max(sign_extend_to_float((packed >> 10) & 0x3FFu, 10) / 511.0f, -1.0f),
+        std::max(sign_extend_to_float((packed >> 20) & 0x3FFu, 10) / 511.0f, -1.0f),
+        sign_extend_to_float(packed >> 30, 2)
+    };
+}
+
+[[nodiscard]] glm::vec2 vertex_packing::unpack_uv(std::uint32_t packed) {
+    return {half_to_float(packed & 0xFFFFu), half_to_float(packed >> 16)};
+}
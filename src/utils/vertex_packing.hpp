@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <span>
+#include <cstdint>
+
+/**
+ * Compact vertex attribute formats. Every packed attribute takes 4 bytes:
+ * - normals are octahedral-encoded into two 16-bit snorms;
+ * - tangents are in GL_INT_2_10_10_10_REV with the handedness in the 2-bit W;
+ * - UVs are two half floats.
+ *
+ * The encoders take and produce contiguous arrays and avoid branches,
+ * so compilers vectorize them.
+ */
+namespace llengine::vertex_packing {
+void pack_normals(std::span<const glm::vec3> normals, std::span<std::uint32_t> result);
+void pack_tangents(std::span<const glm::vec4> tangents, std::span<std::uint32_t> result);
+void pack_uvs(std::span<const glm::vec2> uvs, std::span<std::uint32_t> result);
+
+[[nodiscard]] glm::vec3 unpack_normal(std::uint32_t packed);
+[[nodiscard]] glm::vec4 unpack_tangent(std::uint32_t packed);
+[[nodiscard]] glm::vec2 unpack_uv(std::uint32_t packed);
+}
@@ -0,0 +1,197 @@
+// Generates C++ source file with the BRDF integration lookup table.
+// Usage: generate_brdf_integration_lut <output file>
+
+#include "utils/brdf_integration_lut.hpp"
+
+#include <cmath>
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+using llengine::tex_utils::BRDF_INTEGRATION_LUT_SIZE;
+
+constexpr float PI = 3.1415926f;
+constexpr std::uint32_t AMOUNT_OF_SAMPLES = 128;
+
+struct Vec3 {
+    float x, y, z;
+};
+
+static float dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static Vec3 normalize(const Vec3& vec) {
+    const float length = std::sqrt(dot(vec, vec));
+    return {vec.x / length, vec.y / length, vec.z / length};
+}
+
+// Efficient Van Der Corput sequence implementation taken from
+// https://learnopengl.com/PBR/IBL/Specular-IBL.
+static float van_der_corput_sequence(std::uint32_t index) {
+    index = (index << 16u) | (index >> 16u);
+    index = ((index & 0x55555555u) << 1u) | ((index & 0xAAAAAAAAu) >> 1u);
+    index = ((index & 0x33333333u) << 2u) | ((index & 0xCCCCCCCCu) >> 2u);
+    index = ((index & 0x0F0F0F0Fu) << 4u) | ((index & 0xF0F0F0F0u) >> 4u);
+    index = ((index & 0x00FF00FFu) << 8u) | ((index & 0xFF00FF00u) >> 8u);
+    return static_cast<float>(index) * 2.3283064365386963e-10f; // 0x100000000
+}
+
+// Cosine of the GGX distribution function is easier to compute than
+// just GGX distribution function. So, implement this as such.
+static float cosine_of_ggx_inverse(float random_uniform, float roughness) {
+    const float alpha = roughness * roughness;
+
+    const float numerator = 1.0f - random_uniform;
+    const float denominator = random_uniform * (alpha * alpha - 1.0f) + 1.0f;
+    return std::sqrt(numerator / denominator);
+}
+
+static Vec3 compute_light_vector(const Vec3& view, const Vec3& halfway) {
+    const float double_v_dot_h = 2.0f * dot(view, halfway);
+    return normalize({
+        double_v_dot_h * halfway.x - view.x,
+        double_v_dot_h * halfway.y - view.y,
+        double_v_dot_h * halfway.z - view.z
+    });
+}
+
+// Returns halfway vector in tangent space.
+static Vec3 get_halfway_sample_vector(std::uint32_t index, float roughness) {
+    const float hor_angle = 2.0f * PI * static_cast<float>(index) / static_cast<float>(AMOUNT_OF_SAMPLES);
+    const float cos_vert_angle = cosine_of_ggx_inverse(van_der_corput_sequence(index), roughness);
+    const float sin_vert_angle = std::sqrt(1.0f - cos_vert_angle * cos_vert_angle);
+
+    return {
+        std::cos(hor_angle) * sin_vert_angle,
+        std::sin(hor_angle) * sin_vert_angle,
+        cos_vert_angle
+    };
+}
+
+static float geometric_shadowing_schlick_ggx(float n_dot_v, float roughness) {
+    const float k = (roughness * roughness) / 2.0f;
+    const float denominator = n_dot_v * (1.0f - k) + k;
+
+    return n_dot_v / denominator;
+}
+
+static float geometric_shadowing_smith(float n_dot_v, float n_dot_l, float roughness) {
+    return geometric_shadowing_schlick_ggx(n_dot_l, roughness) * geometric_shadowing_schlick_ggx(n_dot_v, roughness);
+}
+
+// This function is reformatted version of IntegrateBRDF function from
+// https://blog.selfshadow.com/publications/s2013-shading-course/karis/s2013_pbs_epic_notes_v2.pdf
+static std::array<float, 2> integrate_brdf(float roughness, float n_dot_v) {
+    std::array<float, 2> coeff_and_bias {0.0f, 0.0f};
+
+    const Vec3 view {
+        std::sqrt(1.0f - n_dot_v * n_dot_v), // Sine.
+        0.0f,
+        n_dot_v // Cosine.
+    };
+
+    for (std::uint32_t i = 0; i < AMOUNT_OF_SAMPLES; i++) {
+        const Vec3 halfway = get_halfway_sample_vector(i, roughness);
+        const Vec3 light = compute_light_vector(view, halfway);
+
+        const float n_dot_l = std::clamp(light.z, 0.0f, 1.0f);
+        if (n_dot_l > 0.0f) {
+            const float n_dot_h = std::clamp(halfway.z, 0.0f, 1.0f);
+            const float v_dot_h = std::clamp(dot(view, halfway), 0.0f, 1.0f);
+
+            // BRDF * n_dot_l / PDF, where PDF = normal_distribution * n_dot_h / (4 * v_dot_h).
+            const float gsf = geometric_shadowing_smith(n_dot_v, n_dot_l, roughness);
+            const float brdf_mul_n_dot_l_div_pdf = gsf * v_dot_h / (n_dot_h * n_dot_v);
+
+            const float fresnel_part = std::pow(1.0f - v_dot_h, 5.0f);
+            coeff_and_bias[0] += (1.0f - fresnel_part) * brdf_mul_n_dot_l_div_pdf;
+            coeff_and_bias[1] += fresnel_part * brdf_mul_n_dot_l_div_pdf;
+        }
+    }
+
+    coeff_and_bias[0] /= static_cast<float>(AMOUNT_OF_SAMPLES);
+    coeff_and_bias[1] /= static_cast<float>(AMOUNT_OF_SAMPLES);
+    return coeff_and_bias;
+}
+
+// Converts non-negative finite float to half float, rounding to nearest even.
+static std::uint16_t float_to_half(float value) {
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = (bits >> 16) & 0x8000u;
+    const std::int32_t exponent = static_cast<std::int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    std::uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent >= 31) {
+        // Too big, clamp to the largest finite half.
+        return static_cast<std::uint16_t>(sign | 0x7BFFu);
+    }
+    if (exponent <= 0) {
+        // Subnormal half or zero.
+        if (exponent < -10) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        const std::uint32_t shift = static_cast<std::uint32_t>(14 - exponent);
+        std::uint32_t result = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const std::uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (result & 1u))) {
+            result++;
+        }
+        return static_cast<std::uint16_t>(sign | result);
+    }
+
+    std::uint32_t result = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const std::uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1u))) {
+        // May overflow into the exponent, which is the correct rounding.
+        result++;
+    }
+    return static_cast<std::uint16_t>(sign | result);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <output file>\n";
+        return 1;
+    }
+
+    const std::filesystem::path output_path {argv[1]};
+    if (output_path.has_parent_path()) {
+        std::filesystem::create_directories(output_path.parent_path());
+    }
+
+    std::ofstream stream(output_path);
+    if (!stream) {
+        std::cerr << "Failed to open " << output_path << " for writing.\n";
+        return 1;
+    }
+
+    stream <<
+        "// Generated by tools/generate_brdf_integration_lut.cpp. Do not edit.\n"
+        "#include \"utils/brdf_integration_lut.hpp\"\n\n"
+        "namespace llengine::tex_utils {\n"
+        "const std::array<std::uint16_t, BRDF_INTEGRATION_LUT_SIZE * BRDF_INTEGRATION_LUT_SIZE * 2> BRDF_INTEGRATION_LUT {\n";
+
+    for (std::uint32_t row = 0; row < BRDF_INTEGRATION_LUT_SIZE; row++) {
+        // Texel centers, the same as the quad rasterization would give.
+        const float n_dot_v = (static_cast<float>(row) + 0.5f) / BRDF_INTEGRATION_LUT_SIZE;
+        for (std::uint32_t column = 0; column < BRDF_INTEGRATION_LUT_SIZE; column++) {
+            const float roughness = (static_cast<float>(column) + 0.5f) / BRDF_INTEGRATION_LUT_SIZE;
+            const auto [coeff, bias] = integrate_brdf(roughness, n_dot_v);
+            stream << float_to_half(coeff) << ',' << float_to_half(bias) << ',';
+        }
+        stream << '\n';
+    }
+
+    stream << "};\n}\n";
+
+    if (!stream) {
+        std::cerr << "Failed to write " << output_path << ".\n";
+        return 1;
+    }
+}
@@ -0,0 +1,83 @@
+#include "math/BoundingVolumes.hpp"
+#include "math/Frustum.hpp"
+
+#include <gtest/gtest.h>
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace llengine;
+
+namespace {
+// Points of a 4x1x0.5 box rotated by 45 degrees around Z.
+[[nodiscard]] std::vector<glm::vec3> make_rotated_box_points() {
+    const glm::vec3 x_axis = glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f));
+    const glm::vec3 y_axis = glm::normalize(glm::vec3(-1.0f, 1.0f, 0.0f));
+    const glm::vec3 z_axis {0.0f, 0.0f, 1.0f};
+
+    std::vector<glm::vec3> result;
+    for (int x = -10; x <= 10; x++) {
+        for (int y = -2; y <= 2; y++) {
+            for (int z = -1; z <= 1; z++) {
+                result.push_back(x_axis * (x * 0.2f) + y_axis * (y * 0.25f) + z_axis * (z * 0.25f));
+            }
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] AABB compute_aabb(const std::vector<glm::vec3>& points) {
+    AABB result {points[0], points[0]};
+    for (const glm::vec3& point : points) {
+        result.point_max = glm::max(result.point_max, point);
+        result.point_min = glm::min(result.point_min, point);
+    }
+    return result;
+}
+}
+
+TEST(BoundingVolumes, OBBFitsRotatedBox) {
+    const auto points = make_rotated_box_points();
+    const OBB obb = OBB::from_points(points, compute_aabb(points));
+
+    const float volume = 8.0f * glm::length(obb.half_axes[0]) * glm::length(obb.half_axes[1]) * glm::length(obb.half_axes[2]);
+    EXPECT_NEAR(volume, 4.0f * 1.0f * 0.5f, 1e-3f);
+    for (const glm::vec3& point : points) {
+        for (std::size_t i = 0; i < 3; i++) {
+            const glm::vec3 axis = glm::normalize(obb.half_axes[i]);
+            EXPECT_LE(std::abs(glm::dot(point - obb.center, axis)), glm::length(obb.half_axes[i]) + 1e-4f);
+        }
+    }
+}
+
+TEST(BoundingVolumes, SphereContainsPoints) {
+    const auto points = make_rotated_box_points();
+    const BoundingSphere sphere = BoundingSphere::from_points(points, compute_aabb(points));
+
+    EXPECT_LE(sphere.radius, std::sqrt(2.0f * 2.0f + 0.5f * 0.5f + 0.25f * 0.25f) + 1e-3f);
+    for (const glm::vec3& point : points) {
+        EXPECT_LE(glm::distance(point, sphere.center), sphere.radius + 1e-4f);
+    }
+}
+
+TEST(BoundingVolumes, FrustumClassification) {
+    // A box-shaped "frustum" from -1 to 1 on every axis.
+    Frustum frustum;
+    frustum.planes.left = {{1.0f, 0.0f, 0.0f}, -1.0f};
+    frustum.planes.right = {{-1.0f, 0.0f, 0.0f}, -1.0f};
+    frustum.planes.bottom = {{0.0f, 1.0f, 0.0f}, -1.0f};
+    frustum.planes.top = {{0.0f, -1.0f, 0.0f}, -1.0f};
+    frustum.planes.near = {{0.0f, 0.0f, 1.0f}, -1.0f};
+    frustum.planes.far = {{0.0f, 0.0f, -1.0f}, -1.0f};
+
+    EXPECT_EQ(frustum.classify_sphere({{0.0f, 0.0f, 0.0f}, 0.5f}), Frustum::Intersection::INSIDE);
+    EXPECT_EQ(frustum.classify_sphere({{1.0f, 0.0f, 0.0f}, 0.5f}), Frustum::Intersection::INTERSECTS);
+    EXPECT_EQ(frustum.classify_sphere({{3.0f, 0.0f, 0.0f}, 0.5f}), Frustum::Intersection::OUTSIDE);
+
+    // Thin diagonal box near the corner: its sphere touches the frustum, the box doesn't.
+    const glm::vec3 diagonal = glm::normalize(glm::vec3(1.0f, -1.0f, 0.0f));
+    const OBB obb {{1.8f, 1.8f, 0.0f}, glm::mat3(diagonal * 1.0f, glm::vec3(0.0f, 0.0f, 0.05f), glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f)) * 0.05f)};
+    EXPECT_NE(frustum.classify_sphere({obb.center, 1.0f}), Frustum::Intersection::OUTSIDE);
+    EXPECT_FALSE(frustum.is_obb_on_frustum(obb));
+}
@@ -0,0 +1,124 @@
+#include "rendering/DrawRecorder.hpp"
+#include "utils/WorkerPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+using namespace llengine;
+
+TEST(WorkerPool, RunsEveryTaskOnce) {
+    WorkerPool pool {3};
+    ASSERT_EQ(pool.get_threads_count(), 4u);
+
+    for (std::size_t tasks_count : {0u, 1u, 2u, 100u}) {
+        std::vector<std::atomic<int>> calls(tasks_count);
+        pool.run(tasks_count, [&] (std::size_t task) {
+            calls[task]++;
+        });
+
+        for (const auto& call_count : calls) {
+            EXPECT_EQ(call_count, 1);
+        }
+    }
+
+    EXPECT_THROW(pool.run(10, [] (std::size_t task) {
+        if (task == 5) {
+            throw std::runtime_error("Task failed.");
+        }
+    }), std::runtime_error);
+
+    // The pool stays usable after an exception.
+    std::atomic<std::size_t> sum = 0;
+    pool.run(10, [&] (std::size_t task) {
+        sum += task;
+    });
+    EXPECT_EQ(sum, 45u);
+}
+
+TEST(WorkerPool, ReportsRunningJob) {
+    WorkerPool pool {3};
+    EXPECT_FALSE(WorkerPool::is_running_job());
+
+    for (std::size_t tasks_count : {1u, 100u}) {
+        std::atomic<bool> all_running = true;
+        pool.run(tasks_count, [&] (std::size_t) {
+            if (!WorkerPool::is_running_job()) {
+                all_running = false;
+            }
+        });
+        EXPECT_TRUE(all_running);
+        EXPECT_FALSE(WorkerPool::is_running_job());
+    }
+}
+
+namespace {
+class TestDrawable : public Drawable {
+public:
+    TestDrawable(std::uint32_t id, bool concurrent) : id(id), concurrent(concurrent) {}
+
+    void draw() override {}
+    [[nodiscard]] bool is_enabled() const override {
+        return id % 7 != 0;
+    }
+    ShaderID get_program_id() const override {
+        return 1;
+    }
+    [[nodiscard]] RenderKeyParts get_render_key_parts(const glm::vec3&) const override {
+        return {1, nullptr, 0, nullptr, static_cast<float>(id)};
+    }
+    [[nodiscard]] bool is_outside_the_frustum(const Frustum&) const override {
+        return id % 3 == 0;
+    }
+    [[nodiscard]] DrawPreparation prepare_concurrently(
+        const Frustum& frustum, const glm::vec3& camera_position, RenderKeyParts& parts
+    ) const override {
+        if (!concurrent) {
+            return DrawPreparation::DEFERRED;
+        }
+        if (is_outside_the_frustum(frustum)) {
+            return DrawPreparation::CULLED;
+        }
+
+        parts = get_render_key_parts(camera_position);
+        return DrawPreparation::PREPARED;
+    }
+
+    const std::uint32_t id;
+
+private:
+    const bool concurrent;
+};
+}
+
+TEST(DrawRecorder, ParallelRecordingKeepsOrder) {
+    std::vector<std::unique_ptr<TestDrawable>> storage;
+    std::vector<Drawable*> drawables;
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t id = 0; id < 3000; id++) {
+        // Runs of deferred drawables between concurrent ones.
+        storage.push_back(std::make_unique<TestDrawable>(id, id % 50 >= 10));
+        drawables.push_back(storage.back().get());
+        if (id % 7 != 0 && id % 3 != 0) {
+            expected.push_back(id);
+        }
+    }
+
+    WorkerPool pool {3};
+    for (WorkerPool* used_pool : {static_cast<WorkerPool*>(nullptr), &pool}) {
+        DrawRecorder recorder;
+        recorder.record(drawables, Frustum(), glm::vec3(), used_pool);
+        EXPECT_EQ(recorder.get_tasks_count(), used_pool == nullptr ? 1u : 4u);
+
+        std::vector<std::uint32_t> replayed;
+        recorder.replay([&] (Drawable& drawable, const RenderKeyParts& parts) {
+            const auto id = dynamic_cast<TestDrawable&>(drawable).id;
+            EXPECT_EQ(parts.depth, static_cast<float>(id));
+            replayed.push_back(id);
+        });
+        EXPECT_EQ(replayed, expected);
+    }
+}
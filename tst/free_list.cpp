@@ -0,0 +1,42 @@
+#include "rendering/MeshBufferArena.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace llengine;
+
+TEST(FreeList, AllocationsDoNotOverlap) {
+    FreeList list(100);
+
+    EXPECT_EQ(list.allocate(30), 0);
+    EXPECT_EQ(list.allocate(30), 30);
+    EXPECT_EQ(list.allocate(30), 60);
+    EXPECT_EQ(list.allocate(30), std::nullopt);
+    EXPECT_EQ(list.get_free_size(), 10);
+}
+
+TEST(FreeList, Alignment) {
+    FreeList list(64);
+
+    EXPECT_EQ(list.allocate(6, 4), 0);
+    EXPECT_EQ(list.allocate(4, 4), 8);
+    // The gap [6, 8) remains free.
+    EXPECT_EQ(list.allocate(2), 6);
+    EXPECT_EQ(list.get_free_size(), 52);
+}
+
+TEST(FreeList, FreedRangesCoalesce) {
+    FreeList list(90);
+
+    const auto first = list.allocate(30);
+    const auto second = list.allocate(30);
+    const auto third = list.allocate(30);
+
+    list.free(*first, 30);
+    list.free(*third, 30);
+    // Two separate free ranges aren't enough for 60 units.
+    EXPECT_EQ(list.allocate(60), std::nullopt);
+
+    list.free(*second, 30);
+    EXPECT_EQ(list.allocate(90), 0);
+    EXPECT_EQ(list.get_free_size(), 0);
+}
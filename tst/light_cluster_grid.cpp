@@ -0,0 +1,49 @@
+#include "rendering/LightClusterGrid.hpp"
+
+#include <gtest/gtest.h>
+#include <glm/trigonometric.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+
+#include <vector>
+#include <algorithm>
+
+using namespace llengine;
+
+TEST(LightClusterGrid, Build) {
+    const glm::mat4 view_matrix {1.0f};
+    const glm::mat4 proj_matrix = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const std::vector<LightClusterGrid::Light> lights {
+        // In the center of the screen, 10 units ahead.
+        {{0.0f, 0.0f, -10.0f}, 1.0f},
+        // Behind the camera.
+        {{0.0f, 0.0f, 10.0f}, 1.0f},
+        // Crossing the near plane, so it is in every tile of the first slices.
+        {{0.0f, 0.0f, -0.5f}, 1.0f}
+    };
+
+    LightClusterGrid grid;
+    grid.build(view_matrix, proj_matrix, 0.1f, 100.0f, lights);
+
+    const auto contains = [&] (std::uint32_t x, std::uint32_t y, std::uint32_t z, std::uint32_t light) {
+        const std::span<const std::uint32_t> cluster_lights = grid.get_cluster_lights(x, y, z);
+        return std::find(cluster_lights.begin(), cluster_lights.end(), light) != cluster_lights.end();
+    };
+
+    // Depth 10 is in the slice 24 * log(10 / 0.1) / log(100 / 0.1) = 16.
+    EXPECT_TRUE(contains(8, 4, 16, 0));
+    EXPECT_FALSE(contains(0, 0, 16, 0));
+    EXPECT_FALSE(contains(8, 4, 0, 0));
+    EXPECT_FALSE(contains(8, 4, 20, 0));
+
+    EXPECT_TRUE(contains(0, 0, 0, 2));
+    EXPECT_TRUE(contains(LightClusterGrid::SIZE_X - 1, LightClusterGrid::SIZE_Y - 1, 0, 2));
+    EXPECT_FALSE(contains(0, 0, 16, 2));
+
+    for (std::uint32_t z = 0; z < LightClusterGrid::SIZE_Z; z++) {
+        for (std::uint32_t y = 0; y < LightClusterGrid::SIZE_Y; y++) {
+            for (std::uint32_t x = 0; x < LightClusterGrid::SIZE_X; x++) {
+                EXPECT_FALSE(contains(x, y, z, 1));
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "utils/mesh_indexing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace llengine;
+
+namespace {
+struct TestMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec4> tangents;
+
+    [[nodiscard]] mesh_indexing::VertexStreams get_streams() const {
+        return {positions, uvs, normals, tangents};
+    }
+};
+
+[[nodiscard]] TestMesh make_grid_mesh(std::size_t side) {
+    TestMesh mesh;
+    // Two triangles per cell, so inner vertices repeat up to 6 times.
+    for (std::size_t y = 0; y < side; y++) {
+        for (std::size_t x = 0; x < side; x++) {
+            for (const auto& [dx, dy] : {std::pair{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}}) {
+                const float vx = static_cast<float>(x + dx);
+                const float vy = static_cast<float>(y + dy);
+                mesh.positions.emplace_back(vx, vy, 0.0f);
+                mesh.uvs.emplace_back(vx / side, vy / side);
+                mesh.normals.emplace_back(0.0f, 0.0f, 1.0f);
+                mesh.tangents.emplace_back(1.0f, 0.0f, 0.0f, (x + y) % 2 == 0 ? 1.0f : -1.0f);
+            }
+        }
+    }
+    return mesh;
+}
+}
+
+TEST(MeshIndexing, HashTableMergesDuplicates) {
+    const TestMesh mesh = make_grid_mesh(8);
+    const auto result = mesh_indexing::index_with_hash_table(mesh.get_streams(), false);
+
+    ASSERT_EQ(result.indices.size(), mesh.positions.size());
+    ASSERT_EQ(result.unique_vertices.size(), 9u * 9u);
+    for (std::size_t i = 0; i < result.indices.size(); i++) {
+        EXPECT_EQ(mesh.positions[result.unique_vertices[result.indices[i]]], mesh.positions[i]);
+        EXPECT_EQ(mesh.uvs[result.unique_vertices[result.indices[i]]], mesh.uvs[i]);
+    }
+}
+
+TEST(MeshIndexing, TangentsSplitVertices) {
+    const TestMesh mesh = make_grid_mesh(8);
+    const auto without_tangents = mesh_indexing::index_with_hash_table(mesh.get_streams(), false);
+    const auto with_tangents = mesh_indexing::index_with_hash_table(mesh.get_streams(), true);
+
+    EXPECT_GT(with_tangents.unique_vertices.size(), without_tangents.unique_vertices.size());
+    for (std::size_t i = 0; i < with_tangents.indices.size(); i++) {
+        EXPECT_EQ(mesh.tangents[with_tangents.unique_vertices[with_tangents.indices[i]]], mesh.tangents[i]);
+    }
+}
+
+TEST(MeshIndexing, ParallelSortMatchesHashTable) {
+    const TestMesh mesh = make_grid_mesh(37);
+    for (const bool compare_tangents : {false, true}) {
+        const auto expected = mesh_indexing::index_with_hash_table(mesh.get_streams(), compare_tangents);
+        for (const std::uint32_t threads_count : {1u, 3u, 8u}) {
+            const auto actual = mesh_indexing::index_with_parallel_sort(
+                mesh.get_streams(), compare_tangents, threads_count
+            );
+            EXPECT_EQ(actual.indices, expected.indices);
+            EXPECT_EQ(actual.unique_vertices, expected.unique_vertices);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "rendering/MeshResidency.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace llengine;
+
+TEST(MeshResidency, EditAndUploadReturnToRequested) {
+    MeshResidencyState state;
+    EXPECT_FALSE(state.request(MeshResidency::GPU_ONLY));
+    EXPECT_TRUE(state.release_to_requested());
+    EXPECT_EQ(state.get_current(), MeshResidency::GPU_ONLY);
+
+    // An edit reads the data back, it stays in RAM until the next upload.
+    state.mark_read_back();
+    EXPECT_EQ(state.get_current(), MeshResidency::CPU_AND_GPU);
+    EXPECT_EQ(state.get_requested(), MeshResidency::GPU_ONLY);
+
+    EXPECT_TRUE(state.release_to_requested());
+    EXPECT_EQ(state.get_current(), MeshResidency::GPU_ONLY);
+    EXPECT_EQ(state.get_requested(), MeshResidency::GPU_ONLY);
+}
+
+TEST(MeshResidency, ReadBackOnlyWhenMoreDataIsNeeded) {
+    MeshResidencyState state;
+    EXPECT_FALSE(state.request(MeshResidency::GPU_WITH_POSITIONS));
+    EXPECT_TRUE(state.release_to_requested());
+
+    EXPECT_FALSE(state.request(MeshResidency::GPU_ONLY));
+    EXPECT_TRUE(state.release_to_requested());
+    EXPECT_EQ(state.get_current(), MeshResidency::GPU_ONLY);
+
+    EXPECT_TRUE(state.request(MeshResidency::GPU_WITH_POSITIONS));
+    state.mark_read_back();
+    EXPECT_TRUE(state.release_to_requested());
+    EXPECT_EQ(state.get_current(), MeshResidency::GPU_WITH_POSITIONS);
+}
+
+TEST(MeshResidency, CPUAndGPUKeepsEverything) {
+    MeshResidencyState state;
+    EXPECT_FALSE(state.release_to_requested());
+    EXPECT_FALSE(state.is_released());
+
+    EXPECT_FALSE(state.request(MeshResidency::GPU_ONLY));
+    EXPECT_TRUE(state.release_to_requested());
+    EXPECT_TRUE(state.request(MeshResidency::CPU_AND_GPU));
+    state.mark_read_back();
+    EXPECT_FALSE(state.release_to_requested());
+    EXPECT_FALSE(state.is_released());
+}
@@ -0,0 +1,83 @@
+#include "utils/meshlet_generation.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+using namespace llengine;
+
+namespace {
+struct Grid {
+    std::vector<glm::vec3> positions;
+    std::vector<std::uint32_t> indices;
+};
+
+// Flat grid in the XY plane with triangles facing +Z.
+[[nodiscard]] Grid make_grid(std::uint32_t side) {
+    Grid grid;
+    for (std::uint32_t y = 0; y <= side; y++) {
+        for (std::uint32_t x = 0; x <= side; x++) {
+            grid.positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+        }
+    }
+    for (std::uint32_t y = 0; y < side; y++) {
+        for (std::uint32_t x = 0; x < side; x++) {
+            const std::uint32_t corner = y * (side + 1) + x;
+            grid.indices.insert(grid.indices.end(), {corner, corner + 1, corner + side + 2});
+            grid.indices.insert(grid.indices.end(), {corner, corner + side + 2, corner + side + 1});
+        }
+    }
+    return grid;
+}
+
+[[nodiscard]] std::vector<std::array<std::uint32_t, 3>> get_sorted_triangles(const std::vector<std::uint32_t>& indices) {
+    std::vector<std::array<std::uint32_t, 3>> result;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        result.push_back({indices[i], indices[i + 1], indices[i + 2]});
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+}
+
+TEST(MeshletGeneration, MeshletsCoverAllTrianglesWithinLimits) {
+    Grid grid = make_grid(40);
+    const auto original_triangles = get_sorted_triangles(grid.indices);
+
+    const auto meshlets = meshlet_generation::build_meshlets(grid.positions, grid.indices, 64, 48);
+
+    EXPECT_EQ(get_sorted_triangles(grid.indices), original_triangles);
+    std::uint32_t next_index = 0;
+    for (const Meshlet& meshlet : meshlets) {
+        EXPECT_EQ(meshlet.first_index, next_index);
+        EXPECT_LE(meshlet.indices_count, 64u * 3u);
+        next_index += meshlet.indices_count;
+
+        std::vector<std::uint32_t> vertices(
+            grid.indices.begin() + meshlet.first_index,
+            grid.indices.begin() + meshlet.first_index + meshlet.indices_count
+        );
+        std::sort(vertices.begin(), vertices.end());
+        EXPECT_LE(std::unique(vertices.begin(), vertices.end()) - vertices.begin(), 48);
+
+        for (const std::uint32_t vertex : vertices) {
+            EXPECT_LE(
+                glm::distance(grid.positions[vertex], meshlet.bounding_sphere_center),
+                meshlet.bounding_sphere_radius + 1e-5f
+            );
+        }
+    }
+    EXPECT_EQ(next_index, grid.indices.size());
+}
+
+TEST(MeshletGeneration, FlatMeshletsAreBackfacingFromBehind) {
+    Grid grid = make_grid(8);
+    const auto meshlets = meshlet_generation::build_meshlets(grid.positions, grid.indices);
+
+    for (const Meshlet& meshlet : meshlets) {
+        EXPECT_FALSE(meshlet.is_backfacing({4.0f, 4.0f, 10.0f}));
+        EXPECT_TRUE(meshlet.is_backfacing({4.0f, 4.0f, -10.0f}));
+    }
+}
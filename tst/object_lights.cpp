@@ -0,0 +1,31 @@
+#include "rendering/ObjectLights.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace llengine;
+
+TEST(ObjectLights, Select) {
+    const AABB box {{1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}};
+
+    std::vector<uniform_blocks::PointLightData> lights;
+    // Out of range.
+    lights.push_back({{5.0f, 0.0f, 0.0f}, 3.0f, {100.0f, 100.0f, 100.0f}, 0.0f});
+    // Dim lights 2 units away from the box.
+    for (int i = 0; i < 10; i++) {
+        lights.push_back({{0.0f, 3.0f, 0.0f}, 5.0f, {0.1f * static_cast<float>(i + 1), 0.0f, 0.0f}, 0.0f});
+    }
+    // Bright light near the box.
+    lights.push_back({{2.0f, 0.0f, 0.0f}, 3.0f, {0.0f, 0.0f, 100.0f}, 0.0f});
+
+    ObjectLights object_lights;
+    EXPECT_EQ(object_lights.select(box), ObjectLights::no_lights());
+
+    object_lights.set_lights(lights);
+    // The brightest first, the two dimmest ones don't fit.
+    EXPECT_EQ(object_lights.select(box), (ObjectLights::Indices {11, 10, 9, 8, 7, 6, 5, 4}));
+
+    object_lights.set_lights({lights.data(), 2});
+    EXPECT_EQ(object_lights.select(box), (ObjectLights::Indices {1, -1, -1, -1, -1, -1, -1, -1}));
+}
@@ -0,0 +1,196 @@
+#include "rendering/RenderQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace llengine;
+
+TEST(RenderQueue, KeyOrder) {
+    using Pass = RenderQueue::Pass;
+
+    // Fields from the most significant: program, material, vertex array, mesh, depth.
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 0, 9, 9, 9, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 1, 0, 0, 0, 0.0f));
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 1, 0, 9, 9, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 1, 1, 0, 0, 0.0f));
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 1, 1, 0, 9, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 1, 1, 1, 0, 0.0f));
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 1, 1, 1, 0, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 1, 1, 1, 1, 0.0f));
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 1, 1, 1, 1, 0.25f), RenderQueue::make_key(Pass::OPAQUE, 1, 1, 1, 1, 0.5f));
+
+    // Out of range values are clamped instead of spilling into other fields.
+    EXPECT_EQ(RenderQueue::make_key(Pass::OPAQUE, 0, 0, 0, 0, 7.0f), RenderQueue::make_key(Pass::OPAQUE, 0, 0, 0, 0, 1.0f));
+    EXPECT_EQ(RenderQueue::make_key(Pass::OPAQUE, 0, 0, 0, 0, -1.0f), 0u);
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 0, 0, 0, 1000000, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 0, 0, 1, 0, 0.0f));
+    EXPECT_LT(RenderQueue::make_key(Pass::OPAQUE, 0, 0, 1000000, 0, 1.0f), RenderQueue::make_key(Pass::OPAQUE, 0, 1, 0, 0, 0.0f));
+}
+
+TEST(RenderQueue, RadixSortIsStable) {
+    std::mt19937_64 engine {7};
+    std::vector<RenderQueue::Item> items;
+    for (std::uint32_t i = 0; i < 5000; i++) {
+        // Few distinct high bytes, like keys of a real frame.
+        const std::uint64_t key = ((engine() % 4) << 56) | ((engine() % 16) << 32) | (engine() & 0xFFu);
+        items.push_back({key, i});
+    }
+
+    std::vector<RenderQueue::Item> expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [] (const auto& left, const auto& right) {
+        return left.key < right.key;
+    });
+
+    std::vector<RenderQueue::Item> scratch;
+    RenderQueue::radix_sort(items, scratch);
+
+    ASSERT_EQ(items.size(), expected.size());
+    for (std::size_t i = 0; i < items.size(); i++) {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].entry, expected[i].entry);
+    }
+}
+
+namespace {
+class RecordingDrawable : public Drawable {
+public:
+    RecordingDrawable(std::vector<std::size_t>& batch_sizes, const RenderKeyParts& parts) :
+        batch_sizes(batch_sizes), parts(parts) {}
+
+    void draw() override {}
+    void draw_queued(const RenderStateChanges&) override {
+        batch_sizes.push_back(1);
+    }
+    void draw_queued_instances(const RenderStateChanges&, std::span<Drawable* const> instances) override {
+        batch_sizes.push_back(instances.size());
+    }
+    void draw_queued_multi(const RenderStateChanges&, std::span<Drawable* const> drawables) override {
+        batch_sizes.push_back(drawables.size());
+    }
+    bool draw_to_depth_prepass(std::span<Drawable* const> instances) override {
+        batch_sizes.push_back(instances.size());
+        prepass_depths.push_back(parts.depth);
+        return true;
+    }
+    [[nodiscard]] bool is_enabled() const override { return true; }
+    [[nodiscard]] ShaderID get_program_id() const override { return parts.program_id; }
+    [[nodiscard]] RenderKeyParts get_render_key_parts(const glm::vec3&) const override { return parts; }
+
+    std::vector<float> prepass_depths;
+
+private:
+    std::vector<std::size_t>& batch_sizes;
+    RenderKeyParts parts;
+};
+}
+
+TEST(RenderQueue, SubmitBatchesEqualMeshes) {
+    const int material = 0;
+    const int mesh_1 = 0;
+    const int mesh_2 = 0;
+
+    std::vector<std::size_t> batch_sizes;
+    std::vector<RecordingDrawable> drawables;
+    for (int i = 0; i < 6; i++) {
+        drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, i % 2 == 0 ? &mesh_1 : &mesh_2, i * 1.0f});
+    }
+    // Without a mesh, drawables are never batched.
+    drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, nullptr, 0.0f});
+    drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, nullptr, 0.0f});
+
+    RenderQueue queue;
+    for (RecordingDrawable& drawable : drawables) {
+        queue.push(drawable, drawable.get_render_key_parts({}), RenderQueue::Pass::OPAQUE, 10.0f);
+    }
+    const RenderStatistics statistics = queue.submit(true);
+
+    std::sort(batch_sizes.begin(), batch_sizes.end());
+    EXPECT_EQ(batch_sizes, (std::vector<std::size_t> {1, 1, 3, 3}));
+    EXPECT_EQ(statistics.draws_count, 4u);
+    EXPECT_EQ(statistics.objects_count, 8u);
+    EXPECT_EQ(statistics.program_changes, 1u);
+    EXPECT_EQ(statistics.material_changes, 1u);
+
+    batch_sizes.clear();
+    queue.clear();
+    for (RecordingDrawable& drawable : drawables) {
+        queue.push(drawable, drawable.get_render_key_parts({}), RenderQueue::Pass::OPAQUE, 10.0f);
+    }
+    EXPECT_EQ(queue.submit(false).draws_count, 8u);
+    EXPECT_EQ(batch_sizes, std::vector<std::size_t>(8, 1));
+}
+
+TEST(RenderQueue, SubmitMultiDrawsEqualVertexArrays) {
+    const int material = 0;
+    const int mesh_1 = 0;
+    const int mesh_2 = 0;
+    const int mesh_3 = 0;
+
+    std::vector<std::size_t> batch_sizes;
+    std::vector<RecordingDrawable> drawables;
+    for (int i = 0; i < 6; i++) {
+        drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, i % 2 == 0 ? &mesh_1 : &mesh_2, i * 1.0f});
+    }
+    // Meshes in other vertex arrays can't be drawn together.
+    drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 2, &mesh_3, 0.0f});
+
+    RenderQueue queue;
+    for (RecordingDrawable& drawable : drawables) {
+        queue.push(drawable, drawable.get_render_key_parts({}), RenderQueue::Pass::OPAQUE, 10.0f);
+    }
+    const RenderStatistics statistics = queue.submit(true, true);
+
+    std::sort(batch_sizes.begin(), batch_sizes.end());
+    EXPECT_EQ(batch_sizes, (std::vector<std::size_t> {1, 6}));
+    EXPECT_EQ(statistics.draws_count, 2u);
+    EXPECT_EQ(statistics.objects_count, 7u);
+}
+
+TEST(RenderQueue, SubmitDepthPrepassFrontToBack) {
+    const int material = 0;
+    const int mesh_1 = 0;
+    const int mesh_2 = 0;
+
+    std::vector<std::size_t> batch_sizes;
+    std::vector<RecordingDrawable> drawables;
+    // Drawables of mesh_1 are separated by the one of mesh_2 in between, except the farthest two.
+    for (const float depth : {5.0f, 1.0f, 5.0f, 3.0f}) {
+        drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, depth == 3.0f ? &mesh_2 : &mesh_1, depth});
+    }
+
+    RenderQueue queue;
+    for (RecordingDrawable& drawable : drawables) {
+        queue.push(drawable, drawable.get_render_key_parts({}), RenderQueue::Pass::OPAQUE, 10.0f);
+    }
+    EXPECT_EQ(queue.submit_depth_prepass(), 3u);
+    EXPECT_EQ(batch_sizes, (std::vector<std::size_t> {1, 1, 2}));
+
+    std::vector<float> depths;
+    for (const RecordingDrawable& drawable : drawables) {
+        depths.insert(depths.end(), drawable.prepass_depths.begin(), drawable.prepass_depths.end());
+    }
+    std::sort(depths.begin(), depths.end());
+    EXPECT_EQ(depths, (std::vector<float> {1.0f, 3.0f, 5.0f}));
+}
+
+TEST(RenderQueue, SubmitDepthPrepassInstancesSimilarDepths) {
+    const int material = 0;
+    const int mesh_1 = 0;
+    const int mesh_2 = 0;
+
+    std::vector<std::size_t> batch_sizes;
+    std::vector<RecordingDrawable> drawables;
+    // Depths are in one bucket, so the drawable of mesh_2 doesn't separate the others.
+    for (const float depth : {5.0f, 5.05f, 5.1f}) {
+        drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, depth == 5.05f ? &mesh_2 : &mesh_1, depth});
+    }
+    // Far enough to be in another bucket.
+    drawables.emplace_back(batch_sizes, RenderKeyParts {1, &material, 1, &mesh_1, 9.0f});
+
+    RenderQueue queue;
+    for (RecordingDrawable& drawable : drawables) {
+        queue.push(drawable, drawable.get_render_key_parts({}), RenderQueue::Pass::OPAQUE, 10.0f);
+    }
+    EXPECT_EQ(queue.submit_depth_prepass(), 3u);
+    EXPECT_EQ(batch_sizes.size(), 3u);
+    EXPECT_EQ(std::count(batch_sizes.begin(), batch_sizes.end(), 2u), 1);
+    EXPECT_EQ(batch_sizes.back(), 1u);
+}
@@ -0,0 +1,90 @@
+#include "math/SphericalHarmonics.hpp"
+#include "testing_tools.hpp"
+
+#include <gtest/gtest.h>
+#include <glm/geometric.hpp>
+
+#include <vector>
+#include <functional>
+
+// Direction of the texel center as described in the OpenGL specification (table 8.19).
+static glm::vec3 cubemap_texel_direction(std::size_t face, std::uint32_t column, std::uint32_t row, std::uint32_t size) {
+    const float sc = (2.0f * column + 1.0f) / size - 1.0f;
+    const float tc = (2.0f * row + 1.0f) / size - 1.0f;
+
+    switch (face) {
+    case 0: return glm::normalize(glm::vec3(1.0f, -tc, -sc));
+    case 1: return glm::normalize(glm::vec3(-1.0f, -tc, sc));
+    case 2: return glm::normalize(glm::vec3(sc, 1.0f, tc));
+    case 3: return glm::normalize(glm::vec3(sc, -1.0f, -tc));
+    case 4: return glm::normalize(glm::vec3(sc, -tc, 1.0f));
+    default: return glm::normalize(glm::vec3(-sc, -tc, -1.0f));
+    }
+}
+
+static std::array<std::vector<float>, 6> make_cubemap(
+    std::uint32_t size, const std::function<glm::vec3(const glm::vec3&)>& radiance
+) {
+    std::array<std::vector<float>, 6> faces;
+    for (std::size_t face = 0; face < 6; face++) {
+        faces[face].reserve(size * size * 3);
+        for (std::uint32_t row = 0; row < size; row++) {
+            for (std::uint32_t column = 0; column < size; column++) {
+                const glm::vec3 value = radiance(cubemap_texel_direction(face, column, row, size));
+                faces[face].insert(faces[face].end(), {value.x, value.y, value.z});
+            }
+        }
+    }
+
+    return faces;
+}
+
+static std::array<std::span<const float>, 6> to_spans(const std::array<std::vector<float>, 6>& faces) {
+    return {faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]};
+}
+
+TEST(SphericalHarmonics, ConstantRadiance) {
+    const auto faces = make_cubemap(32, [] (const glm::vec3&) { return glm::vec3(0.5f, 1.0f, 2.0f); });
+    const auto irradiance = llengine::SphericalHarmonics::from_cubemap(to_spans(faces), 32).radiance_to_irradiance();
+
+    // Diffuse irradiance of the uniform environment is equal to its radiance.
+    expect_near_vec3(irradiance.evaluate({0.0f, 1.0f, 0.0f}), {0.5f, 1.0f, 2.0f}, 0.001f);
+    expect_near_vec3(irradiance.evaluate({0.0f, 0.0f, -1.0f}), {0.5f, 1.0f, 2.0f}, 0.001f);
+    expect_near_vec3(irradiance.evaluate(glm::normalize(glm::vec3(1.0f, -1.0f, 1.0f))), {0.5f, 1.0f, 2.0f}, 0.001f);
+}
+
+TEST(SphericalHarmonics, LinearRadiance) {
+    // Irradiance from radiance 1 + y, divided by PI, is 1 + 2/3 * y.
+    const auto faces = make_cubemap(32, [] (const glm::vec3& dir) { return glm::vec3(1.0f + dir.y); });
+    const auto irradiance = llengine::SphericalHarmonics::from_cubemap(to_spans(faces), 32).radiance_to_irradiance();
+
+    expect_near_vec3(irradiance.evaluate({0.0f, 1.0f, 0.0f}), glm::vec3(5.0f / 3.0f), 0.005f);
+    expect_near_vec3(irradiance.evaluate({0.0f, -1.0f, 0.0f}), glm::vec3(1.0f / 3.0f), 0.005f);
+    expect_near_vec3(irradiance.evaluate({1.0f, 0.0f, 0.0f}), glm::vec3(1.0f), 0.005f);
+    expect_near_vec3(irradiance.evaluate({0.0f, 0.0f, 1.0f}), glm::vec3(1.0f), 0.005f);
+}
+
+TEST(SphericalHarmonics, ProjectionOfBasisFunction) {
+    // Radiance equal to the basis function 8 must give a single non-zero coefficient.
+    const auto faces = make_cubemap(64, [] (const glm::vec3& dir) {
+        return glm::vec3(0.546274f * (dir.x * dir.x - dir.y * dir.y));
+    });
+    const auto radiance = llengine::SphericalHarmonics::from_cubemap(to_spans(faces), 64);
+
+    for (std::size_t i = 0; i < llengine::SphericalHarmonics::COEFFICIENTS_COUNT; i++) {
+        const float expected = i == 8 ? 1.0f : 0.0f;
+        expect_near_vec3(radiance.coefficients[i], glm::vec3(expected), 0.005f);
+    }
+}
+
+TEST(SphericalHarmonics, ThreadsCountDoesNotAffectResult) {
+    const auto faces = make_cubemap(17, [] (const glm::vec3& dir) {
+        return glm::vec3(std::max(dir.x, 0.0f), dir.z * dir.z, 1.0f + dir.y * dir.x);
+    });
+    const auto single_threaded = llengine::SphericalHarmonics::from_cubemap(to_spans(faces), 17, 1);
+    const auto multi_threaded = llengine::SphericalHarmonics::from_cubemap(to_spans(faces), 17, 5);
+
+    for (std::size_t i = 0; i < llengine::SphericalHarmonics::COEFFICIENTS_COUNT; i++) {
+        expect_near_vec3(single_threaded.coefficients[i], multi_threaded.coefficients[i], 0.0001f);
+    }
+}
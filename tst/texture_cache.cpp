@@ -0,0 +1,83 @@
+#include "rendering/TextureCache.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace llengine;
+
+namespace {
+struct CountingLoader {
+    std::size_t calls = 0;
+
+    [[nodiscard]] std::function<Texture(const TexLoadingParams&)> get() {
+        return [this] (const TexLoadingParams&) {
+            calls++;
+            // Empty textures don't need a graphics API context.
+            return Texture();
+        };
+    }
+};
+
+[[nodiscard]] TexLoadingParams make_params() {
+    TexLoadingParams params;
+    params.file_path = "scene.glb";
+    params.offset = 1024;
+    params.size = 4096;
+    return params;
+}
+}
+
+TEST(TextureCache, HitOnSameParams) {
+    TextureCache cache;
+    CountingLoader loader;
+
+    const auto texture_1 = cache.get_or_load(make_params(), loader.get());
+    const auto texture_2 = cache.get_or_load(make_params(), loader.get());
+
+    EXPECT_EQ(texture_1, texture_2);
+    EXPECT_EQ(loader.calls, 1u);
+    EXPECT_EQ(cache.get_statistics().hits, 1u);
+    EXPECT_EQ(cache.get_statistics().misses, 1u);
+    EXPECT_EQ(cache.get_statistics().resident_textures, 1u);
+}
+
+TEST(TextureCache, MissOnDifferentParams) {
+    TextureCache cache;
+    CountingLoader loader;
+
+    const auto original = cache.get_or_load(make_params(), loader.get());
+
+    TexLoadingParams other_filter = make_params();
+    other_filter.minification_filter = other_filter.minification_filter + 1;
+    TexLoadingParams other_offset = make_params();
+    other_offset.offset = 0;
+    TexLoadingParams other_mime_type = make_params();
+    other_mime_type.mime_type = "image/ktx2";
+
+    for (const TexLoadingParams& params : {other_filter, other_offset, other_mime_type}) {
+        EXPECT_NE(cache.get_or_load(params, loader.get()), original);
+    }
+    EXPECT_EQ(loader.calls, 4u);
+    EXPECT_EQ(cache.get_statistics().hits, 0u);
+    EXPECT_EQ(cache.get_statistics().misses, 4u);
+}
+
+TEST(TextureCache, ReleaseWithLastReference) {
+    TextureCache cache;
+    CountingLoader loader;
+
+    auto texture_1 = cache.get_or_load(make_params(), loader.get());
+    auto texture_2 = cache.get_or_load(make_params(), loader.get());
+    std::weak_ptr<Texture> weak_texture = texture_1;
+
+    texture_1.reset();
+    EXPECT_FALSE(weak_texture.expired());
+    EXPECT_EQ(cache.get_statistics().resident_textures, 1u);
+
+    texture_2.reset();
+    EXPECT_TRUE(weak_texture.expired());
+    EXPECT_EQ(cache.get_statistics().resident_textures, 0u);
+
+    // A released texture is loaded again.
+    const auto texture_3 = cache.get_or_load(make_params(), loader.get());
+    EXPECT_EQ(loader.calls, 2u);
+}
@@ -0,0 +1,58 @@
+#include "utils/vertex_packing.hpp"
+#include "testing_tools.hpp"
+
+#include <gtest/gtest.h>
+#include <glm/geometric.hpp>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace llengine;
+
+TEST(VertexPacking, NormalsRoundTrip) {
+    std::vector<glm::vec3> normals {
+        {1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}
+    };
+    for (std::size_t i = 0; i < 100; i++) {
+        const float phi = i * 0.7f;
+        const float theta = i * 0.031f;
+        normals.emplace_back(std::cos(phi) * std::sin(theta), std::sin(phi) * std::sin(theta), std::cos(theta));
+    }
+
+    std::vector<std::uint32_t> packed(normals.size());
+    vertex_packing::pack_normals(normals, packed);
+
+    for (std::size_t i = 0; i < normals.size(); i++) {
+        expect_near_vec3(vertex_packing::unpack_normal(packed[i]), normals[i], 1e-4f);
+    }
+}
+
+TEST(VertexPacking, TangentsKeepHandedness) {
+    const std::array<glm::vec4, 2> tangents {
+        glm::vec4(0.6f, 0.0f, -0.8f, 1.0f), glm::vec4(0.0f, 1.0f, 0.0f, -1.0f)
+    };
+    std::array<std::uint32_t, 2> packed;
+    vertex_packing::pack_tangents(tangents, packed);
+
+    for (std::size_t i = 0; i < tangents.size(); i++) {
+        const glm::vec4 unpacked = vertex_packing::unpack_tangent(packed[i]);
+        expect_near_vec3(glm::vec3(unpacked), glm::vec3(tangents[i]), 2e-3f);
+        EXPECT_EQ(unpacked.w, tangents[i].w);
+    }
+}
+
+TEST(VertexPacking, UVsRoundTrip) {
+    const std::array<glm::vec2, 3> uvs {
+        glm::vec2(0.0f, 1.0f), glm::vec2(0.25f, -3.5f), glm::vec2(0.3f, 12.7f)
+    };
+    std::array<std::uint32_t, 3> packed;
+    vertex_packing::pack_uvs(uvs, packed);
+
+    for (std::size_t i = 0; i < uvs.size(); i++) {
+        const glm::vec2 unpacked = vertex_packing::unpack_uv(packed[i]);
+        // Half floats have 11 significant bits.
+        EXPECT_NEAR(unpacked.x, uvs[i].x, std::abs(uvs[i].x) / 2048.0f);
+        EXPECT_NEAR(unpacked.y, uvs[i].y, std::abs(uvs[i].y) / 2048.0f);
+    }
+}